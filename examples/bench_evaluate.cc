@@ -0,0 +1,76 @@
+#include "../tests/test_util.h"
+
+#include <chrono>
+
+/*
+ * Benchmark of repeated evaluations of a fixed Func: Func::evaluate, the bit-sliced
+ * batch evaluation, and CompiledFunc, on the same random assignments.
+ *
+ * usage: ./bench_evaluate [forest type] [num_vars] [num_evaluations]
+ */
+
+/* Seconds since the given time */
+double since(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    int bdd = (argc > 1) ? atoi(argv[1]) : 0;
+    uint16_t numVars = (argc > 2) ? atoi(argv[2]) : 18;
+    long numEvals = (argc > 3) ? atol(argv[3]) : 1000000;
+
+    ForestSetting setting((PredefForest)bdd, numVars);
+    Forest* forest = new Forest(setting);
+    /* A random function, mostly 0, so some edges skip levels */
+    long size = 1L << numVars;
+    std::vector<bool> fun(size);
+    for (long i=0; i<size; i++) fun[i] = (random01() > 0.9f);
+    Func func(forest, buildEdge(forest, numVars, fun, 0, size-1));
+    std::cout << "Forest " << setting.getName() << ", " << numVars << " variables, "
+              << forest->countNodes() << " nodes, " << numEvals << " evaluations" << std::endl;
+
+    std::vector<std::vector<bool> > assignments(numEvals, std::vector<bool>(numVars+1, 0));
+    for (long a=0; a<numEvals; a++) {
+        for (uint16_t v=1; v<=numVars; v++) assignments[a][v] = (random01() > 0.5f);
+    }
+
+    /* One assignment at a time */
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<bool> single(numEvals);
+    for (long a=0; a<numEvals; a++) {
+        int valInt;
+        func.evaluate(assignments[a]).getValueTo(&valInt, INT);
+        single[a] = valInt;
+    }
+    double singleTime = since(start);
+
+    /* 64 assignments per traversal */
+    start = std::chrono::steady_clock::now();
+    std::vector<bool> batch;
+    func.evaluate(assignments, batch);
+    double batchTime = since(start);
+
+    /* Compiled program */
+    start = std::chrono::steady_clock::now();
+    CompiledFunc compiled(func);
+    double compileTime = since(start);
+    start = std::chrono::steady_clock::now();
+    std::vector<bool> program(numEvals);
+    for (long a=0; a<numEvals; a++) {
+        int valInt;
+        compiled.evaluate(assignments[a]).getValueTo(&valInt, INT);
+        program[a] = valInt;
+    }
+    double compiledTime = since(start);
+
+    bool same = (single == batch) && (single == program);
+    std::cout << "Func::evaluate:    \t" << singleTime << " s" << std::endl;
+    std::cout << "Batch evaluate:    \t" << batchTime << " s" << std::endl;
+    std::cout << "CompiledFunc:      \t" << compiledTime << " s (compiled " << compiled.getNumSteps()
+              << " steps in " << compileTime << " s)" << std::endl;
+    std::cout << (same ? "Results agree" : "Results DIFFER!") << std::endl;
+    delete forest;
+    return same ? 0 : 1;
+}
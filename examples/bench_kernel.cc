@@ -0,0 +1,76 @@
+#include "../tests/test_util.h"
+
+#include <chrono>
+
+/*
+ * Benchmark of the kernels: for each predefined BDD forest, the same random functions are
+ * built, then AND-ed and OR-ed pairwise, once with the reduction and the apply specialized
+ * for the forest (PredefKernel) and once reading its setting (SettingKernel).
+ *
+ * usage: ./bench_kernel [num_vars] [num_funcs] [num_runs]
+ */
+
+/* Seconds since the given time */
+double since(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/* Build and operation times of the functions "funs" in a new forest, the least of "runs" runs */
+void runForest(PredefForest bdd, uint16_t numVars, std::vector<std::vector<bool> >& funs,
+                int runs, bool isPredef, double& buildTime, double& applyTime, long& numNodes)
+{
+    long size = 1L << numVars;
+    buildTime = applyTime = 0;
+    for (int run=0; run<runs; run++) {
+        Forest* forest = new Forest(ForestSetting(bdd, numVars));
+        if (!isPredef) forest->useSettingKernel();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::vector<Func> funcs;
+        for (size_t f=0; f<funs.size(); f++) {
+            funcs.push_back(Func(forest, buildEdge(forest, numVars, funs[f], 0, size-1)));
+        }
+        double build = since(start);
+        start = std::chrono::steady_clock::now();
+        Func res(forest);
+        for (size_t f=0; f+1<funcs.size(); f++) {
+            res = funcs[f] & funcs[f+1];
+            res = funcs[f] | funcs[f+1];
+        }
+        double apply = since(start);
+        if ((run == 0) || (build < buildTime)) buildTime = build;
+        if ((run == 0) || (apply < applyTime)) applyTime = apply;
+        numNodes = forest->countNodes();
+        funcs.clear();
+        delete forest;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint16_t numVars = (argc > 1) ? atoi(argv[1]) : 15;
+    int numFuncs = (argc > 2) ? atoi(argv[2]) : 40;
+    int runs = (argc > 3) ? atoi(argv[3]) : 5;
+
+    long size = 1L << numVars;
+    std::vector<std::vector<bool> > funs(numFuncs, std::vector<bool>(size));
+    for (int f=0; f<numFuncs; f++) {
+        for (long i=0; i<size; i++) funs[f][i] = (random01() > 0.5f);
+    }
+    std::cout << numFuncs << " functions of " << numVars << " variables, least time of "
+              << runs << " runs, build / AND-OR in seconds" << std::endl;
+
+    bool same = 1;
+    for (int bdd=0; bdd<5; bdd++) {
+        double buildTime[2], applyTime[2];
+        long numNodes[2];
+        runForest((PredefForest)bdd, numVars, funs, runs, 0, buildTime[0], applyTime[0], numNodes[0]);
+        runForest((PredefForest)bdd, numVars, funs, runs, 1, buildTime[1], applyTime[1], numNodes[1]);
+        same = same && (numNodes[0] == numNodes[1]);
+        std::cout << ForestSetting((PredefForest)bdd, numVars).getName() << ":\tSettingKernel "
+                  << buildTime[0] << " / " << applyTime[0] << "\tPredefKernel "
+                  << buildTime[1] << " / " << applyTime[1]
+                  << ((numNodes[0] == numNodes[1]) ? "" : "\tnode counts DIFFER!") << std::endl;
+    }
+    return same ? 0 : 1;
+}
@@ -58,7 +58,7 @@ void DotMaker::buildGraph(const Func& func)
     outfile << "\tv0 [label=\"\"]\n";
     for (uint32_t i = 1; i <= numVars; i++)
     {
-        outfile << "\tv" << i << " [label=\"x" << i << "\"]\n";
+        outfile << "\tv" << i << " [label=\"x" << parent->getSetting().getVar(i) << "\"]\n";
         outfile << "\tv" << i << " -> v" << i-1 << " [style=invis]\n";
     }
 #ifdef REXBDD_DOT_TRACE
@@ -144,9 +144,10 @@ void DotMaker::buildEdge(const uint16_t lvl, const Edge& edge, const NodeHandle
             <<" [label = \"N"<<edge.getNodeLevel()<<"_"<<edge.getNodeHandle()<<"\", shape = circle]}\n";
             // build child edges of target node if it's marked
             if (parent->getNode(edge.getNodeLevel(), edge.getNodeHandle()).isMarked()) {
+                NodeView view = parent->getNodeView(edge.getNodeLevel(), edge.getNodeHandle());
                 for (char i=0; i<numChild; i++) {
                     buildEdge(edge.getNodeLevel(),
-                                parent->getChildEdge(edge.getNodeLevel(), edge.getNodeHandle(), i),
+                                view[i],
                                 edge.getNodeHandle(),
                                 (i==0 || i==2));
                 }
@@ -0,0 +1,322 @@
+#include "snapshot.h"
+#include "../forest.h"
+
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace REXBDD;
+
+// Header of the snapshot files: "RXBS", and the format version
+static const uint32_t SNAPSHOT_MAGIC = 0x52584253;
+static const uint16_t SNAPSHOT_VERSION = 1;
+
+/// Round up to a multiple of 8 bytes
+static inline uint64_t align8(const uint64_t bytes)
+{
+    return (bytes + 7) & ~(uint64_t)7;
+}
+// ******************************************************************
+// *                                                                *
+// *                       Snapshot methods                         *
+// *                                                                *
+// ******************************************************************
+
+Snapshot::Layout::Layout(uint16_t numVars, uint8_t numChild, uint64_t numNodes, uint64_t numFuncs)
+{
+    var = sizeof(Header);
+    levelStart = var + align8((numVars + 1) * sizeof(uint16_t));
+    nodes = levelStart + (numVars + 2) * sizeof(uint64_t);
+    funcs = nodes + numNodes * numChild * sizeof(EdgeHandle);
+    names = funcs + numFuncs * sizeof(FuncEntry);
+}
+
+Snapshot::Snapshot(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cout << "[REXBDD] ERROR!\t Snapshot: could not open the file: " << path << std::endl;
+        exit(0);
+    }
+    struct stat info;
+    if ((fstat(fd, &info) != 0) || ((uint64_t)info.st_size < sizeof(Header))) {
+        std::cout << "[REXBDD] ERROR!\t Snapshot: not a snapshot file: " << path << std::endl;
+        exit(0);
+    }
+    size = info.st_size;
+    void* mapped = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cout << "[REXBDD] ERROR!\t Snapshot: could not map the file: " << path << std::endl;
+        exit(0);
+    }
+    base = (const char*)mapped;
+    header = (const Header*)base;
+    /* Only the header is checked; the nodes are trusted */
+    if ((header->magic != SNAPSHOT_MAGIC) || (header->version != SNAPSHOT_VERSION)) {
+        std::cout << "[REXBDD] ERROR!\t Snapshot: not a snapshot file of version " << SNAPSHOT_VERSION
+                  << ", or of another byte order: " << path << std::endl;
+        exit(0);
+    }
+    Layout layout(header->numVars, header->numChild, header->numNodes, header->numFuncs);
+    if ((header->fileSize != size) || (header->numChild != 2) || (layout.names > size)) {
+        std::cout << "[REXBDD] ERROR!\t Snapshot: the file is truncated or corrupted: " << path << std::endl;
+        exit(0);
+    }
+    var = (const uint16_t*)(base + layout.var);
+    levelStart = (const uint64_t*)(base + layout.levelStart);
+    nodes = (const EdgeHandle*)(base + layout.nodes);
+    funcs = (const FuncEntry*)(base + layout.funcs);
+}
+Snapshot::~Snapshot()
+{
+    munmap((void*)base, size);
+}
+
+void Snapshot::write(const std::string& path, const Forest* forest, const FuncArray& funcArray)
+{
+    const ForestSetting& setting = forest->getSetting();
+    if (setting.isRelation() || (setting.getEncodeMechanism() != TERMINAL)) {
+        std::cout << "[REXBDD] ERROR!\t Snapshot::write(): only set forests with the terminal encoding are supported!" << std::endl;
+        exit(0);
+    }
+    if ((funcArray.size() > 0) && !funcArray.isAttachedTo(forest)) {
+        std::cout << "[REXBDD] ERROR!\t Snapshot::write(): the Funcs are in another forest!" << std::endl;
+        exit(0);
+    }
+    uint16_t numVars = setting.getNumVars();
+    const uint8_t numChild = 2;
+    /* The reachable nodes, sorted by handle within each level */
+    std::vector<Edge> roots;
+    for (int i=0; i<funcArray.size(); i++) roots.push_back(funcArray[i].getEdge());
+    std::vector<std::vector<NodeHandle> > levels;
+    forest->unmark();
+    uint64_t numNodes = forest->markNodes(roots, 0, &levels);
+    forest->unmark();
+    /* Header */
+    Header head;
+    memset((void*)&head, 0, sizeof(Header));
+    head.magic = SNAPSHOT_MAGIC;
+    head.version = SNAPSHOT_VERSION;
+    head.numVars = numVars;
+    head.valType = setting.getValType();
+    head.swapType = setting.getSwapType();
+    head.compType = setting.getCompType();
+    head.numChild = numChild;
+    head.maxRange = setting.getMaxRange();
+    head.numNodes = numNodes;
+    head.numFuncs = funcArray.size();
+    Layout layout(numVars, numChild, numNodes, head.numFuncs);
+    uint64_t namesSize = 0;
+    for (int i=0; i<funcArray.size(); i++) namesSize += funcArray[i].getName().size();
+    head.fileSize = layout.names + namesSize;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cout << "[REXBDD] ERROR!\t Snapshot::write(): could not open or create the file: " << path << std::endl;
+        exit(0);
+    }
+    out.write((const char*)&head, sizeof(Header));
+    /* Variable order, padded */
+    std::vector<uint16_t> order(numVars+1, 0);
+    for (uint16_t lvl=1; lvl<=numVars; lvl++) order[lvl] = setting.getVar(lvl);
+    out.write((const char*)order.data(), order.size() * sizeof(uint16_t));
+    uint64_t zero = 0;
+    out.write((const char*)&zero, layout.levelStart - layout.var - order.size() * sizeof(uint16_t));
+    /* First node of each level */
+    std::vector<uint64_t> start(numVars+2, 0);
+    for (uint16_t lvl=1; lvl<=numVars; lvl++) start[lvl+1] = start[lvl] + levels[lvl].size();
+    out.write((const char*)start.data(), start.size() * sizeof(uint64_t));
+    /* Nodes, from the bottom up */
+    for (uint16_t lvl=1; lvl<=numVars; lvl++) {
+        for (size_t i=0; i<levels[lvl].size(); i++) {
+            NodeView view = forest->getNodeView(lvl, levels[lvl][i]);
+            for (char c=0; c<numChild; c++) {
+                EdgeHandle child = Forest::remapHandle(view[c].getEdgeHandle(), levels);
+                out.write((const char*)&child, sizeof(EdgeHandle));
+            }
+        }
+    }
+    /* Funcs, then their names */
+    uint64_t nameOffset = layout.names;
+    for (int i=0; i<funcArray.size(); i++) {
+        FuncEntry entry;
+        entry.root = Forest::remapHandle(funcArray[i].getEdge().getEdgeHandle(), levels);
+        entry.nameOffset = nameOffset;
+        entry.nameLength = funcArray[i].getName().size();
+        nameOffset += entry.nameLength;
+        out.write((const char*)&entry, sizeof(FuncEntry));
+    }
+    for (int i=0; i<funcArray.size(); i++) {
+        std::string name = funcArray[i].getName();
+        out.write(name.data(), name.size());
+    }
+    if (!out) {
+        std::cout << "[REXBDD] ERROR!\t Snapshot::write(): write failed: " << path << std::endl;
+        exit(0);
+    }
+}
+
+int Snapshot::findFunc(const std::string& name) const
+{
+    for (int i=0; i<getNumFuncs(); i++) {
+        if ((funcs[i].nameLength == name.size())
+            && (name.compare(0, name.size(), base + funcs[i].nameOffset, funcs[i].nameLength) == 0)) return i;
+    }
+    return -1;
+}
+
+Edge Snapshot::cofact(const uint16_t lvl, const Edge& edge, const char index) const
+{
+    if (lvl == 0) return edge;
+    uint16_t m = edge.getNodeLevel();
+    if (lvl == m) {
+        // get swap/comp bit only when it's allowed, as Func::evaluate does
+        bool isSwap = ((header->swapType == ONE) || (header->swapType == ALL)) && edge.getSwap(0);
+        Edge ans;
+        ans.setEdgeHandle(slot(m, edge.getNodeHandle())[index ^ isSwap]);
+        if ((header->compType == COMP) && edge.getComp()) ans.complement();
+        if (isSwap && (header->swapType == ALL)) ans.swap();
+        return ans;
+    }
+    /* The edge skips this level: the rule decides */
+    ReductionRule rule = edge.getRule();
+    bool isLast = (lvl - m == 1);
+    if ((isRuleEL(rule) && (index == 0)) || (isRuleEH(rule) && (index == 1))
+        || (isRuleAL(rule) && isLast && (index == 0))
+        || (isRuleAH(rule) && isLast && (index == 1))) {
+        Edge ans;
+        if ((header->valType == FLOAT) || (header->valType == DOUBLE)) {
+            ans.setEdgeHandle(makeTerminal(FLOAT, (float)hasRuleTerminalOne(rule)));
+        } else {
+            ans.setEdgeHandle(makeTerminal(INT, (int)hasRuleTerminalOne(rule)));
+        }
+        ans.setRule(RULE_X);
+        return ans;
+    }
+    /* Otherwise, the same target; the rule is dropped once it can no longer apply */
+    Edge ans = edge;
+    if (isLast || (isRuleAL(rule) && (index == 1)) || (isRuleAH(rule) && (index == 0))) ans.setRule(RULE_X);
+    return ans;
+}
+
+Value Snapshot::evaluate(int i, const std::vector<bool>& assignment) const
+{
+    uint16_t numVars = getNumVars();
+    if (assignment.size() != (size_t)numVars + 1) {
+        std::cout << "[REXBDD] ERROR!\t Snapshot::evaluate(): Variable number check failed in evaluation! It was "
+                  << assignment.size()-1 << ", it should be " << numVars << std::endl;
+        exit(0);
+    }
+    Edge current = getRoot(i);
+    for (uint16_t k=numVars; k>0; k--) {
+        current = cofact(k, current, assignment[var[k]]);
+    }
+    Value ans = getTerminalValue(current.getEdgeHandle());
+    if (current.getComp() && (header->compType != NO_COMP)) {
+        NodeHandle target = current.getNodeHandle();
+        if (ans.getType() == INT) {
+            int terminalVal = *reinterpret_cast<int*>(&target);
+            ans.setValue((int)(header->maxRange - terminalVal), INT);
+        } else if (ans.getType() == FLOAT) {
+            float terminalVal = *reinterpret_cast<float*>(&target);
+            ans.setValue((float)(header->maxRange - terminalVal), FLOAT);
+        }
+    }
+    return ans;
+}
+
+uint64_t Snapshot::countNodes(int i) const
+{
+    std::vector<bool> visited(getNumNodes(), 0);
+    return markNodes(funcs[i].root, visited);
+}
+
+uint64_t Snapshot::countNodes() const
+{
+    std::vector<bool> visited(getNumNodes(), 0);
+    uint64_t num = 0;
+    for (int i=0; i<getNumFuncs(); i++) num += markNodes(funcs[i].root, visited);
+    return num;
+}
+
+uint64_t Snapshot::count(int i, int val) const
+{
+    /* counts[2n+c]: for the n-th node of the node array, complemented if c */
+    std::vector<bool> visited(getNumNodes(), 0);
+    markNodes(funcs[i].root, visited);
+    std::vector<uint64_t> counts(2 * getNumNodes(), 0);
+    for (uint16_t m=1; m<=getNumVars(); m++) {
+        for (uint64_t n=levelStart[m]; n<levelStart[m+1]; n++) {
+            if (!visited[n]) continue;
+            const EdgeHandle* child = nodes + n * header->numChild;
+            for (int c=0; c<2; c++) {
+                uint64_t sum = 0;
+                for (int b=0; b<2; b++) {
+                    Edge edge(child[b]);
+                    if (c) edge.complement();
+                    sum += countEdge(m-1, edge, val, counts);
+                }
+                counts[2*n + c] = sum;
+            }
+        }
+    }
+    return countEdge(getNumVars(), getRoot(i), val, counts);
+}
+
+uint64_t Snapshot::countEdge(const uint16_t k, const Edge& edge, const int val, const std::vector<uint64_t>& counts) const
+{
+    uint16_t m = edge.getNodeLevel();
+    uint64_t target = 0;
+    if (m == 0) {
+        // the value of the terminal, complemented if needed
+        EdgeHandle handle = edge.getEdgeHandle();
+        NodeHandle data = unpackTarget(handle);
+        bool isComp = edge.getComp() && (header->compType != NO_COMP);
+        bool isVal = 0;
+        if (handle & FLOAT_VALUE_FLAG_MASK) {
+            float terminalVal = *reinterpret_cast<float*>(&data);
+            isVal = ((isComp ? header->maxRange - terminalVal : terminalVal) == (float)val);
+        } else if (handle & INT_VALUE_FLAG_MASK) {
+            int terminalVal = *reinterpret_cast<int*>(&data);
+            isVal = ((isComp ? (long)header->maxRange - terminalVal : terminalVal) == val);
+        }
+        target = isVal;
+    } else {
+        uint64_t n = levelStart[m] + edge.getNodeHandle();
+        target = counts[2*n + ((header->compType == COMP) && edge.getComp())];
+    }
+    /* Modulo 2^64, as Forest::count */
+    auto pow2 = [](const unsigned e) {return (e < 64) ? (uint64_t)1 << e : (uint64_t)0;};
+    ReductionRule rule = edge.getRule();
+    unsigned skipped = k - m;
+    if ((skipped == 0) || (rule == RULE_X)) return (skipped < 64) ? target << skipped : 0;
+    /* Among the 2^skipped values of the skipped variables, one goes to the rule's terminal
+     * (AL, AH) or to the target (EL, EH), and all the others to the other one */
+    bool isRuleVal = ((int)hasRuleTerminalOne(rule) == val);
+    if (isRuleEL(rule) || isRuleEH(rule)) {
+        return (isRuleVal) ? target + pow2(k) - pow2(m) : target;
+    }
+    return ((isRuleVal) ? pow2(m) : 0) + ((skipped < 64) ? target << skipped : 0) - target;
+}
+
+uint64_t Snapshot::markNodes(const EdgeHandle root, std::vector<bool>& visited) const
+{
+    uint64_t num = 0;
+    std::vector<EdgeHandle> stack(1, root);
+    while (!stack.empty()) {
+        EdgeHandle edge = stack.back();
+        stack.pop_back();
+        uint16_t lvl = unpackLevel(edge);
+        if (lvl == 0) continue;
+        uint64_t id = levelStart[lvl] + unpackTarget(edge);
+        if (visited[id]) continue;
+        visited[id] = 1;
+        num++;
+        const EdgeHandle* child = slot(lvl, unpackTarget(edge));
+        for (uint8_t c=0; c<header->numChild; c++) stack.push_back(child[c]);
+    }
+    return num;
+}
@@ -0,0 +1,144 @@
+#ifndef REXBDD_SNAPSHOT_H
+#define REXBDD_SNAPSHOT_H
+
+#include "../defines.h"
+#include "../edge.h"
+#include "../terminal.h"
+
+#include <vector>
+
+namespace REXBDD {
+    class Snapshot;
+    class Forest;
+    class FuncArray;
+} // end of namespace
+
+// ******************************************************************
+// *                                                                *
+// *                       Snapshot class                           *
+// *                                                                *
+// ******************************************************************
+/** Read-only view of Funcs saved by Snapshot::write, for query-serving processes.
+ *  The file is mapped into memory (POSIX mmap, read-only and shared) and its node
+ *  slots are read in place: opening a snapshot only checks the header, whatever the
+ *  number of nodes, and processes opening the same file share its pages.
+ *  File layout, 8-byte aligned, in the byte order of the writing machine:
+ *  - Header (magic number "RXBS", version, setting of the forest, sizes);
+ *  - the variable at each level, as uint16;
+ *  - levelStart[k], the index of the first node at level k, for k = 1 ... numVars+1;
+ *  - the nodes, level 1 first: each is the child edge handles, where an edge to
+ *    a node stores the index of that node within its level;
+ *  - for each Func: its root edge handle (same remapping), and the offset and
+ *    length of its name;
+ *  - the names.
+ *  Edges returned by the queries follow the same remapping, so they are only
+ *  meaningful to this snapshot.
+ *  Note: only "set" forests with the terminal encoding are supported for now.
+ */
+class REXBDD::Snapshot {
+    /*-------------------------------------------------------------*/
+    public:
+    /*-------------------------------------------------------------*/
+    /// Map the snapshot file; exits with an error if it is not a valid snapshot
+    Snapshot(const std::string& path);
+    ~Snapshot();
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    /**
+     * @brief Write the given Funcs of a forest, with the nodes reachable from them,
+     * as a snapshot file.
+     */
+    static void write(const std::string& path, const Forest* forest, const FuncArray& funcs);
+
+    /***************************** General **************************/
+    inline uint16_t getNumVars() const {return header->numVars;}
+    inline int getNumFuncs() const {return (int)header->numFuncs;}
+    inline uint64_t getNumNodes() const {return header->numNodes;}
+    /// The variable at the given level
+    inline uint16_t getVar(uint16_t lvl) const {return var[lvl];}
+    inline std::string getName(int i) const {
+        return std::string(base + funcs[i].nameOffset, funcs[i].nameLength);
+    }
+    /// Index of the first Func with the given name; -1 if none
+    int findFunc(const std::string& name) const;
+
+    /***************************** Queries **************************/
+    /// The root edge of a Func, beginning at the top level
+    inline Edge getRoot(int i) const {
+        Edge root;
+        root.setEdgeHandle(funcs[i].root);
+        return root;
+    }
+    /**
+     * @brief The cofactor of an edge beginning at level "lvl", for the given value of the
+     * variable at that level; the result begins at lvl-1. Nothing is built: an edge that
+     * skips levels keeps (or drops) its rule for the levels left.
+     */
+    Edge cofact(const uint16_t lvl, const Edge& edge, const char index) const;
+    /**
+     * @brief Value of a Func for the given assignment, indexed by variables as in
+     * Func::evaluate (the first element is not used).
+     */
+    Value evaluate(int i, const std::vector<bool>& assignment) const;
+    /// Number of nodes reachable from a Func, or from all the Funcs
+    uint64_t countNodes(int i) const;
+    uint64_t countNodes() const;
+    /**
+     * @brief Number of assignments for which a Func has the value "val", as Forest::count:
+     * the nodes are counted once each from the bottom up. Modulo 2^64.
+     */
+    uint64_t count(int i, int val) const;
+
+    /*-------------------------------------------------------------*/
+    private:
+    /*-------------------------------------------------------------*/
+    /// Fixed part at the beginning of the file
+    struct Header {
+        uint32_t    magic;
+        uint16_t    version;
+        uint16_t    numVars;
+        uint8_t     valType;
+        uint8_t     swapType;
+        uint8_t     compType;
+        uint8_t     numChild;
+        uint32_t    reserved;
+        uint64_t    maxRange;
+        uint64_t    numNodes;
+        uint64_t    numFuncs;
+        uint64_t    fileSize;
+    };
+    /// Entry of a Func
+    struct FuncEntry {
+        EdgeHandle  root;
+        uint64_t    nameOffset;     // in bytes, from the beginning of the file
+        uint64_t    nameLength;
+    };
+    /// Offsets of the parts of a file, from the sizes in its header
+    struct Layout {
+        uint64_t    var;
+        uint64_t    levelStart;
+        uint64_t    nodes;
+        uint64_t    funcs;
+        uint64_t    names;
+        Layout(uint16_t numVars, uint8_t numChild, uint64_t numNodes, uint64_t numFuncs);
+    };
+    /// The child edge handles of a node
+    inline const EdgeHandle* slot(const uint16_t lvl, const NodeHandle index) const {
+        return nodes + (levelStart[lvl] + index) * header->numChild;
+    }
+    /// Mark the nodes reachable from a root, in "visited" indexed like the node array
+    uint64_t markNodes(const EdgeHandle root, std::vector<bool>& visited) const;
+    /// Count of an edge beginning at level k, once its target is in "counts" (see count())
+    uint64_t countEdge(const uint16_t k, const Edge& edge, const int val, const std::vector<uint64_t>& counts) const;
+    /// ============================================================
+    const char*         base;       // The mapped file
+    uint64_t            size;       // Bytes mapped
+    const Header*       header;
+    const uint16_t*     var;        // var[k] is the variable at level k
+    const uint64_t*     levelStart; // levelStart[k]: index of the first node at level k
+    const EdgeHandle*   nodes;
+    const FuncEntry*    funcs;
+};
+
+#endif
@@ -7,6 +7,7 @@
 
 #include "info.h"
 #include "defines.h"
+#include "bigint.h"
 #include "setting.h"
 #include "node.h"
 #include "edge.h"
@@ -17,6 +18,7 @@
 #include "operators.h"
 #include "operations/apply.h"
 #include "IO/out_dot.h"
+#include "IO/snapshot.h"
 
 #include <iostream>
 
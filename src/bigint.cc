@@ -0,0 +1,141 @@
+#include "bigint.h"
+
+#include <cmath>
+
+using namespace REXBDD;
+// ******************************************************************
+// *                                                                *
+// *                                                                *
+// *                        BigInt methods                          *
+// *                                                                *
+// *                                                                *
+// ******************************************************************
+
+BigInt::BigInt(uint64_t value)
+{
+    while (value) {
+        limbs.push_back((uint32_t)value);
+        value >>= 32;
+    }
+}
+
+BigInt BigInt::pow2(const unsigned e)
+{
+    BigInt ans(1);
+    ans <<= e;
+    return ans;
+}
+
+unsigned BigInt::numBits() const
+{
+    if (limbs.empty()) return 0;
+    unsigned bits = 32 * (limbs.size() - 1);
+    for (uint32_t top = limbs.back(); top; top >>= 1) bits++;
+    return bits;
+}
+
+BigInt& BigInt::operator+=(const BigInt& b)
+{
+    if (b.limbs.size() > limbs.size()) limbs.resize(b.limbs.size(), 0);
+    uint64_t carry = 0;
+    for (size_t i=0; i<limbs.size(); i++) {
+        uint64_t sum = (uint64_t)limbs[i] + carry + ((i < b.limbs.size()) ? b.limbs[i] : 0);
+        limbs[i] = (uint32_t)sum;
+        carry = sum >> 32;
+        if (!carry && (i >= b.limbs.size())) break;
+    }
+    if (carry) limbs.push_back((uint32_t)carry);
+    return *this;
+}
+
+BigInt& BigInt::operator-=(const BigInt& b)
+{
+    if (*this < b) {
+        std::cout << "[REXBDD] ERROR!\t BigInt: negative result of a subtraction!" << std::endl;
+        exit(0);
+    }
+    int64_t borrow = 0;
+    for (size_t i=0; i<limbs.size(); i++) {
+        int64_t diff = (int64_t)limbs[i] - borrow - ((i < b.limbs.size()) ? (int64_t)b.limbs[i] : 0);
+        borrow = (diff < 0);
+        limbs[i] = (uint32_t)(diff + (borrow << 32));
+        if (!borrow && (i >= b.limbs.size())) break;
+    }
+    trim();
+    return *this;
+}
+
+BigInt& BigInt::operator<<=(const unsigned e)
+{
+    if (limbs.empty()) return *this;
+    unsigned words = e / 32, bits = e % 32;
+    if (bits) {
+        uint32_t carry = 0;
+        for (size_t i=0; i<limbs.size(); i++) {
+            uint32_t limb = limbs[i];
+            limbs[i] = (limb << bits) | carry;
+            carry = limb >> (32 - bits);
+        }
+        if (carry) limbs.push_back(carry);
+    }
+    limbs.insert(limbs.begin(), words, 0);
+    return *this;
+}
+
+bool BigInt::operator<(const BigInt& b) const
+{
+    if (limbs.size() != b.limbs.size()) return limbs.size() < b.limbs.size();
+    for (size_t i=limbs.size(); i>0; i--) {
+        if (limbs[i-1] != b.limbs[i-1]) return limbs[i-1] < b.limbs[i-1];
+    }
+    return 0;
+}
+
+uint64_t BigInt::toUint64() const
+{
+    uint64_t ans = 0;
+    if (limbs.size() > 0) ans = limbs[0];
+    if (limbs.size() > 1) ans |= (uint64_t)limbs[1] << 32;
+    return ans;
+}
+
+double BigInt::toDouble() const
+{
+    double ans = 0;
+    for (size_t i=limbs.size(); i>0; i--) ans = ans * 4294967296.0 + limbs[i-1];
+    return ans;
+}
+
+double BigInt::log2() const
+{
+    if (limbs.empty()) return -INFINITY;
+    // the top three limbs give more than the precision of a double; the others only scale it
+    size_t low = (limbs.size() > 3) ? limbs.size() - 3 : 0;
+    double top = 0;
+    for (size_t i=limbs.size(); i>low; i--) top = top * 4294967296.0 + limbs[i-1];
+    return std::log2(top) + 32.0 * low;
+}
+
+std::string BigInt::toString() const
+{
+    if (limbs.empty()) return "0";
+    /* Repeated division by 10^9 */
+    std::vector<uint32_t> rest = limbs;
+    std::vector<uint32_t> chunks;
+    while (!rest.empty()) {
+        uint64_t remainder = 0;
+        for (size_t i=rest.size(); i>0; i--) {
+            uint64_t cur = (remainder << 32) | rest[i-1];
+            rest[i-1] = (uint32_t)(cur / 1000000000);
+            remainder = cur % 1000000000;
+        }
+        chunks.push_back((uint32_t)remainder);
+        while (!rest.empty() && (rest.back() == 0)) rest.pop_back();
+    }
+    std::string ans = std::to_string(chunks.back());
+    for (size_t i=chunks.size()-1; i>0; i--) {
+        std::string digits = std::to_string(chunks[i-1]);
+        ans += std::string(9 - digits.size(), '0') + digits;
+    }
+    return ans;
+}
@@ -0,0 +1,75 @@
+#ifndef REXBDD_BIGINT_H
+#define REXBDD_BIGINT_H
+
+#include "defines.h"
+
+#include <vector>
+
+namespace REXBDD {
+    class BigInt;
+}; // namespace REXBDD
+
+// ******************************************************************
+// *                                                                *
+// *                                                                *
+// *                         BigInt class                           *
+// *                                                                *
+// *                                                                *
+// ******************************************************************
+/**
+ * @brief Unsigned integer of arbitrary precision, for the number of assignments
+ * of functions over many variables (so GMP is not needed).
+ * Stored as 32-bit limbs, the least significant first, without leading zero limbs.
+ *
+ */
+class REXBDD::BigInt {
+    /*-------------------------------------------------------------*/
+    public:
+    /*-------------------------------------------------------------*/
+    BigInt(uint64_t value = 0);
+
+    /// 2 to the power of e
+    static BigInt pow2(const unsigned e);
+
+    inline bool isZero() const {return limbs.empty();}
+    /// Number of significant bits; 0 for zero
+    unsigned numBits() const;
+
+    BigInt& operator+=(const BigInt& b);
+    /// Subtract b; b must not be larger
+    BigInt& operator-=(const BigInt& b);
+    /// Multiply by 2 to the power of e
+    BigInt& operator<<=(const unsigned e);
+
+    inline BigInt operator+(const BigInt& b) const {BigInt ans(*this); ans += b; return ans;}
+    inline BigInt operator-(const BigInt& b) const {BigInt ans(*this); ans -= b; return ans;}
+    inline BigInt operator<<(const unsigned e) const {BigInt ans(*this); ans <<= e; return ans;}
+
+    inline bool operator==(const BigInt& b) const {return limbs == b.limbs;}
+    inline bool operator!=(const BigInt& b) const {return limbs != b.limbs;}
+    bool operator<(const BigInt& b) const;
+
+    /// The lowest 64 bits
+    uint64_t toUint64() const;
+    /// Nearest double; infinity if too large
+    double toDouble() const;
+    /// Base-2 logarithm; -infinity for zero
+    double log2() const;
+    /// Decimal digits
+    std::string toString() const;
+
+    /*-------------------------------------------------------------*/
+    private:
+    /*-------------------------------------------------------------*/
+    inline void trim() {
+        while (!limbs.empty() && (limbs.back() == 0)) limbs.pop_back();
+    }
+    std::vector<uint32_t>   limbs;
+};
+
+inline std::ostream& operator<<(std::ostream& out, const REXBDD::BigInt& b)
+{
+    return out << b.toString();
+}
+
+#endif
@@ -53,26 +53,6 @@ void Value::print(std::ostream& out, int format) const
 // *                                                                *
 // ******************************************************************
 
-Edge::Edge()
-{
-    handle = 0;
-    value = Value(0);
-}
-Edge::Edge(const Edge &e)
-{
-    handle = e.handle;
-    value = e.value;
-}
-Edge::Edge(const EdgeHandle h, Value val):value(val)
-{
-    //
-    handle = h;
-}
-Edge::~Edge()
-{
-
-}
-
 Edge Edge::part(bool xy) const {
     Edge ans;
     ReductionRule rule = unpackRule(handle);
@@ -100,7 +80,7 @@ bool Edge::isComplementTo(const Edge& e) const {
             exit(0);
         }
         return (((isTerminalOne(handle) ^ getComp()) != (isTerminalOne(e.handle) ^ e.getComp()))
-                && (this->getRule() == e.getRule()));
+                && (getRule() == compRule(e.getRule())));
     }
     if ((getNodeLevel() != e.getNodeLevel()) || (getNodeHandle() != e.getNodeHandle())) return false;
     if ((getSwap(0) != e.getSwap(0)) || (getSwap(1) != e.getSwap(1))) return false;
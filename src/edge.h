@@ -4,6 +4,8 @@
 #include "defines.h"
 #include "setting.h"
 
+#include <type_traits>
+
 namespace REXBDD {
     enum class SpecialValue {
         OMEGA,
@@ -28,6 +30,8 @@ namespace REXBDD {
     }
     class Value;
     class Edge;
+    class ValuedEdge;
+    class ChildEdges;
     class Forest;
     // file I/O
     // TBD
@@ -304,11 +308,6 @@ class REXBDD::Value {
     inline void setValue(const T& value, const ValueType type) {
         setValue(static_cast<const void*>(&value), type);
     }
-    inline Value& operator=(const Value& val) {
-        if (equals(val)) return *this;
-        init(val);
-        return *this;
-    }
     inline bool operator==(const Value& val) const {
         return equals(val);
     }
@@ -427,15 +426,18 @@ class REXBDD::Value {
 // *                                                                *
 // *                                                                *
 // ******************************************************************
+/**
+ * @brief An edge is its 8-byte edge handle, and it is trivially copyable: this is
+ * all the terminal-encoded forests need, in nodes, compute tables and recursions.
+ * The edge values of the edge-valued encodings are carried by ValuedEdge.
+ *
+ */
 class REXBDD::Edge {
     /*-------------------------------------------------------------*/
     public:
     /*-------------------------------------------------------------*/
-        Edge();
-        Edge(const Edge &e);
-        Edge(const ReductionRule rule, Value val);
-        Edge(const EdgeHandle h, Value val);
-        ~Edge();
+        Edge():handle(0) {}
+        explicit Edge(const EdgeHandle h):handle(h) {}
 
         /* Access to data */
 
@@ -446,7 +448,6 @@ class REXBDD::Edge {
         inline ReductionRule getRule() const {return unpackRule(handle);}
         inline bool getComp() const {return unpackComp(handle);}
         inline bool getSwap(bool isTo) const {return (isTo)?unpackSwapTo(handle):unpackSwap(handle);}
-        inline Value getValue() const {return value;}
 
         inline void setNodeHandle(NodeHandle target) {packTarget(handle, target);}
         inline void setEdgeHandle(EdgeHandle edge) {handle = edge;}
@@ -483,30 +484,17 @@ class REXBDD::Edge {
             packSwap(handle, !unpackSwap(handle));
         }
 
-        inline Edge& operator=(const Edge& e) {
-            if (equals(e)) return *this;
-            init(e);
-            return *this;
-        }
-
         inline bool operator==(const Edge& e) const {
-            return equals(e);
+            return handle == e.handle;
         }
         inline bool operator!=(const Edge& e) const {
-            return !equals(e);
+            return handle != e.handle;
         }
 
         void print(std::ostream& out, int format=0) const;
     /*-------------------------------------------------------------*/
     private:
     /*-------------------------------------------------------------*/
-        inline void init(const Edge& e) {
-            handle = e.handle;
-            value = e.value;
-        }
-        inline bool equals(const Edge& e) const {
-            return (handle == e.handle) && (value == e.value);
-        }
         /* Getters and Setters under Forest */
         friend class Forest;
         friend class Func;
@@ -514,9 +502,83 @@ class REXBDD::Edge {
 
         /* Actual edge information */
         EdgeHandle      handle;     // Rule, flags, taget node and level.
-        Value           value;      // Edge value.
 
         // std::string     display;    // for displaying if needed in the future
 };
+static_assert(sizeof(REXBDD::Edge) == sizeof(REXBDD::EdgeHandle), "Edge must be its edge handle only");
+static_assert(std::is_trivially_copyable<REXBDD::Edge>::value, "Edge must be trivially copyable");
+
+// ******************************************************************
+// *                                                                *
+// *                                                                *
+// *                       ValuedEdge class                         *
+// *                                                                *
+// *                                                                *
+// ******************************************************************
+/**
+ * @brief An edge with its edge value, for the edge-valued encodings (EV+, EV%, EV*).
+ *
+ */
+class REXBDD::ValuedEdge {
+    /*-------------------------------------------------------------*/
+    public:
+    /*-------------------------------------------------------------*/
+        ValuedEdge() {}
+        ValuedEdge(const Edge& e, const Value& val):edge(e),value(val) {}
+
+        inline const Edge& getEdge() const {return edge;}
+        inline Value getValue() const {return value;}
+        inline void setEdge(const Edge& e) {edge = e;}
+        inline void setValue(const Value& val) {value = val;}
+
+        inline bool operator==(const ValuedEdge& e) const {
+            return (edge == e.edge) && (value == e.value);
+        }
+        inline bool operator!=(const ValuedEdge& e) const {
+            return !(*this == e);
+        }
+    /*-------------------------------------------------------------*/
+    private:
+    /*-------------------------------------------------------------*/
+        Edge            edge;
+        Value           value;      // Edge value.
+};
+
+// ******************************************************************
+// *                                                                *
+// *                                                                *
+// *                       ChildEdges class                         *
+// *                                                                *
+// *                                                                *
+// ******************************************************************
+/**
+ * @brief The child edges of a node: 2 for "set" BDDs, 4 for "relation" BMxDs.
+ * They are stored in place, so reducing and building nodes allocates nothing.
+ *
+ */
+class REXBDD::ChildEdges {
+    /*-------------------------------------------------------------*/
+    public:
+    /*-------------------------------------------------------------*/
+        explicit ChildEdges(const uint8_t size = 2):num(size) {}
+        ChildEdges(const uint8_t size, const Edge& edge):num(size) {
+            for (uint8_t i=0; i<num; i++) edges[i] = edge;
+        }
+        /// From a vector, for the callers of the reduction API; any size other than 2 or 4 is rejected there
+        ChildEdges(const std::vector<Edge>& down):num((down.size() > 0xFF) ? 0xFF : (uint8_t)down.size()) {
+            for (size_t i=0; (i<down.size()) && (i<4); i++) edges[i] = down[i];
+        }
+
+        inline size_t size() const {return num;}
+        inline Edge& operator[](const size_t i) {return edges[i];}
+        inline const Edge& operator[](const size_t i) const {return edges[i];}
+        inline Edge* data() {return edges;}
+        inline const Edge* data() const {return edges;}
+    /*-------------------------------------------------------------*/
+    private:
+    /*-------------------------------------------------------------*/
+        Edge            edges[4];
+        uint8_t         num;
+};
 
 #endif
\ No newline at end of file
@@ -1,8 +1,37 @@
 #include "forest.h"
+#include "operations/operation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
 
 // #define REXBDD_TRACE
 
 using namespace REXBDD;
+
+// Live nodes triggering the first dynamic reordering
+static const uint64_t FIRST_REORDER = 4096;
+// Sifting stops moving a variable further when the forest grows by this factor
+static const double MAX_SIFT_GROWTH = 1.2;
+// Header of the binary files: "RXBD", and the format version
+static const uint32_t IO_MAGIC = 0x52584244;
+static const uint16_t IO_VERSION = 1;
+
+template <typename T>
+static inline void writeBinary(std::ostream& out, const T& data)
+{
+    out.write(reinterpret_cast<const char*>(&data), sizeof(T));
+}
+template <typename T>
+static inline T readBinary(std::istream& in)
+{
+    T data;
+    if (!in.read(reinterpret_cast<char*>(&data), sizeof(T))) {
+        std::cout << "[REXBDD] ERROR!\t Forest::importFunc(): unexpected end of file!" << std::endl;
+        exit(0);
+    }
+    return data;
+}
 // ******************************************************************
 // *                                                                *
 // *                                                                *
@@ -19,46 +48,373 @@ Forest::Forest(const ForestSetting& s):setting(s)
     nodeMan = new NodeManager(this);
     uniqueTable = new UniqueTable(this);
     stats = new Statistics();
+    funcs = 0;
+    funcSets = 0;
+    nextGC = setting.getGCThreshold();
+    nextReorder = FIRST_REORDER;
+    selectKernel();
+    buildRuleTables();
 }
 Forest::~Forest()
 {
+    /* Operations on this forest go away, and the others forget it */
+    UOPs.removeForest(this);
+    BOPs.removeForest(this);
+    SATs.removeForest(this);
+    for (size_t i=0; i<caches.size(); i++) {
+        caches[i]->detach(this);
+    }
+    caches.clear();
+    /* Funcs still alive are detached */
+    delete funcSets;
+    while (funcs) funcs->attach(nullptr);
     delete nodeMan;
     delete uniqueTable;
     delete stats;
 }
 /***************************** Cardinality **********************/
-uint64_t Forest::count(Func func, int val)
+uint64_t Forest::countNodes()
 {
-    uint64_t num = 0;
-    // TBD
+    unmark();
+    uint64_t num = markNodes(funcRoots());
+    unmark();
+    return num;
+}
+uint64_t Forest::countNodes(FuncArray funcArray)
+{
+    std::vector<Edge> roots;
+    for (int i=0; i<funcArray.size(); i++) roots.push_back(funcArray[i].getEdge());
+    unmark();
+    uint64_t num = markNodes(roots);
+    unmark();
     return num;
 }
+uint64_t Forest::countNodesAtLevel(uint16_t lvl)
+{
+    std::vector<uint64_t> perLevel(setting.getNumVars()+1, 0);
+    unmark();
+    markNodes(funcRoots(), perLevel.data());
+    unmark();
+    return perLevel[lvl];
+}
+uint64_t Forest::countNodesAtLevel(uint16_t lvl, Func func)
+{
+    std::vector<uint64_t> perLevel(setting.getNumVars()+1, 0);
+    unmark();
+    markNodes(std::vector<Edge>(1, func.getEdge()), perLevel.data());
+    unmark();
+    return perLevel[lvl];
+}
+uint64_t Forest::countNodesAtLevel(uint16_t lvl, FuncArray funcArray)
+{
+    std::vector<Edge> roots;
+    for (int i=0; i<funcArray.size(); i++) roots.push_back(funcArray[i].getEdge());
+    std::vector<uint64_t> perLevel(setting.getNumVars()+1, 0);
+    unmark();
+    markNodes(roots, perLevel.data());
+    unmark();
+    return perLevel[lvl];
+}
+uint64_t Forest::count(Func func, int val)
+{
+    return countEdge<uint64_t>(setting.getNumVars(), func.getEdge(), val);
+}
+double Forest::countLog2(Func func, int val)
+{
+    return countEdge<double>(setting.getNumVars(), func.getEdge(), val);
+}
+BigInt Forest::countExact(Func func, int val)
+{
+    return countEdge<BigInt>(setting.getNumVars(), func.getEdge(), val);
+}
+
+/* Arithmetic of the numbers of assignments, by result type */
+template <typename T> struct CountTraits;
+template <> struct CountTraits<uint64_t> {
+    // modulo 2^64
+    static inline uint64_t zero() {return 0;}
+    static inline uint64_t pow2(const unsigned e) {return (e < 64) ? (uint64_t)1 << e : 0;}
+    static inline uint64_t add(const uint64_t a, const uint64_t b) {return a + b;}
+    static inline uint64_t mulPow2(const uint64_t a, const unsigned e) {return (e < 64) ? a << e : 0;}
+    static inline uint64_t mulPow2Minus1(const uint64_t a, const unsigned e) {return mulPow2(a, e) - a;}
+    static inline uint64_t pow2Minus(const unsigned e, const uint64_t a) {return pow2(e) - a;}
+};
+template <> struct CountTraits<double> {
+    // base-2 logarithms
+    static inline double zero() {return -INFINITY;}
+    static inline double pow2(const unsigned e) {return e;}
+    static inline double add(const double a, const double b) {
+        if (a == -INFINITY) return b;
+        if (b == -INFINITY) return a;
+        double hi = std::max(a, b), lo = std::min(a, b);
+        return hi + std::log1p(std::exp2(lo - hi)) / M_LN2;
+    }
+    static inline double mulPow2(const double a, const unsigned e) {return a + e;}
+    static inline double mulPow2Minus1(const double a, const unsigned e) {
+        if ((a == -INFINITY) || (e == 0)) return -INFINITY;
+        return a + e + std::log1p(-std::exp2(-(double)e)) / M_LN2;
+    }
+    static inline double pow2Minus(const unsigned e, const double a) {
+        if (a >= e) return -INFINITY;
+        return e + std::log1p(-std::exp2(a - e)) / M_LN2;
+    }
+};
+template <> struct CountTraits<BigInt> {
+    static inline BigInt zero() {return BigInt(0);}
+    static inline BigInt pow2(const unsigned e) {return BigInt::pow2(e);}
+    static inline BigInt add(const BigInt& a, const BigInt& b) {return a + b;}
+    static inline BigInt mulPow2(const BigInt& a, const unsigned e) {return a << e;}
+    static inline BigInt mulPow2Minus1(const BigInt& a, const unsigned e) {return (a << e) - a;}
+    static inline BigInt pow2Minus(const unsigned e, const BigInt& a) {return BigInt::pow2(e) - a;}
+};
+
+template <typename T>
+T Forest::countEdge(const uint16_t lvl, const Edge& edge, const int val) const
+{
+    typedef CountTraits<T> Count;
+    if (setting.isRelation() || (setting.getEncodeMechanism() != TERMINAL)) {
+        std::cout << "[REXBDD] ERROR!\t Forest::count(): only set forests with the terminal encoding are supported!" << std::endl;
+        exit(0);
+    }
+    uint16_t numVars = setting.getNumVars();
+    CompSet ct = setting.getCompType();
+    long maxRange = setting.getMaxRange();
+    /* The reachable nodes, sorted by handle within each level */
+    std::vector<std::vector<NodeHandle> > levels;
+    unmark();
+    markNodes(std::vector<Edge>(1, edge), 0, &levels);
+    unmark();
+    /* counts[m][2i+c]: for the i-th node at level m, complemented if c, as in Func::evaluate */
+    std::vector<std::vector<T> > counts(numVars+1);
+    /* The count of an edge beginning at level k, once its target is counted */
+    auto countOf = [&](const uint16_t k, const Edge& current) {
+        uint16_t m = current.getNodeLevel();
+        T target = Count::zero();
+        if (m == 0) {
+            // the value of the terminal, complemented if needed
+            EdgeHandle handle = current.getEdgeHandle();
+            NodeHandle data = unpackTarget(handle);
+            bool isComp = current.getComp() && (ct != NO_COMP);
+            bool isVal = 0;
+            if (handle & FLOAT_VALUE_FLAG_MASK) {
+                float terminalVal = *reinterpret_cast<float*>(&data);
+                isVal = ((isComp ? maxRange - terminalVal : terminalVal) == (float)val);
+            } else if (handle & INT_VALUE_FLAG_MASK) {
+                int terminalVal = *reinterpret_cast<int*>(&data);
+                isVal = ((isComp ? maxRange - terminalVal : terminalVal) == val);
+            }
+            if (isVal) target = Count::pow2(0);
+        } else {
+            const std::vector<NodeHandle>& nodes = levels[m];
+            size_t i = std::lower_bound(nodes.begin(), nodes.end(), current.getNodeHandle()) - nodes.begin();
+            target = counts[m][2*i + ((ct == COMP) && current.getComp())];
+        }
+        ReductionRule rule = current.getRule();
+        unsigned skipped = k - m;
+        if ((skipped == 0) || (rule == RULE_X)) return Count::mulPow2(target, skipped);
+        /* Among the 2^skipped values of the skipped variables, one goes to the rule's terminal
+         * (AL, AH) or to the target (EL, EH), and all the others to the other one */
+        bool isRuleVal = ((int)hasRuleTerminalOne(rule) == val);
+        if (isRuleEL(rule) || isRuleEH(rule)) {
+            return (isRuleVal) ? Count::add(target, Count::pow2Minus(k, Count::pow2(m))) : target;
+        }
+        return Count::add((isRuleVal) ? Count::pow2(m) : Count::zero(), Count::mulPow2Minus1(target, skipped));
+    };
+    for (uint16_t m=1; m<=numVars; m++) {
+        counts[m].reserve(2 * levels[m].size());
+        for (size_t i=0; i<levels[m].size(); i++) {
+            NodeView view = getNodeView(m, levels[m][i]);
+            for (char c=0; c<2; c++) {
+                T sum = Count::zero();
+                for (char b=0; b<2; b++) {
+                    Edge child = view[b];
+                    if (c) child.complement();
+                    sum = Count::add(sum, countOf(m-1, child));
+                }
+                counts[m].push_back(sum);
+            }
+        }
+    }
+    return countOf(lvl, edge);
+}
+template <typename T>
+T Forest::cardinalityEdge(const uint16_t lvl, const Edge& edge) const
+{
+    // the assignments not mapped to 0
+    return CountTraits<T>::pow2Minus(lvl, countEdge<T>(lvl, edge, 0));
+}
+template uint64_t Forest::countEdge<uint64_t>(const uint16_t, const Edge&, const int) const;
+template double Forest::countEdge<double>(const uint16_t, const Edge&, const int) const;
+template BigInt Forest::countEdge<BigInt>(const uint16_t, const Edge&, const int) const;
+template uint64_t Forest::cardinalityEdge<uint64_t>(const uint16_t, const Edge&) const;
+template double Forest::cardinalityEdge<double>(const uint16_t, const Edge&) const;
+template BigInt Forest::cardinalityEdge<BigInt>(const uint16_t, const Edge&) const;
 /****************************** I/O *****************************/
 void Forest::exportFunc(std::ostream& out, FuncArray func)
 {
-    //
+    if ((func.size() > 0) && !func.isAttachedTo(this)) {
+        std::cout << "[REXBDD] ERROR!\t Forest::exportFunc(): the Funcs are in another forest!" << std::endl;
+        exit(0);
+    }
+    if (setting.getEncodeMechanism() != TERMINAL) {
+        std::cout << "[REXBDD] ERROR!\t Forest::exportFunc(): only the terminal encoding is supported!" << std::endl;
+        exit(0);
+    }
+    uint16_t numVars = setting.getNumVars();
+    char numChild = (setting.isRelation()) ? 4 : 2;
+    /* The reachable nodes, sorted by handle within each level */
+    std::vector<Edge> roots;
+    for (int i=0; i<func.size(); i++) roots.push_back(func[i].getEdge());
+    std::vector<std::vector<NodeHandle> > levels;
+    unmark();
+    markNodes(roots, 0, &levels);
+    unmark();
+    /* Header */
+    writeBinary(out, IO_MAGIC);
+    writeBinary(out, IO_VERSION);
+    writeSetting(out);
+    /* Nodes, from the bottom up */
+    for (uint16_t lvl=1; lvl<=numVars; lvl++) {
+        writeBinary(out, (uint32_t)levels[lvl].size());
+        for (size_t i=0; i<levels[lvl].size(); i++) {
+            NodeView view = getNodeView(lvl, levels[lvl][i]);
+            for (char c=0; c<numChild; c++) {
+                writeBinary(out, remapHandle(view[c].getEdgeHandle(), levels));
+            }
+        }
+    }
+    /* Funcs */
+    writeBinary(out, (uint32_t)func.size());
+    for (int i=0; i<func.size(); i++) {
+        writeBinary(out, remapHandle(func[i].getEdge().getEdgeHandle(), levels));
+        std::string name = func[i].getName();
+        writeBinary(out, (uint32_t)name.size());
+        out.write(name.data(), name.size());
+    }
+    if (!out) {
+        std::cout << "[REXBDD] ERROR!\t Forest::exportFunc(): write failed!" << std::endl;
+        exit(0);
+    }
 }
 void Forest::exportForest(std::ostream& out)
 {
-    //
+    FuncArray all(this, 0);
+    for (Func* f = funcs; f; f = f->nextFunc) all.add(*f);
+    exportFunc(out, all);
 }
 FuncArray Forest::importFunc(std::istream& in)
 {
-    //
-    FuncArray result;
-    // TBD
+    if ((readBinary<uint32_t>(in) != IO_MAGIC) || (readBinary<uint16_t>(in) != IO_VERSION)) {
+        std::cout << "[REXBDD] ERROR!\t Forest::importFunc(): not a RexBDD file of version "
+                  << IO_VERSION << ", or of another byte order!" << std::endl;
+        exit(0);
+    }
+    checkSetting(in);
+    uint16_t numVars = setting.getNumVars();
+    char numChild = (setting.isRelation()) ? 4 : 2;
+    EdgeLabel root = 0;
+    packRule(root, RULE_X);
+    /* For each node read: its edge in this forest, and its child edges in this forest */
+    std::vector<std::vector<Edge> > image(numVars+1), kids(numVars+1);
+    /* The edge in this forest for an edge of the file, beginning at the given level */
+    auto rebuild = [&](uint16_t beginLvl, EdgeHandle handle) {
+        Edge ans;
+        ans.setEdgeHandle(handle);
+        uint16_t lvl = unpackLevel(handle);
+        if (lvl == 0) return ans;
+        NodeHandle index = unpackTarget(handle);
+        if ((lvl > beginLvl) || (index >= image[lvl].size())) {
+            std::cout << "[REXBDD] ERROR!\t Forest::importFunc(): invalid edge in the file!" << std::endl;
+            exit(0);
+        }
+        const Edge& node = image[lvl][index];
+        if ((node.getNodeLevel() == lvl) && (unpackLabel(node.getEdgeHandle()) == root)) {
+            // the node came back as it was, only its handle differs
+            ans.setNodeHandle(node.getNodeHandle());
+            return ans;
+        }
+        ChildEdges child(numChild);
+        for (char c=0; c<numChild; c++) child[c] = kids[lvl][index * numChild + c];
+        return reduceEdge(beginLvl, unpackLabel(handle), lvl, child);
+    };
+    /* Nodes, from the bottom up: their children are already in this forest */
+    ChildEdges child(numChild);
+    for (uint16_t lvl=1; lvl<=numVars; lvl++) {
+        uint32_t num = readBinary<uint32_t>(in);
+        image[lvl].reserve(num);
+        kids[lvl].reserve((size_t)num * numChild);
+        for (uint32_t i=0; i<num; i++) {
+            for (char c=0; c<numChild; c++) {
+                child[c] = rebuild(lvl-1, readBinary<EdgeHandle>(in));
+                kids[lvl].push_back(child[c]);
+            }
+            image[lvl].push_back(reduceEdge(lvl, root, lvl, child));
+        }
+    }
+    /* Funcs */
+    uint32_t num = readBinary<uint32_t>(in);
+    FuncArray result(this, num);
+    for (uint32_t i=0; i<num; i++) {
+        Func f(this, rebuild(numVars, readBinary<EdgeHandle>(in)));
+        std::string name(readBinary<uint32_t>(in), '\0');
+        in.read(&name[0], name.size());
+        if (!in) {
+            std::cout << "[REXBDD] ERROR!\t Forest::importFunc(): unexpected end of file!" << std::endl;
+            exit(0);
+        }
+        f.setName(name);
+        result.add(f);
+    }
     return result;
 }
 void Forest::importForest(std::istream& in)
 {
-    //
+    FuncArray* loaded = new FuncArray(importFunc(in));
+    delete funcSets;
+    funcSets = loaded;
+}
+void Forest::writeSetting(std::ostream& out) const
+{
+    uint16_t numVars = setting.getNumVars();
+    uint16_t rules = 0;
+    for (int r=RULE_EL0; r<=RULE_I1; r++) {
+        if (setting.hasReductionRule((ReductionRule)r)) rules |= (0x01 << r);
+    }
+    writeBinary(out, numVars);
+    writeBinary(out, (uint8_t)setting.isRelation());
+    writeBinary(out, (uint8_t)setting.getEncodeMechanism());
+    writeBinary(out, (uint8_t)setting.getValType());
+    writeBinary(out, (uint8_t)setting.getSwapType());
+    writeBinary(out, (uint8_t)setting.getCompType());
+    writeBinary(out, rules);
+    writeBinary(out, (uint64_t)setting.getMaxRange());
+    for (uint16_t lvl=1; lvl<=numVars; lvl++) writeBinary(out, setting.getVar(lvl));
+}
+void Forest::checkSetting(std::istream& in) const
+{
+    /* Write this forest's setting, then compare it with the one in the file */
+    std::ostringstream mine;
+    writeSetting(mine);
+    std::string expected = mine.str();
+    std::string given(expected.size(), '\0');
+    in.read(&given[0], given.size());
+    if (!in) {
+        std::cout << "[REXBDD] ERROR!\t Forest::importFunc(): unexpected end of file!" << std::endl;
+        exit(0);
+    }
+    if (given != expected) {
+        std::cout << "[REXBDD] ERROR!\t Forest::importFunc(): the file was written by a forest with another setting"
+                  << " or variable order!" << std::endl;
+        exit(0);
+    }
 }
 /************************* Reduction ****************************/
-Edge Forest::normalizeNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
+template <class K>
+Edge Forest::normalizeNodeKernel(const uint16_t nodeLevel, const ChildEdges& down)
 {
     // assuming all child edges are reduced and legal
     /* copy the child info */
-    std::vector<Edge> child = down;
+    ChildEdges child = down;
 #ifdef BRAVE_DD_TRACE
     std::cout<<"normalize node:\n";
     child[0].print(std::cout);
@@ -70,10 +426,12 @@ Edge Forest::normalizeNode(const uint16_t nodeLevel, const std::vector<Edge>& do
     Edge ans;
     ans.setLevel(nodeLevel);
     ans.setRule(RULE_X);    // short
-    Node node(setting);
+    // the node is built in place, then copied into the unique table
+    uint32_t slots[MAX_NODE_SIZE] = {0};
+    Node node(slots);
     bool comp = 0, swap = 0, swapTo = 0;
-    if (!setting.isRelation() && (setting.getEncodeMechanism() == TERMINAL)) {
-        if (setting.getSwapType() == ONE) {
+    if (!K::isRelation(setting) && (K::isTerminal(setting))) {
+        if (K::swapType(setting) == ONE) {
             // swap-one logic
             if (child[0].getNodeLevel() != child[1].getNodeLevel()) {
                 swap = child[0].getNodeLevel() > child[1].getNodeLevel();
@@ -88,7 +446,7 @@ Edge Forest::normalizeNode(const uint16_t nodeLevel, const std::vector<Edge>& do
                 swap = rule0 > rule1;
             }
             if (swap) SWAP(child[0], child[1]);
-        } else if (setting.getSwapType() == ALL) {
+        } else if (K::swapType(setting) == ALL) {
             // swap-all logic
             if (child[0].getNodeLevel() != child[1].getNodeLevel()) {
                 swap = child[0].getNodeLevel() > child[1].getNodeLevel();
@@ -112,11 +470,11 @@ Edge Forest::normalizeNode(const uint16_t nodeLevel, const std::vector<Edge>& do
                 useless1 = isSwapAllUseless(child[1]);
                 if (useless0 == 1) child[0].setSwap(0, 0);
                 if (useless1 == 1) child[1].setSwap(0, 0);
-                if ((useless0 == 2) && (setting.getCompType() == COMP)) {
+                if ((useless0 == 2) && (K::compType(setting) == COMP)) {
                     child[0].setSwap(0, 0);
                     child[0].setComp(!child[0].getComp());
                 }
-                if ((useless1 == 2) && (setting.getCompType() == COMP)) {
+                if ((useless1 == 2) && (K::compType(setting) == COMP)) {
                     child[1].setSwap(0, 0);
                     child[1].setComp(!child[1].getComp());
                 }
@@ -135,19 +493,19 @@ Edge Forest::normalizeNode(const uint16_t nodeLevel, const std::vector<Edge>& do
         std::cout << std::endl;
 #endif
         
-        bool hasLvl = setting.getReductionSize() > 0;
+        bool hasLvl = K::hasLevel(setting);
         node.setChildEdge(0, child[0].getEdgeHandle(), 0, hasLvl);
         node.setChildEdge(1, child[1].getEdgeHandle(), 0, hasLvl);
-    } else if (setting.isRelation() && setting.getEncodeMechanism() == TERMINAL){
+    } else if (K::isRelation(setting) && K::isTerminal(setting)){
         // for relation BDD TBD
-        if (setting.getSwapType() == FROM) {
+        if (K::swapType(setting) == FROM) {
             //
-        } else if (setting.getSwapType() == TO) {
+        } else if (K::swapType(setting) == TO) {
             //
-        } else if (setting.getSwapType() == FROM_TO) {
+        } else if (K::swapType(setting) == FROM_TO) {
             //
         }
-        bool hasLvl = setting.getReductionSize() > 0;
+        bool hasLvl = K::hasLevel(setting);
         node.setChildEdge(0, child[0].getEdgeHandle(), 1, hasLvl);
         node.setChildEdge(1, child[1].getEdgeHandle(), 1, hasLvl);
         node.setChildEdge(2, child[2].getEdgeHandle(), 1, hasLvl);
@@ -168,7 +526,145 @@ Edge Forest::normalizeNode(const uint16_t nodeLevel, const std::vector<Edge>& do
     return ans;
 }
 
+void Forest::buildRuleTables()
+{
+    ruleSet = 0;
+    for (int r=0; r<16; r++) {
+        if ((r <= RULE_I1) && setting.hasReductionRule((ReductionRule)r)) ruleSet |= (uint16_t)(0x01 << r);
+    }
+    // the terminals given by the rules, as cofact makes them
+    terminals[0] = (setting.getValType() == FLOAT) ? makeTerminal(FLOAT, 0.0f) : makeTerminal(INT, 0);
+    terminals[1] = (setting.getValType() == FLOAT) ? makeTerminal(FLOAT, 1.0f) : makeTerminal(INT, 1);
+    // the terminals of the reduced patterns, as reduceNode makes them
+    if (setting.getValType() == INT || setting.getValType() == LONG) {
+        reducedTerminals[0] = makeTerminal(INT, 0);
+        reducedTerminals[1] = makeTerminal(INT, 1);
+    } else if (setting.getValType() == FLOAT || setting.getValType() == DOUBLE) {
+        reducedTerminals[0] = makeTerminal(FLOAT, 0.0f);
+        reducedTerminals[1] = makeTerminal(FLOAT, 1.0f);
+    } else {
+        reducedTerminals[0] = makeTerminal(VOID, SpecialValue::OMEGA);
+        reducedTerminals[1] = reducedTerminals[0];
+    }
+    for (int r=0; r<16; r++) {
+        ReductionRule rule = (ReductionRule)r;
+        bool isRule = (r <= RULE_I1);
+        /* Edges to terminal 0 or 1, at levels 0, 1 and above */
+        for (int c=0; c<2; c++) {
+            for (int one=0; one<2; one++) {
+                for (uint16_t lvl=0; lvl<3; lvl++) {
+                    uint16_t& entry = normTerminal[r][c][one][lvl];
+                    entry = NORM_GENERIC;
+                    if (!isRule) continue;
+                    Edge edge;
+                    edge.setEdgeHandle(terminals[one]);
+                    edge.setRule(rule);
+                    edge.setComp(c);
+                    Edge ans = normalizeLabel(lvl, edge);
+                    EdgeHandle target = ans.getEdgeHandle() & ~LABEL_MASK;
+                    if ((target == terminals[0]) || (target == terminals[1])) {
+                        entry = (uint16_t)((ans.getEdgeHandle() & LABEL_MASK) >> 48) | (uint16_t)((target == terminals[1]) << 8);
+                    }
+                }
+            }
+        }
+        /* Edges to nodes, skipping 0, 1 or more levels */
+        for (uint16_t skip=0; skip<3; skip++) {
+            Edge edge;
+            edge.setLevel(1);
+            edge.setRule(rule);
+            normNode[r][skip] = (isRule) ? (uint8_t)normalizeLabel(1+skip, edge).getRule() : (uint8_t)rule;
+        }
+        /* Cofactors of long edges */
+        for (int isLast=0; isLast<2; isLast++) {
+            for (int index=0; index<4; index++) {
+                uint8_t& kind = cofactKind[r][isLast][index];
+                if (isRule && ((isRuleEL(rule) && (index == 0)) || (isRuleEH(rule) && (index == 1))
+                    || (isRuleAL(rule) && isLast && (index == 0))
+                    || (isRuleAH(rule) && isLast && (index == 1))
+                    || (isRuleI(rule) && ((index == 1) || (index == 2))))) {
+                    kind = (hasRuleTerminalOne(rule)) ? COFACT_ONE : COFACT_ZERO;
+                } else {
+                    kind = (isLast) ? COFACT_SHORT : COFACT_LONG;
+                }
+            }
+        }
+    }
+}
+
 Edge Forest::normalizeEdge(const uint16_t level, const Edge& edge)
+{
+    uint16_t targetLvl = edge.getNodeLevel();
+    uint16_t skip = (level - targetLvl > 1) ? 2 : level - targetLvl;
+    Edge normalized = edge;
+    /* Case 0 to 2: the label, looked up for edges to nodes and to terminal 0 or 1 */
+    if (targetLvl > 0) {
+        normalized.setRule((ReductionRule)normNode[edge.getRule()][skip]);
+    } else {
+        EdgeHandle target = edge.handle & ~LABEL_MASK;
+        uint16_t entry = NORM_GENERIC;
+        if ((target == terminals[0]) || (target == terminals[1])) {
+            entry = normTerminal[edge.getRule()][edge.getComp()][target == terminals[1]][skip];
+        }
+        if (entry != NORM_GENERIC) {
+            normalized.handle = terminals[entry >> 8] | ((EdgeHandle)(entry & 0xFF) << 48);
+        } else {
+            normalized = normalizeLabel(level, edge);
+        }
+    }
+    /* Case 3: long edge with reduction rule that is not allowed */
+    ReductionRule rule = normalized.getRule();
+    if ((level - targetLvl > 0) && !((ruleSet >> rule) & 0x01)) {
+        ChildEdges childEdges((setting.isRelation()) ? 4 : 2);
+        Edge temp = normalized;
+        if (rule == RULE_X) {
+            // it should be built
+            for (uint16_t k=targetLvl+1; k<=level; k++) {
+                for (size_t i=0; i<childEdges.size(); i++) {
+                    childEdges[i] = temp;
+                }
+                // as short incoming edge, reduceNode can be directly called
+                temp = reduceNode(k, childEdges);
+            }
+        } else if (isRuleEL(rule) || isRuleEH(rule) || isRuleAL(rule) || isRuleAH(rule)) {
+            bool child = (isRuleEL(rule) || isRuleAL(rule)) ? 0 : 1;
+            childEdges[child].handle = makeTerminal(INT,(int)hasRuleTerminalOne(rule));
+            if (setting.getValType() == FLOAT) {
+                childEdges[child].handle = makeTerminal(FLOAT,(float)hasRuleTerminalOne(rule));
+            }
+            childEdges[child].setRule(RULE_X);
+            childEdges[!child] = temp;
+            childEdges[!child].setRule(RULE_X);
+            for (uint16_t k=targetLvl+1; k<=level; k++) {
+                childEdges[0] = normalizeEdge(k-1, childEdges[0]);
+                childEdges[1] = normalizeEdge(k-1, childEdges[1]);
+                temp = reduceNode(k, childEdges);
+                childEdges[(isRuleEH(rule) || isRuleAL(rule))?0:1] = temp;
+            }
+        } else if (isRuleI(rule)) {
+            childEdges[0] = temp;
+            childEdges[3] = temp;
+            childEdges[1].handle = makeTerminal(INT,(int)hasRuleTerminalOne(rule));
+            childEdges[1].setRule(RULE_X);
+            childEdges[2].handle = makeTerminal(INT,(int)hasRuleTerminalOne(rule));
+            childEdges[2].setRule(RULE_X);
+            for (uint16_t k=targetLvl+1; k<=level; k++) {
+                childEdges[0] = normalizeEdge(k-1, childEdges[0]);
+                childEdges[1] = normalizeEdge(k-1, childEdges[1]);
+                childEdges[2] = normalizeEdge(k-1, childEdges[2]);
+                childEdges[3] = normalizeEdge(k-1, childEdges[3]);
+                temp = normalizeNode(k, childEdges);
+                childEdges[0] = temp;
+                childEdges[3] = temp;
+            }
+        }
+        normalized = temp;
+    }
+
+    return normalized;
+}
+
+Edge Forest::normalizeLabel(const uint16_t level, const Edge& edge) const
 {
     Edge normalized = edge;
     bool isCompAllowed = (setting.getCompType() != NO_COMP);
@@ -307,68 +803,14 @@ Edge Forest::normalizeEdge(const uint16_t level, const Edge& edge)
             }
         }
     }
-    /* Case 3: long edge with reduction rule that is not allowed */
-    rule = normalized.getRule();
-    comp = normalized.getComp();
-    if ((level - targetLvl > 0) && !setting.hasReductionRule(rule)) {
-        std::vector<Edge> childEdges;
-        if (setting.isRelation()) {
-            childEdges = std::vector<Edge>(4);
-        } else {
-            childEdges = std::vector<Edge>(2);
-        }
-        Edge temp = normalized;
-        if (rule == RULE_X) {
-            // it should be built
-            for (uint16_t k=targetLvl+1; k<=level; k++) {
-                for (size_t i=0; i<childEdges.size(); i++) {
-                    childEdges[i] = temp;
-                }
-                // as short incoming edge, reduceNode can be directly called
-                temp = reduceNode(k, childEdges);
-            }
-        } else if (isRuleEL(rule) || isRuleEH(rule) || isRuleAL(rule) || isRuleAH(rule)) {
-            bool child = (isRuleEL(rule) || isRuleAL(rule)) ? 0 : 1;
-            childEdges[child].handle = makeTerminal(INT,(int)hasRuleTerminalOne(rule));
-            if (setting.getValType() == FLOAT) {
-                childEdges[child].handle = makeTerminal(FLOAT,(float)hasRuleTerminalOne(rule));
-            }
-            childEdges[child].setRule(RULE_X);
-            childEdges[!child] = temp;
-            childEdges[!child].setRule(RULE_X);
-            for (uint16_t k=targetLvl+1; k<=level; k++) {
-                childEdges[0] = normalizeEdge(k-1, childEdges[0]);
-                childEdges[1] = normalizeEdge(k-1, childEdges[1]);
-                temp = reduceNode(k, childEdges);
-                childEdges[(isRuleEH(rule) || isRuleAL(rule))?0:1] = temp;
-            }
-        } else if (isRuleI(rule)) {
-            childEdges[0] = temp;
-            childEdges[3] = temp;
-            childEdges[1].handle = makeTerminal(INT,(int)hasRuleTerminalOne(rule));
-            childEdges[1].setRule(RULE_X);
-            childEdges[2].handle = makeTerminal(INT,(int)hasRuleTerminalOne(rule));
-            childEdges[2].setRule(RULE_X);
-            for (uint16_t k=targetLvl+1; k<=level; k++) {
-                childEdges[0] = normalizeEdge(k-1, childEdges[0]);
-                childEdges[1] = normalizeEdge(k-1, childEdges[1]);
-                childEdges[2] = normalizeEdge(k-1, childEdges[2]);
-                childEdges[3] = normalizeEdge(k-1, childEdges[3]);
-                temp = normalizeNode(k, childEdges);
-                childEdges[0] = temp;
-                childEdges[3] = temp;
-            }
-        }
-        normalized = temp;
-    }
-
     return normalized;
 }
 
-Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
+template <class K>
+Edge Forest::reduceNodeKernel(const uint16_t nodeLevel, const ChildEdges& down)
 {
     /* copy the child info , then normalize them */
-    std::vector<Edge> child = down;
+    ChildEdges child = down;
     for (size_t i=0; i<child.size(); i++) {
         child[i] = normalizeEdge(nodeLevel-1, child[i]);
     }
@@ -380,22 +822,16 @@ Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
     std::cout << std::endl;
 #endif
     /* setting info */
-    bool isCompAllowed = (setting.getCompType() != NO_COMP);
-    // bool isSwapAllowed = (setting.getSwapType() != NO_SWAP);
+    bool isCompAllowed = (K::compType(setting) != NO_COMP);
+    // bool isSwapAllowed = (K::swapType(setting) != NO_SWAP);
     /* The final answer, initialized */
     Edge reduced;
-    if (setting.getValType() == INT || setting.getValType() == LONG) {
-        reduced.handle = makeTerminal(INT, 0);
-    } else if (setting.getValType() == FLOAT || setting.getValType() == DOUBLE) {
-        reduced.handle = makeTerminal(FLOAT, 0.0f);
-    } else {
-        reduced.handle = makeTerminal(VOID, SpecialValue::OMEGA);
-    }
+    reduced.handle = reducedTerminals[0];
     /* check if the node matches an illegal pattern */
     /* =================================================================================================
     * BDD for "Set" (Terminal encoding)
     * ================================================================================================*/
-    if (!setting.isRelation() && (setting.getEncodeMechanism() == TERMINAL)) {
+    if (!K::isRelation(setting) && (K::isTerminal(setting))) {
         // flag for checking if match any allowed meta-reduction rule
         bool isMatch = 0;
         /* ---------------------------------------------------------------------------------------------
@@ -413,13 +849,13 @@ Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
                 && ((isTermOne0 || isTermZero0) && (isTermOne1 || isTermZero1))
                 && ((child[0].getComp() ^ isTermOne0) == (child[1].getComp() ^ isTermOne1))
                 && (nodeLevel >= 1)) {
-                if (setting.hasReductionRule(RULE_X)) {
+                if (K::hasRule(setting, RULE_X)) {
                     reduced = child[0];
                     isMatch = 1;
                 } else {
                     // enumerate from EL0 to AH1 to check if it's allowed
                     for (int r=0; r<8; r++){
-                        if (setting.hasReductionRule((ReductionRule)r)
+                        if (K::hasRule(setting, (ReductionRule)r)
                             && ((child[0].getComp()^isTermOne0) == hasRuleTerminalOne((ReductionRule)r))) {
                             reduced = child[0];
                             reduced.setRule((ReductionRule)r);
@@ -437,14 +873,14 @@ Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
                         && (isTermOne1 || isTermZero1)) {
                 // enumerate from EL0 to AH1 to check if it's allowed
                 for (int r=0; r<8; r++){
-                    if (setting.hasReductionRule((ReductionRule)r)
+                    if (K::hasRule(setting, (ReductionRule)r)
                         && (r < 4)    // EL or AL
                         && ((child[0].getComp()^isTermOne0) == hasRuleTerminalOne((ReductionRule)r))) {
                         reduced = child[1];
                         reduced.setRule((ReductionRule)r);
                         isMatch = 1;
                         break;
-                    } else if (setting.hasReductionRule((ReductionRule)r)
+                    } else if (K::hasRule(setting, (ReductionRule)r)
                         && (r >= 4)   // EH or AH
                         && ((child[1].getComp()^isTermOne1) == hasRuleTerminalOne((ReductionRule)r))) {
                         reduced = child[0];
@@ -466,35 +902,27 @@ Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
                         && (isTermOne0 || isTermZero0)
                         && (isTermOne1 || isTermZero1)) {
                 if ((child[0].getComp()^isTermOne0) == 0) {
-                    if (setting.hasReductionRule(RULE_EL0)) {
+                    if (K::hasRule(setting, RULE_EL0)) {
                         if (!isCompAllowed) {
                             // make terminal one
-                            if (setting.getValType() == INT || setting.getValType() == LONG) {
-                                reduced.handle = makeTerminal(INT, 1);
-                            } else if (setting.getValType() == FLOAT || setting.getValType() == DOUBLE) {
-                                reduced.handle = makeTerminal(FLOAT, 1.0f);
-                            }
+                            reduced.handle = reducedTerminals[1];
                         } else {
                             reduced.setComp(1);
                         }
                         reduced.setRule(RULE_EL0);
                         isMatch = 1;
-                    } else if (setting.hasReductionRule(RULE_AH1)) {
+                    } else if (K::hasRule(setting, RULE_AH1)) {
                         reduced.setRule(RULE_AH1);
                         isMatch = 1;
                     }
                 } else {
-                    if (setting.hasReductionRule(RULE_EL1)) {
+                    if (K::hasRule(setting, RULE_EL1)) {
                         reduced.setRule(RULE_EL1);
                         isMatch = 1;
-                    } else if (setting.hasReductionRule(RULE_AH0)) {
+                    } else if (K::hasRule(setting, RULE_AH0)) {
                         if (!isCompAllowed) {
                             // make terminal one
-                            if (setting.getValType() == INT || setting.getValType() == LONG) {
-                                reduced.handle = makeTerminal(INT, 1);
-                            } else if (setting.getValType() == FLOAT || setting.getValType() == DOUBLE) {
-                                reduced.handle = makeTerminal(FLOAT, 1.0f);
-                            }
+                            reduced.handle = reducedTerminals[1];
                         } else {
                             reduced.setComp(1);
                         }
@@ -515,35 +943,27 @@ Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
                         && (isTermOne0 || isTermZero0)
                         && (isTermOne1 || isTermZero1)) {
                 if ((child[1].getComp()^isTermOne1) == 0) {
-                    if (setting.hasReductionRule(RULE_EH0)) {
+                    if (K::hasRule(setting, RULE_EH0)) {
                         if (!isCompAllowed) {
                             // make terminal one
-                            if (setting.getValType() == INT || setting.getValType() == LONG) {
-                                reduced.handle = makeTerminal(INT, 1);
-                            } else if (setting.getValType() == FLOAT || setting.getValType() == DOUBLE) {
-                                reduced.handle = makeTerminal(FLOAT, 1.0f);
-                            }
+                            reduced.handle = reducedTerminals[1];
                         } else {
                             reduced.setComp(1);
                         }
                         reduced.setRule(RULE_EH0);
                         isMatch = 1;
-                    } else if (setting.hasReductionRule(RULE_AL1)) {
+                    } else if (K::hasRule(setting, RULE_AL1)) {
                         reduced.setRule(RULE_AL1);
                         isMatch = 1;
                     }
                 } else {
-                    if (setting.hasReductionRule(RULE_EH1)) {
+                    if (K::hasRule(setting, RULE_EH1)) {
                         reduced.setRule(RULE_EH1);
                         isMatch = 1;
-                    } else if (setting.hasReductionRule(RULE_AL0)) {
+                    } else if (K::hasRule(setting, RULE_AL0)) {
                         if (!isCompAllowed) {
                             // make terminal one
-                            if (setting.getValType() == INT || setting.getValType() == LONG) {
-                                reduced.handle = makeTerminal(INT, 1);
-                            } else if (setting.getValType() == FLOAT || setting.getValType() == DOUBLE) {
-                                reduced.handle = makeTerminal(FLOAT, 1.0f);
-                            }
+                            reduced.handle = reducedTerminals[1];
                         } else {
                             reduced.setComp(1);
                         }
@@ -553,7 +973,7 @@ Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
                 }
             } else {
                 // here means this is not a forbidden node pattern, then normalize and insert node
-                return normalizeNode(nodeLevel, child);
+                return normalizeNodeKernel<K>(nodeLevel, child);
             }
         /* ---------------------------------------------------------------------------------------------
         * Forbidden patterns of nodes with Low edge to terminal 0 and High edge to nonterminal
@@ -569,7 +989,7 @@ Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
                 && (isTermOne0 || isTermZero0)
                 && (((rule1 == RULE_X)
                         && (nodeLevel - child[1].getNodeLevel() == 1)
-                        && (setting.hasReductionRule((isTermOne0^comp0)? RULE_EL1 : RULE_EL0)))
+                        && (K::hasRule(setting, (isTermOne0^comp0)? RULE_EL1 : RULE_EL0)))
                     || (isRuleEL(rule1)
                         && (nodeLevel - child[1].getNodeLevel() > 1)
                         && (hasRuleTerminalOne(rule1) == (isTermOne0^comp0)))) ) {
@@ -578,7 +998,7 @@ Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
                     isMatch = 1;
             } else {
                 // here means this is not a forbidden node pattern, then normalize and insert node
-                return normalizeNode(nodeLevel, child);
+                return normalizeNodeKernel<K>(nodeLevel, child);
             }
         /* ---------------------------------------------------------------------------------------------
         * Forbidden patterns of nodes with High edge to terminal 0 and Low edge to nonterminal
@@ -593,7 +1013,7 @@ Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
                 && (isTermOne1 || isTermZero1)
                 && (((rule0 == RULE_X)
                         && (nodeLevel - child[0].getNodeLevel() == 1)
-                        && (setting.hasReductionRule((isTermOne1^comp1)? RULE_EH1 : RULE_EH0)))
+                        && (K::hasRule(setting, (isTermOne1^comp1)? RULE_EH1 : RULE_EH0)))
                     || (isRuleEH(rule0)
                         && (nodeLevel - child[0].getNodeLevel() > 1)
                         && (hasRuleTerminalOne(rule0) == (isTermOne1^comp1) )))) {
@@ -602,7 +1022,7 @@ Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
                     isMatch = 1;
             } else {
                 // here means this is not a forbidden node pattern, then normalize and insert node
-                return normalizeNode(nodeLevel, child);
+                return normalizeNodeKernel<K>(nodeLevel, child);
             }
         /* ---------------------------------------------------------------------------------------------
         * Forbidden patterns of nodes with both edges to the same nonterminal
@@ -615,7 +1035,7 @@ Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
                 /* X reduction rule */
                 if ((child[0].getRule() == child[1].getRule())
                     && (child[0].getRule() == RULE_X)
-                    && setting.hasReductionRule(RULE_X)) {
+                    && K::hasRule(setting, RULE_X)) {
                     reduced = child[0];
                     isMatch = 1;
                 /* AL reduction rule */
@@ -624,7 +1044,7 @@ Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
                                     && (nodeLevel - child[0].getNodeLevel() == 1))
                                 || (isRuleAL(child[0].getRule())
                                     && (nodeLevel - child[0].getNodeLevel() > 1)))
-                            && (setting.hasReductionRule((hasRuleTerminalOne(child[0].getRule())) ? RULE_AL1 : RULE_AL0)) ) {
+                            && (K::hasRule(setting, (hasRuleTerminalOne(child[0].getRule())) ? RULE_AL1 : RULE_AL0)) ) {
                     reduced = child[0];
                     reduced.setRule((hasRuleTerminalOne(child[0].getRule())) ? RULE_AL1 : RULE_AL0);
                     isMatch = 1;
@@ -634,29 +1054,29 @@ Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
                                     && (nodeLevel - child[1].getNodeLevel() == 1))
                                 || (isRuleAH(child[1].getRule())
                                     && (nodeLevel - child[1].getNodeLevel() > 1)))
-                            && (setting.hasReductionRule((hasRuleTerminalOne(child[1].getRule())) ? RULE_AH1 : RULE_AH0)) ) {
+                            && (K::hasRule(setting, (hasRuleTerminalOne(child[1].getRule())) ? RULE_AH1 : RULE_AH0)) ) {
                     reduced = child[1];
                     reduced.setRule((hasRuleTerminalOne(child[1].getRule())) ? RULE_AH1 : RULE_AH0);
                     isMatch = 1;
                 }
             } else {
                 // here means this is not a forbidden node pattern, then normalize and insert node
-                return normalizeNode(nodeLevel, child);
+                return normalizeNodeKernel<K>(nodeLevel, child);
             }
             
         }
         // here means the forbidden node pattern found but its equivalent edge rules are not allowed
-        if (!isMatch) return normalizeNode(nodeLevel, child);
+        if (!isMatch) return normalizeNodeKernel<K>(nodeLevel, child);
 
     /* =================================================================================================
     * BDD for "Set" (Edge value encoding)
     * ================================================================================================*/
-    } else if (!setting.isRelation() && setting.getEncodeMechanism() != TERMINAL) {
+    } else if (!K::isRelation(setting) && !K::isTerminal(setting)) {
         // TBD
     /* =================================================================================================
     * BMXD for "Relation" (Terminal encoding)
     * ================================================================================================*/
-    } else if (setting.isRelation() && setting.getEncodeMechanism() == TERMINAL) {
+    } else if (K::isRelation(setting) && K::isTerminal(setting)) {
         bool isMatch = 0;
         /* ---------------------------------------------------------------------------------------------
         * Redundant X
@@ -665,7 +1085,7 @@ Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
             && (child[1].getEdgeHandle() == child[2].getEdgeHandle())
             && (child[2].getEdgeHandle() == child[3].getEdgeHandle())
             && (child[0].getRule() == RULE_X)
-            && setting.hasReductionRule(RULE_X)) {
+            && K::hasRule(setting, RULE_X)) {
             reduced = child[0];
             isMatch = 0;
         /* ---------------------------------------------------------------------------------------------
@@ -680,18 +1100,19 @@ Edge Forest::reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down)
             //
         }
         // here means the forbidden node pattern found but its equivalent edge rules are not allowed
-        if (!isMatch) return normalizeNode(nodeLevel, child);
+        if (!isMatch) return normalizeNodeKernel<K>(nodeLevel, child);
     /* =================================================================================================
     * BMXD for "Relation" (Edge value encoding)
     * ================================================================================================*/
-    } else if (setting.isRelation() && setting.getEncodeMechanism() != TERMINAL) {
+    } else if (K::isRelation(setting) && !K::isTerminal(setting)) {
         // TBD
     }
 
     return reduced;
 }
 
-Edge Forest::mergeEdge(const uint16_t beginLevel, const uint16_t mergeLevel, const EdgeLabel label, const Edge& reduced, const Value& value)
+template <class K>
+Edge Forest::mergeEdgeKernel(const uint16_t beginLevel, const uint16_t mergeLevel, const EdgeLabel label, const Edge& reduced, const Value& value)
 {
 #ifdef BRAVE_DD_TRACE
     std::cout << "merge edge; beginLvl: "<< beginLevel << "; mergeLvl: " << mergeLevel << std::endl;
@@ -699,7 +1120,7 @@ Edge Forest::mergeEdge(const uint16_t beginLevel, const uint16_t mergeLevel, con
     reduced.print(std::cout);
     std::cout << std::endl;
 #endif
-    MergeType mt = setting.getMergeType();
+    MergeType mt = K::mergeType(setting);
     Edge merged;
     ReductionRule incomingRule = unpackRule(label);
     ReductionRule reducedRule = reduced.getRule();
@@ -756,25 +1177,20 @@ Edge Forest::mergeEdge(const uint16_t beginLevel, const uint16_t mergeLevel, con
     * --------------------------------------------------------------------------------------------*/
     if ((incomingRule == RULE_X) && (incomingSkip > 0) && (reducedRule != RULE_X)) {
         // it could be MXD
-        bool isRelation = setting.isRelation();
+        bool isRelation = K::isRelation(setting);
         /* Push-Up */
         if ((mt == PUSH_UP) || (mt == SHORTEN_X)) {
             // push-up one
-            std::vector<Edge> childEdges;
-            if (isRelation) {
-                childEdges = std::vector<Edge>(4);
-            } else {
-                childEdges = std::vector<Edge>(2);
-            }
+            ChildEdges childEdges((isRelation) ? 4 : 2);
             for (size_t i=0; i<childEdges.size(); i++) {
                 childEdges[i] = reduced;
             }
-            merged = normalizeNode(mergeLevel+1, childEdges);
+            merged = normalizeNodeKernel<K>(mergeLevel+1, childEdges);
         /* Push-Down */
         } else if ((mt == PUSH_DOWN) || (mt == SHORTEN_I)) {
             // For MXDs, here must be a incoming long X that merge with long I
             if (isRelation) {
-                std::vector<Edge> childEdges(4);
+                ChildEdges childEdges(4);
                 childEdges[0] = reduced;
                 childEdges[3] = reduced;
                 if (reducedSkip == 1) {
@@ -790,7 +1206,7 @@ Edge Forest::mergeEdge(const uint16_t beginLevel, const uint16_t mergeLevel, con
                 for (size_t i=0; i<childEdges.size(); i++) {
                     childEdges[i] = normalizeEdge(mergeLevel, childEdges[i]);
                 }
-                merged = normalizeNode(mergeLevel+1, childEdges);
+                merged = normalizeNodeKernel<K>(mergeLevel+1, childEdges);
                 merged.setRule(incomingRule);
             } else {
                 // unreduce BDDs node for push-down, TBD
@@ -809,7 +1225,7 @@ Edge Forest::mergeEdge(const uint16_t beginLevel, const uint16_t mergeLevel, con
         if (mt == PUSH_UP) {
             // push-up one
             bool child = isRuleEH(incomingRule) ? 0 : 1;
-            std::vector<Edge> childEdges(2);
+            ChildEdges childEdges(2);
             childEdges[child] = reduced;
             childEdges[!child].handle = makeTerminal(INT, (int)hasRuleTerminalOne(incomingRule));
             if (setting.getValType() == FLOAT || setting.getValType() == DOUBLE) {
@@ -817,7 +1233,7 @@ Edge Forest::mergeEdge(const uint16_t beginLevel, const uint16_t mergeLevel, con
             }
             childEdges[!child].setRule(RULE_X);
             childEdges[!child] = normalizeEdge(mergeLevel, childEdges[!child]);
-            merged = normalizeNode(mergeLevel+1, childEdges);
+            merged = normalizeNodeKernel<K>(mergeLevel+1, childEdges);
             merged.setRule((incomingSkip==1)?RULE_X:incomingRule);
         } else if (mt == PUSH_DOWN) {
             // TBD
@@ -827,7 +1243,7 @@ Edge Forest::mergeEdge(const uint16_t beginLevel, const uint16_t mergeLevel, con
     } else if (isRuleAL(incomingRule) || isRuleAH(incomingRule)) {
         if (mt == PUSH_UP) {
             // push-up all
-            std::vector<Edge> childEdges(2);
+            ChildEdges childEdges(2);
             bool child = (isRuleAL(incomingRule)) ? 0 : 1;
             childEdges[child].handle = makeTerminal(INT, (int)hasRuleTerminalOne(incomingRule));
             if (setting.getValType() == FLOAT || setting.getValType() == DOUBLE) {
@@ -837,10 +1253,10 @@ Edge Forest::mergeEdge(const uint16_t beginLevel, const uint16_t mergeLevel, con
             EdgeLabel locLabel = 0;
             packRule(locLabel, RULE_X);
             for (uint16_t k=mergeLevel+1; k<=beginLevel; k++) {
-                childEdges[!child] = mergeEdge(k-1, mergeLevel, locLabel, reduced);
+                childEdges[!child] = mergeEdgeKernel<K>(k-1, mergeLevel, locLabel, reduced);
                 childEdges[!child] = normalizeEdge(k-1, childEdges[!child]);
                 childEdges[child] = normalizeEdge(k-1, childEdges[child]);
-                merged = normalizeNode(k, childEdges);
+                merged = normalizeNodeKernel<K>(k, childEdges);
                 childEdges[child] = merged;
             }
         } else if (mt == PUSH_DOWN) {
@@ -851,7 +1267,7 @@ Edge Forest::mergeEdge(const uint16_t beginLevel, const uint16_t mergeLevel, con
     } else if (isRuleI(incomingRule) && (reducedRule == RULE_X)) {
         if ((mt == PUSH_UP) || (mt == SHORTEN_I)) {
             // push-up one
-            std::vector<Edge> childEdges(4);
+            ChildEdges childEdges(4);
             childEdges[0] = reduced;
             childEdges[3] = reduced;
             childEdges[1].handle = makeTerminal(INT, (int)hasRuleTerminalOne(incomingRule));
@@ -863,22 +1279,23 @@ Edge Forest::mergeEdge(const uint16_t beginLevel, const uint16_t mergeLevel, con
             for (size_t i=0; i<childEdges.size(); i++) {
                 childEdges[i] = normalizeEdge(mergeLevel, childEdges[i]);
             }
-            merged = normalizeNode(mergeLevel+1, childEdges);
+            merged = normalizeNodeKernel<K>(mergeLevel+1, childEdges);
             merged.setRule((incomingSkip == 1) ? RULE_X : incomingRule);
         } else if ((mt == PUSH_DOWN) || (mt == SHORTEN_X)) {
             // push-down one
-            std::vector<Edge> childEdges(4);
+            ChildEdges childEdges(4);
             for (size_t i=0; i<childEdges.size(); i++) {
                 childEdges[i] = reduced;
             }
-            merged = normalizeNode(mergeLevel, childEdges);
+            merged = normalizeNodeKernel<K>(mergeLevel, childEdges);
             merged.setRule(incomingRule);
         }
     }
     return merged;
 }
 
-Edge Forest::reduceEdge(const uint16_t beginLevel, const EdgeLabel label, const uint16_t nodeLevel, const std::vector<Edge>& down, const Value& value)
+template <class K>
+Edge Forest::reduceEdgeKernel(const uint16_t beginLevel, const EdgeLabel label, const uint16_t nodeLevel, const ChildEdges& down, const Value& value)
 {
     /* check level */
     if (beginLevel < nodeLevel) {
@@ -886,12 +1303,12 @@ Edge Forest::reduceEdge(const uint16_t beginLevel, const EdgeLabel label, const
         exit(0);
     }
     /* check number of child */
-    if ((setting.isRelation() && down.size() != 4) || (!setting.isRelation() && down.size() != 2)) {
+    if ((K::isRelation(setting) && down.size() != 4) || (!K::isRelation(setting) && down.size() != 2)) {
         std::cout << "[REXBDD] ERROR!\t Incorrect number of child edges!" << std::endl;
         exit(0);
     }
     /* copy the children info */
-    std::vector<Edge> child = down;
+    ChildEdges child = down;
 #ifdef BRAVE_DD_TRACE
     std::cout << "reduce edge; beginlvl: "<< beginLevel << "; nodelvl: " << nodeLevel << std::endl;
     child[0].print(std::cout);
@@ -900,12 +1317,12 @@ Edge Forest::reduceEdge(const uint16_t beginLevel, const EdgeLabel label, const
     std::cout << std::endl;
 #endif
     /* push the flags or value down */
-    CompSet ct = setting.getCompType();
+    CompSet ct = K::compType(setting);
     if (ct == COMP && unpackComp(label)) {                          // complement
         for (size_t i=0; i<child.size(); i++) child[i].complement();
     }
-    SwapSet st = setting.getSwapType();
-    if (!setting.isRelation() && unpackSwap(label)) {           // set: swap-one or swap-all
+    SwapSet st = K::swapType(setting);
+    if (!K::isRelation(setting) && unpackSwap(label)) {           // set: swap-one or swap-all
         if (st == ONE) {                                            // swap-one
             SWAP(child[0], child[1]);
         } else if (st == ALL) {                                     // swap-all
@@ -913,7 +1330,7 @@ Edge Forest::reduceEdge(const uint16_t beginLevel, const EdgeLabel label, const
             child[0].swap();
             child[1].swap();
         }
-    } else if (setting.isRelation()) {                          // relation: swap-from, swap-to, swap-from_to
+    } else if (K::isRelation(setting)) {                          // relation: swap-from, swap-to, swap-from_to
         if ((st == FROM || st == FROM_TO) && unpackSwap(label)) {   // swap "from"
             SWAP(child[0], child[2]);
             SWAP(child[1], child[3]);
@@ -926,7 +1343,7 @@ Edge Forest::reduceEdge(const uint16_t beginLevel, const EdgeLabel label, const
     }
     /* reduce node */
     Edge reduced;
-    reduced = reduceNode(nodeLevel, child);    // this will take care of value on edge
+    reduced = reduceNodeKernel<K>(nodeLevel, child);    // this will take care of value on edge
 #ifdef BRAVE_DD_TRACE
     std::cout << "after reduce node:" << std::endl;
     reduced.print(std::cout);
@@ -936,10 +1353,10 @@ Edge Forest::reduceEdge(const uint16_t beginLevel, const EdgeLabel label, const
     EdgeLabel mergeLabel = 0;
     packRule(mergeLabel, unpackRule(label));
     /* merge incoming edge with reduced node */
-    if (setting.getEncodeMechanism() == TERMINAL) {
-        reduced = mergeEdge(beginLevel, nodeLevel, mergeLabel, reduced);
+    if (K::isTerminal(setting)) {
+        reduced = mergeEdgeKernel<K>(beginLevel, nodeLevel, mergeLabel, reduced);
     } else {
-        reduced = mergeEdge(beginLevel, nodeLevel, mergeLabel, reduced, value);
+        reduced = mergeEdgeKernel<K>(beginLevel, nodeLevel, mergeLabel, reduced, value);
     }
 #ifdef BRAVE_DD_TRACE
     std::cout << "after merge edge:" << std::endl;
@@ -976,86 +1393,144 @@ Edge Forest::unreduceEdge(const uint16_t level, const Edge& edge)
     return ans;
 }
 
-Edge Forest::buildHalf(const uint16_t beginLvl, const uint16_t endLvl, const Edge& e1, const Edge& e2, const bool isLow)
+template <class K>
+Edge Forest::buildHalfKernel(const uint16_t beginLvl, const uint16_t endLvl, const Edge& e1, const Edge& e2, const bool isLow)
 {
     Edge ans;
     EdgeLabel root = 0;
     /* Base case that can directly call reduce edge*/
     if (beginLvl == endLvl) {
-        std::vector<Edge> child(2);
+        ChildEdges child(2);
         child[0] = e1;
         child[1] = e2;
         packRule(root, RULE_X);
-        return reduceEdge(beginLvl, root, endLvl, child);
+        return reduceEdgeKernel<K>(beginLvl, root, endLvl, child);
     }
     /* Base cases that can directly return a long edge */
     if (e1 == e2) {
-        if (e1.getRule() == RULE_X) return e1;
         // constant long edge, in case X is not allowed
         if (e1.getNodeLevel() == 0) {
             bool isOne = isTerminalOne(e1.getEdgeHandle());
             bool isZero = isTerminalZero(e1.getEdgeHandle());
-            if ((hasRuleTerminalOne(e1.getRule()) == (e1.getComp() ^ isOne)) && (isOne || isZero)) {
+            if ((e1.getRule() != RULE_X) && (hasRuleTerminalOne(e1.getRule()) == (e1.getComp() ^ isOne)) && (isOne || isZero)) {
                 return e1;
             }
-        } else {
-            std::vector<Edge> child(2);
-            child[0] = e1;
-            child[1] = e2;
-            packRule(root, RULE_X);
-            return reduceEdge(beginLvl, root, endLvl, child);
         }
+        return liftEdgeKernel<K>(endLvl-1, beginLvl, e1);
     }
-    if (isLow) {
-        // low pattern
-        if (e1.isConstantZero() || e1.isConstantOne()) {
-            ReductionRule incomingRule = e1.isConstantZero() ? RULE_EL0 : RULE_EL1;
-            packRule(root, incomingRule);
-            ans = mergeEdge(beginLvl, endLvl-1, root, e2);
-            ans = normalizeEdge(beginLvl, ans);
-            return ans;
-        }
-        if (e2.isConstantZero() || e2.isConstantOne()) {
-            ReductionRule incomingRule = e2.isConstantZero() ? RULE_AH0 : RULE_AH1;
-            packRule(root, incomingRule);
-            ans = mergeEdge(beginLvl, endLvl-1, root, e1);
-            ans = normalizeEdge(beginLvl, ans);
-            return ans;
-        }
-    } else {
-        // high pattern
-        if (e2.isConstantZero() || e2.isConstantOne()) {
-            ReductionRule incomingRule = e2.isConstantZero() ? RULE_EH0 : RULE_EH1;
-            packRule(root, incomingRule);
-            ans = mergeEdge(beginLvl, endLvl-1, root, e1);
-            ans = normalizeEdge(beginLvl, ans);
-            return ans;
-        }
-        if (e1.isConstantZero() || e1.isConstantOne()) {
-            ReductionRule incomingRule = e1.isConstantZero() ? RULE_AL0 : RULE_AL1;
-            packRule(root, incomingRule);
-            ans = mergeEdge(beginLvl, endLvl-1, root, e2);
-            ans = normalizeEdge(beginLvl, ans);
-            return ans;
-        }
+    /* A constant can be merged onto the other edge as the incoming rule, if the forest has
+     * that rule, and pushes nodes up or the other edge is short: otherwise the pattern is built below */
+    bool isMerge1 = (K::mergeType(setting) != NO_MERGE)
+                    || ((e1.getRule() == RULE_X) && (e1.getNodeLevel() == endLvl-1) && (endLvl > 1));
+    bool isMerge2 = (K::mergeType(setting) != NO_MERGE)
+                    || ((e2.getRule() == RULE_X) && (e2.getNodeLevel() == endLvl-1) && (endLvl > 1));
+    bool isConst1 = e1.isConstantZero() || e1.isConstantOne();
+    bool isConst2 = e2.isConstantZero() || e2.isConstantOne();
+    // low pattern: EL for constant e1, AH for constant e2; high pattern: EH for constant e2, AL for constant e1
+    ReductionRule rule1 = (isLow) ? (e1.isConstantZero() ? RULE_EL0 : RULE_EL1) : (e1.isConstantZero() ? RULE_AL0 : RULE_AL1);
+    ReductionRule rule2 = (isLow) ? (e2.isConstantZero() ? RULE_AH0 : RULE_AH1) : (e2.isConstantZero() ? RULE_EH0 : RULE_EH1);
+    bool isRule1 = isConst1 && isMerge2 && K::hasRule(setting, rule1);
+    bool isRule2 = isConst2 && isMerge1 && K::hasRule(setting, rule2);
+    // EL or EH is preferred over AH or AL
+    if (isRule1 && (isLow || !isRule2)) {
+        packRule(root, rule1);
+        ans = mergeEdgeKernel<K>(beginLvl, endLvl-1, root, e2);
+        ans = normalizeEdge(beginLvl, ans);
+        return ans;
+    }
+    if (isRule2) {
+        packRule(root, rule2);
+        ans = mergeEdgeKernel<K>(beginLvl, endLvl-1, root, e1);
+        ans = normalizeEdge(beginLvl, ans);
+        return ans;
     }
     /* Now we need to build this pattern */
-    std::vector<Edge> child(2);
+    ChildEdges child(2);
     packRule(root, RULE_X);
     ans = isLow?e2:e1; 
+    Edge side = isLow?e1:e2;
     for (uint16_t i=endLvl; i<=beginLvl; i++) {
-        child[0] = isLow ? mergeEdge(i-1, endLvl-1, root, e1) : ans;
-        child[1] = isLow ? ans : mergeEdge(i-1, endLvl-1, root, e2);
-        ans = reduceEdge(i, root, i, child);
+        if (i > endLvl) side = liftEdgeKernel<K>(i-2, i-1, side);
+        child[0] = isLow ? side : ans;
+        child[1] = isLow ? ans : side;
+        ans = reduceEdgeKernel<K>(i, root, i, child);
+    }
+    return ans;
+}
+
+template <class K>
+Edge Forest::liftEdgeKernel(const uint16_t from, const uint16_t to, const Edge& edge)
+{
+    // an X edge is independent of the levels it skips
+    if ((from >= to) || ((edge.getRule() == RULE_X) && K::hasRule(setting, RULE_X))) return edge;
+    EdgeLabel root = 0;
+    packRule(root, RULE_X);
+    Edge ans = edge;
+    ChildEdges child(2);
+    for (uint16_t k=from+1; k<=to; k++) {
+        child[0] = ans;
+        child[1] = ans;
+        ans = reduceEdgeKernel<K>(k, root, k, child);
     }
     return ans;
 }
 
+template <class K>
+void Forest::useKernel()
+{
+    reduceEdgeFn = &Forest::reduceEdgeKernel<K>;
+    reduceNodeFn = &Forest::reduceNodeKernel<K>;
+    normalizeNodeFn = &Forest::normalizeNodeKernel<K>;
+    mergeEdgeFn = &Forest::mergeEdgeKernel<K>;
+    buildHalfFn = &Forest::buildHalfKernel<K>;
+    liftEdgeFn = &Forest::liftEdgeKernel<K>;
+}
+
+void Forest::selectKernel()
+{
+    isPredefKernel = 1;
+    if (PredefKernel<PredefForest::REXBDD>::matches(setting)) {
+        useKernel<PredefKernel<PredefForest::REXBDD> >();
+        kernelType = PredefForest::REXBDD;
+    } else if (PredefKernel<PredefForest::QBDD>::matches(setting)) {
+        useKernel<PredefKernel<PredefForest::QBDD> >();
+        kernelType = PredefForest::QBDD;
+    } else if (PredefKernel<PredefForest::FBDD>::matches(setting)) {
+        useKernel<PredefKernel<PredefForest::FBDD> >();
+        kernelType = PredefForest::FBDD;
+    } else if (PredefKernel<PredefForest::ZBDD>::matches(setting)) {
+        useKernel<PredefKernel<PredefForest::ZBDD> >();
+        kernelType = PredefForest::ZBDD;
+    } else if (PredefKernel<PredefForest::ESRBDD>::matches(setting)) {
+        useKernel<PredefKernel<PredefForest::ESRBDD> >();
+        kernelType = PredefForest::ESRBDD;
+    } else if (PredefKernel<PredefForest::FBMXD>::matches(setting)) {
+        useKernel<PredefKernel<PredefForest::FBMXD> >();
+        kernelType = PredefForest::FBMXD;
+    } else if (PredefKernel<PredefForest::IBMXD>::matches(setting)) {
+        useKernel<PredefKernel<PredefForest::IBMXD> >();
+        kernelType = PredefForest::IBMXD;
+    } else if (PredefKernel<PredefForest::ESRBMXD>::matches(setting)) {
+        useKernel<PredefKernel<PredefForest::ESRBMXD> >();
+        kernelType = PredefForest::ESRBMXD;
+    } else {
+        // user-defined forest
+        isPredefKernel = 0;
+        useKernel<SettingKernel>();
+    }
+}
+
+void Forest::useSettingKernel()
+{
+    isPredefKernel = 0;
+    useKernel<SettingKernel>();
+}
+
 Edge Forest::buildUmb(const uint16_t beginLvl, const uint16_t endLvl, const Edge& e1, const Edge& e2, const Edge& e3)
 {
     Edge ans;
     EdgeLabel root = 0;
-    std::vector<Edge> child(2);
+    ChildEdges child(2);
     packRule(root, RULE_X);
     child[0] = buildHalf(beginLvl-1, endLvl, e1, e2, 0);
     child[1] = buildHalf(beginLvl-1, endLvl, e2, e3, 1);
@@ -1063,15 +1538,337 @@ Edge Forest::buildUmb(const uint16_t beginLvl, const uint16_t endLvl, const Edge
     return ans;
 }
 
+void Forest::markSweep()
+{
+    auto start = std::chrono::steady_clock::now();
+    uint64_t before = getCurrentNodes();
+    reclaim();
+    uint64_t after = getCurrentNodes();
+    nextGC = (2 * after > setting.getGCThreshold()) ? 2 * after : setting.getGCThreshold();
+    std::chrono::duration<double> pause = std::chrono::steady_clock::now() - start;
+    stats->recordGC(before - after, pause.count());
+}
+
+void Forest::reclaim()
+{
+    /* Nodes are only added between collections: the peak is now */
+    stats->notePeak(getCurrentNodes());
+    /* Mark the nodes reachable from any Func */
+    markAllFuncs();
+    /* Cached results on unmarked nodes become invalid */
+    for (size_t i=0; i<caches.size(); i++) {
+        caches[i]->sweep(this);
+    }
+    /* Unique table first, since the node manager sweep clears the marks */
+    uniqueTable->sweep();
+    nodeMan->sweep();
+}
+
+void Forest::unregisterCache(ComputeTable* ct)
+{
+    for (size_t i=0; i<caches.size(); i++) {
+        if (caches[i] == ct) {
+            caches[i] = caches.back();
+            caches.pop_back();
+            return;
+        }
+    }
+}
+
 void Forest::markNodes(const Edge& edge) const
 {
+    markNodes(std::vector<Edge>(1, edge));
+}
+
+uint64_t Forest::markNodes(const std::vector<Edge>& roots, uint64_t* perLevel,
+                           std::vector<std::vector<NodeHandle> >* reached) const
+{
+    uint16_t numVars = setting.getNumVars();
+    bool isRel = setting.isRelation();
+    char numChild = (isRel) ? 4 : 2;
+    /* Newly marked nodes, queued by level */
+    std::vector<std::vector<NodeHandle> > queues(numVars+1);
+    if (reached) reached->assign(numVars+1, std::vector<NodeHandle>());
+    for (size_t i=0; i<roots.size(); i++) {
+        uint16_t lvl = roots[i].getNodeLevel();
+        if ((lvl > 0) && !getNode(roots[i]).isMarked()) {
+            getNode(roots[i]).mark();
+            queues[lvl].push_back(roots[i].getNodeHandle());
+        }
+    }
+    /* Children are below their parents, so a level is complete when it is reached */
+    uint64_t num = 0;
+    for (uint16_t lvl=numVars; lvl>0; lvl--) {
+        std::vector<NodeHandle>& queue = queues[lvl];
+        std::sort(queue.begin(), queue.end());
+        for (size_t i=0; i<queue.size(); i++) {
+            NodeView view = getNodeView(lvl, queue[i]);
+            for (char c=0; c<numChild; c++) {
+                if (view.isChildTerminal(c)) continue;
+                uint16_t childLvl = view.childLevel(c);
+                NodeHandle handle = view.childHandle(c);
+                Node child = getNode(childLvl, handle);
+                if (child.isMarked()) continue;
+                child.mark();
+                queues[childLvl].push_back(handle);
+            }
+        }
+        num += queue.size();
+        if (perLevel) perLevel[lvl] += queue.size();
+        if (reached) {
+            (*reached)[lvl].swap(queue);
+        } else {
+            std::vector<NodeHandle>().swap(queue);
+        }
+    }
+    return num;
+}
+
+/*************************** Reordering *************************/
+void Forest::shiftUp(unsigned lvl)
+{
+    if ((lvl < 1) || (lvl >= setting.getNumVars())) {
+        std::cout << "[REXBDD] ERROR!\t Forest::shiftUp(): invalid level " << lvl << std::endl;
+        exit(0);
+    }
+    swapLevels(lvl);
+}
+
+void Forest::shiftDown(unsigned lvl)
+{
+    if ((lvl <= 1) || (lvl > setting.getNumVars())) {
+        std::cout << "[REXBDD] ERROR!\t Forest::shiftDown(): invalid level " << lvl << std::endl;
+        exit(0);
+    }
+    swapLevels(lvl-1);
+}
+
+void Forest::reorder(unsigned* level2Var)
+{
+    uint16_t numVars = setting.getNumVars();
+    std::vector<bool> isPlaced(numVars+1, 0);
+    for (uint16_t k=1; k<=numVars; k++) {
+        if ((level2Var[k] == 0) || (level2Var[k] > numVars) || isPlaced[level2Var[k]]) {
+            std::cout << "[REXBDD] ERROR!\t Forest::reorder(): the order is not a permutation at level " << k << std::endl;
+            exit(0);
+        }
+        isPlaced[level2Var[k]] = 1;
+    }
+    /* Bring the variables up to their levels, from the top; the levels above are done */
+    for (uint16_t k=numVars; k>1; k--) {
+        for (uint16_t lvl=setting.getLevel(level2Var[k]); lvl<k; lvl++) {
+            swapLevels(lvl);
+        }
+    }
+}
+
+void Forest::sift(const double seconds)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto isTimeUp = [&]() {
+        std::chrono::duration<double> spent = std::chrono::steady_clock::now() - start;
+        return (seconds > 0) && (spent.count() > seconds);
+    };
+    uint16_t numVars = setting.getNumVars();
+    /* Start from the live nodes only */
+    reclaim();
+    uint64_t before = getCurrentNodes();
+    /* Sift the variables of the most populated levels first */
+    std::vector<uint16_t> vars(numVars);
+    std::vector<uint32_t> numNodes(numVars+1, 0);
+    for (uint16_t k=1; k<=numVars; k++) {
+        vars[k-1] = setting.getVar(k);
+        numNodes[setting.getVar(k)] = getUTEntriesNum(k);
+    }
+    std::stable_sort(vars.begin(), vars.end(),
+                     [&](uint16_t a, uint16_t b) {return numNodes[a] > numNodes[b];});
+    for (size_t i=0; i<vars.size() && !isTimeUp(); i++) {
+        uint16_t lvl = setting.getLevel(vars[i]);
+        uint16_t bestLvl = lvl;
+        uint64_t best = getCurrentNodes();
+        /* To the nearer end first, then to the other end */
+        bool isDown = (lvl - 1 < numVars - lvl);
+        for (int pass=0; pass<2; pass++, isDown = !isDown) {
+            while (!isTimeUp() && (isDown ? (lvl > 1) : (lvl < numVars))) {
+                if (isDown) {
+                    swapLevels(--lvl);
+                } else {
+                    swapLevels(lvl++);
+                }
+                uint64_t size = getCurrentNodes();
+                if (size < best) {
+                    best = size;
+                    bestLvl = lvl;
+                }
+                if (size > MAX_SIFT_GROWTH * best) break;
+            }
+        }
+        /* Leave it at the best level */
+        while (lvl > bestLvl) swapLevels(--lvl);
+        while (lvl < bestLvl) swapLevels(lvl++);
+        /* The swaps leave the nodes no longer reached: the next variable starts from the live ones */
+        reclaim();
+    }
+    uint64_t after = getCurrentNodes();
+    nextReorder = (2 * after > FIRST_REORDER) ? 2 * after : FIRST_REORDER;
+    std::chrono::duration<double> spent = std::chrono::steady_clock::now() - start;
+    stats->recordReorder(before, after, spent.count());
+}
+
+void Forest::swapLevels(const uint16_t lvl)
+{
+    uint16_t numVars = setting.getNumVars();
     char numChild = (setting.isRelation()) ? 4 : 2;
-    if (edge.getNodeLevel() > 0) {
-        if (!getNode(edge).isMarked()) {
-            getNode(edge).mark();
-            for (char i=0; i<numChild; i++) {
-                markNodes(getChildEdge(edge.getNodeLevel(), edge.getNodeHandle(), i));
+    LevelSwap swap;
+    swap.k = lvl;
+    swap.inPlace.resize(numVars+1);
+    swap.replaced.resize(numVars+1);
+    swap.memo.resize(numVars+1);
+    /* The nodes of both levels leave the unique tables, but are read until the end */
+    std::vector<NodeHandle> lower(getUTEntriesNum(lvl)), upper(getUTEntriesNum(lvl+1));
+    uniqueTable->getItems(lvl, lower.data(), lower.size());
+    uniqueTable->getItems(lvl+1, upper.data(), upper.size());
+    uniqueTable->clear(lvl);
+    uniqueTable->clear(lvl+1);
+    /* Exchange the two levels of cofactors of each node at lvl+1: grand[a] is the cofactor for (lvl+1, lvl) = (a, b) */
+    EdgeLabel root = 0;
+    packRule(root, RULE_X);
+    for (size_t i=0; i<upper.size(); i++) {
+        NodeView view = getNodeView(lvl+1, upper[i]);
+        ChildEdges child(numChild), grand(numChild);
+        for (char b=0; b<numChild; b++) {
+            for (char a=0; a<numChild; a++) grand[a] = cofact(lvl, view[a], b);
+            child[b] = reduceEdge(lvl, root, lvl, grand);
+        }
+        swapNode(lvl+1, upper[i], child, swap);
+    }
+    /* The levels above, bottom up: only the nodes with a changed edge */
+    for (uint16_t m=lvl+2; m<=numVars; m++) {
+        std::vector<NodeHandle> items(getUTEntriesNum(m));
+        uniqueTable->getItems(m, items.data(), items.size());
+        for (size_t i=0; i<items.size(); i++) {
+            NodeView view = getNodeView(m, items[i]);
+            ChildEdges child(numChild);
+            bool isSame = 1;
+            for (char c=0; c<numChild; c++) {
+                child[c] = swapEdge(m-1, view[c], swap);
+                isSame &= (child[c].getEdgeHandle() == view[c].getEdgeHandle());
             }
+            if (isSame) continue;
+            uniqueTable->remove(m, items[i]);
+            swapNode(m, items[i], child, swap);
         }
     }
-}
\ No newline at end of file
+    for (Func* f = funcs; f; f = f->nextFunc) {
+        f->edge = swapEdge(numVars, f->edge, swap);
+    }
+    /* Nothing refers to the old nodes of level lvl, nor to the replaced ones */
+    for (size_t i=0; i<lower.size(); i++) {
+        nodeMan->recycleNodeHandle(lvl, lower[i]);
+    }
+    std::unordered_map<NodeHandle, NodeHandle>::const_iterator moved;
+    for (moved = swap.moved.begin(); moved != swap.moved.end(); ++moved) {
+        nodeMan->recycleNodeHandle(lvl+1, moved->second);
+    }
+    for (uint16_t m=lvl+1; m<=numVars; m++) {
+        std::unordered_map<NodeHandle, ChildEdges>::const_iterator it;
+        for (it = swap.replaced[m].begin(); it != swap.replaced[m].end(); ++it) {
+            nodeMan->recycleNodeHandle(m, it->first);
+        }
+    }
+    setting.swapLevels(lvl);
+    /* Cached results may depend on the variables at the levels */
+    for (size_t i=0; i<caches.size(); i++) {
+        caches[i]->clear();
+    }
+}
+
+void Forest::swapNode(const uint16_t m, const NodeHandle handle, const ChildEdges& child, LevelSwap& swap)
+{
+    EdgeLabel root = 0;
+    packRule(root, RULE_X);
+    uint32_t before = getUTEntriesNum(m);
+    Edge ans = reduceEdge(m, root, m, child);
+    /* A new node with a plain edge: it takes the place of the old one, so the plain edges to it stay */
+    if ((getUTEntriesNum(m) > before) && (ans.getNodeLevel() == m) && (unpackLabel(ans.getEdgeHandle()) == root)) {
+        NodeHandle fresh = ans.getNodeHandle();
+        uniqueTable->remove(m, fresh);
+        /* The old cofactors of level k+1 are still needed for the edges with swap flags */
+        if (m == swap.k+1) {
+            Node old(nodeSize);
+            old.assign(getNode(m, handle), nodeSize);
+            swap.moved[handle] = nodeMan->getFreeNodeHandle(m, old);
+        }
+        getNode(m, handle).assign(getNode(m, fresh), nodeSize);
+        uniqueTable->add(m, handle);
+        nodeMan->recycleNodeHandle(m, fresh);
+        swap.inPlace[m].insert(handle);
+        return;
+    }
+    swap.replaced[m][handle] = child;
+}
+
+Edge Forest::swapEdge(const uint16_t lvl, const Edge& edge, LevelSwap& swap)
+{
+    uint16_t m = edge.getNodeLevel();
+    uint16_t k = swap.k;
+    if (m < k) return edge;
+    NodeHandle target = edge.getNodeHandle();
+    bool isSwapped = edge.getSwap(0) || edge.getSwap(1);
+    /* Edges into level k, or swapping the variable that leaves level k+1, go through the old cofactors */
+    bool isOld = (m == k) || ((m == k+1) && isSwapped);
+    std::unordered_map<NodeHandle, ChildEdges>::const_iterator down = swap.replaced[m].find(target);
+    if (!isOld && (down == swap.replaced[m].end())) {
+        /* A node rewritten in place may reduce differently under a rule or a swap flag */
+        bool isPlain = (edge.getRule() == RULE_X) && !isSwapped;
+        if (isPlain || !swap.inPlace[m].count(target)) return edge;
+    }
+    std::unordered_map<EdgeHandle, Edge>::iterator it = swap.memo[lvl].find(edge.getEdgeHandle());
+    if (it != swap.memo[lvl].end()) return it->second;
+    Edge from = edge;
+    std::unordered_map<NodeHandle, NodeHandle>::const_iterator moved = swap.moved.find(target);
+    if (isOld && (m == k+1) && (moved != swap.moved.end())) from.setNodeHandle(moved->second);
+    char numChild = (setting.isRelation()) ? 4 : 2;
+    ChildEdges child(numChild);
+    EdgeLabel root = 0;
+    packRule(root, RULE_X);
+    uint16_t base = (isOld) ? k+1 : m;
+    Edge ans;
+    if (lvl > base) {
+        /* Long edge: the redundant levels above stay redundant */
+        if (from.getRule() == RULE_X) {
+            ans = swapEdge(base, normalizeEdge(base, from), swap);
+            if (ans.getRule() == RULE_X) {
+                ans = normalizeEdge(lvl, ans);
+                swap.memo[lvl][edge.getEdgeHandle()] = ans;
+                return ans;
+            }
+        }
+        /* otherwise, expand the skipped levels; this recursion is as deep as the edge is long */
+        for (char i=0; i<numChild; i++) {
+            child[i] = swapEdge(lvl-1, cofact(lvl, from, i), swap);
+        }
+        ans = reduceEdge(lvl, root, lvl, child);
+    } else if (!isOld) {
+        /* Short edge to a changed node: its flags on the new children */
+        ans = reduceEdge(m, unpackLabel(edge.getEdgeHandle()), m,
+                         (down != swap.replaced[m].end()) ? down->second : getNodeView(m, target).children());
+    } else {
+        /* Exchange the two levels of cofactors: f[a][b] is the cofactor for (k+1, k) = (a, b) */
+        Edge f[4][4];
+        for (int a=0; a<numChild; a++) {
+            Edge fa = cofact(k+1, from, a);
+            for (int b=0; b<numChild; b++) {
+                f[a][b] = cofact(k, fa, b);
+            }
+        }
+        ChildEdges grand(numChild);
+        for (int b=0; b<numChild; b++) {
+            for (int a=0; a<numChild; a++) grand[a] = f[a][b];
+            child[b] = reduceEdge(k, root, k, grand);
+        }
+        ans = reduceEdge(k+1, root, k+1, child);
+    }
+    swap.memo[lvl][edge.getEdgeHandle()] = ans;
+    return ans;
+}
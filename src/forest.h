@@ -10,9 +10,15 @@
 #include "node_manager.h"
 #include "unique_table.h"
 #include "statistics.h"
+#include "bigint.h"
+#include "settings/kernels.h"
+
+#include <unordered_map>
+#include <unordered_set>
 
 namespace REXBDD {
     class Forest;
+    class ComputeTable;
 };
 
 // ******************************************************************
@@ -53,7 +59,7 @@ class REXBDD::Forest {
      * @param handle        The handle of the node.
      * @return Node         – Output the node stored in NodeManager.
      */
-    inline Node& getNode(const uint16_t level, const NodeHandle& handle) const {
+    inline Node getNode(const uint16_t level, const NodeHandle& handle) const {
         return nodeMan->getNodeFromHandle(level, handle);
     }
 
@@ -63,7 +69,7 @@ class REXBDD::Forest {
      * @param edge          The given incoming edge handle
      * @return Node         – Output the targer node stored in NodeManager.
      */
-    inline Node& getNode(const EdgeHandle& edge) const {
+    inline Node getNode(const EdgeHandle& edge) const {
         return getNode(unpackLevel(edge), unpackTarget(edge));
     }
     
@@ -73,7 +79,7 @@ class REXBDD::Forest {
      * @param edge          The given incoming edge.
      * @return Node         – Output the targer node stored in NodeManager.
      */
-    inline Node& getNode(const Edge& edge) const {
+    inline Node getNode(const Edge& edge) const {
         return getNode(edge.getNodeLevel(), edge.getNodeHandle());
     }
 
@@ -97,7 +103,7 @@ class REXBDD::Forest {
      * @param next          The next handle to be set.
      */
     inline void setNodeNext(const uint16_t level, const NodeHandle handle, const NodeHandle next) {
-        nodeMan->getNodeFromHandle(level, handle).setNext(next);
+        nodeMan->setNodeNext(level, handle, next);
     }
 
     /**
@@ -122,6 +128,16 @@ class REXBDD::Forest {
     inline NodeHandle obtainFreeNodeHandle(const uint16_t level, const Node& node) {
         return nodeMan->getFreeNodeHandle(level, node);
     }
+
+    /**
+     * @brief Give back a node handle from obtainFreeNodeHandle that was never stored in UniqueTable.
+     * 
+     * @param level         The level of the node.
+     * @param handle        The unused node handle.
+     */
+    inline void returnFreeNodeHandle(const uint16_t level, const NodeHandle handle) {
+        nodeMan->returnFreeNodeHandle(level, handle);
+    }
     
     /**
      * @brief Uniquely store a node and get its node handle by giving its level and itself.
@@ -175,7 +191,7 @@ class REXBDD::Forest {
         // the answer
         EdgeHandle ans = 0;
         // find the node
-        Node& node = getNode(level, handle);
+        Node node = getNode(level, handle);
         bool isRel = setting.isRelation();
         // fill edge rule
         packRule(ans, node.edgeRule(child,isRel));
@@ -183,7 +199,7 @@ class REXBDD::Forest {
         packComp(ans, node.edgeComp(child, isRel));
         // fill swap
         packSwap(ans, node.edgeSwap(child, 0, isRel));
-        packSwapTo(ans, node.edgeSwap(child, 1, isRel));
+        if (isRel) packSwapTo(ans, node.edgeSwap(child, 1, isRel));
         // fill level
         uint16_t childLvl = getChildLevel(level, handle, child);
         packLevel(ans, childLvl);
@@ -211,6 +227,19 @@ class REXBDD::Forest {
         return ans;
     }
 
+    /**
+     * @brief Get all the child edges of a node at once, decoded from one read of the node.
+     *
+     * @param level         The level of the node.
+     * @param handle        The node handle.
+     * @return NodeView     - Output the decoded child edges.
+     */
+    inline NodeView getNodeView(const uint16_t level, const NodeHandle handle) const {
+        ValueType valType = setting.getValType();
+        return NodeView(getNode(level, handle), level, setting.isRelation(), ruleSet != 0,
+                        (valType == INT || valType == LONG) ? INT_VALUE_FLAG_MASK : FLOAT_VALUE_FLAG_MASK);
+    }
+
     inline Edge getChildEdge(const uint16_t level, const NodeHandle handle, const char child) const {
         Edge ans;
         ans.handle = getChildEdgeHandle(level, handle, child);
@@ -239,7 +268,7 @@ class REXBDD::Forest {
         /* Node is already stored, assuming its terminal value is allowed */
         bool isRel = setting.isRelation();
         Value val(0);
-        Node& node = getNode(level, handle);
+        Node node = getNode(level, handle);
         NodeHandle data = node.childNodeHandle(child,isRel);
         if (node.isChildTerminalSpecial(child)) {
             // special value
@@ -292,6 +321,8 @@ class REXBDD::Forest {
         return res;
     }
 
+    /// Cofactor of an edge beginning at level "lvl"; K is the kernel of the caller, if it is bound to one
+    template <class K = SettingKernel>
     inline Edge cofact(const uint16_t lvl, const Edge& edge, const char index) {
         if (lvl == 0) return edge;
         if (lvl == edge.getNodeLevel()) {
@@ -300,33 +331,24 @@ class REXBDD::Forest {
                 // only for BDDs
                 childIndex = 1 - childIndex;
             }
-            Edge ans = getChildEdge(lvl, edge.getNodeHandle(), childIndex);
+            Edge ans = getNodeView(lvl, edge.getNodeHandle())[childIndex];
             if (edge.getComp()) ans.complement();
-            if ((setting.getSwapType() == ALL) && edge.getSwap(0)) ans.swap();
+            if ((K::swapType(setting) == ALL) && edge.getSwap(0)) ans.swap();
             return ans;
         }
         Edge ans;
-        ReductionRule rule = edge.getRule();
-        if ((isRuleEL(rule) && (index == 0)) || (isRuleEH(rule) && (index == 1))
-            || (isRuleAL(rule) && (lvl - edge.getNodeLevel() == 1) && (index == 0))
-            || (isRuleAH(rule) && (lvl - edge.getNodeLevel() == 1) && (index == 1))
-            || (isRuleI(rule) && ((index == 1) || (index == 2)))) {
-            EdgeHandle childH = makeTerminal(INT, (int)hasRuleTerminalOne(rule));
-            if (setting.getValType() == FLOAT) {
-                childH = makeTerminal(FLOAT, (float)hasRuleTerminalOne(rule));
-            }
-            packRule(childH, RULE_X);
-            ans.setEdgeHandle(childH);
-            ans = normalizeEdge(lvl-1, ans);
-            return ans;
-        }
-        ans = edge;
-        if ((lvl - edge.getNodeLevel()) == 1) {
+        // the rule decides, as tabulated at construction
+        uint8_t kind = cofactKind[edge.getRule()][(lvl - edge.getNodeLevel()) == 1][(int)index];
+        if (kind == COFACT_SHORT) {
+            ans = edge;
             ans.setRule(RULE_X);
             return ans;
         }
-        ans = normalizeEdge(lvl-1, ans);
-        return ans;
+        if (kind == COFACT_LONG) return normalizeEdge(lvl-1, edge);
+        // the terminal of the rule
+        ans.setEdgeHandle(terminals[kind]);
+        ans.setRule(RULE_X);
+        return normalizeEdge(lvl-1, ans);
     }
 
     /************************* Reduction ****************************/
@@ -337,11 +359,13 @@ class REXBDD::Forest {
      * @param beginLevel    The beginning level of the unreduced incoming edge.
      * @param label         The unreduced incoming edge label.
      * @param nodeLevel     The level of the unreduced target node.
-     * @param down          The vector of child edges of the unreduced target node.
+     * @param down          The child edges of the unreduced target node.
      * @param value         [Optional] The value attached on the incoming edge.
      * @return Edge         - Output: the reduced edge pointing to a reduced node uniquely stored.
      */
-    Edge reduceEdge(const uint16_t beginLevel, const EdgeLabel label, const uint16_t nodeLevel, const std::vector<Edge>& down, const Value& value = Value());
+    inline Edge reduceEdge(const uint16_t beginLevel, const EdgeLabel label, const uint16_t nodeLevel, const ChildEdges& down, const Value& value = Value()) {
+        return (this->*reduceEdgeFn)(beginLevel, label, nodeLevel, down, value);
+    }
 
 
 
@@ -367,21 +391,28 @@ class REXBDD::Forest {
      * the forest.
      * 
      */
-    inline void markAllFuncs() const {
-        // TBD
-    }
+    inline void markAllFuncs() const {markNodes(funcRoots());}
 
     /***************************** Cardinality **********************/
     uint64_t countNodes();   // all Funcs
-    uint64_t countNodes(FuncArray funcs);
+    uint64_t countNodes(FuncArray funcArray);
     uint64_t countNodesAtLevel(uint16_t lvl);
     uint64_t countNodesAtLevel(uint16_t lvl, Func func);
-    uint64_t countNodesAtLevel(uint16_t lvl, FuncArray funcs);
+    uint64_t countNodesAtLevel(uint16_t lvl, FuncArray funcArray);
 
     uint64_t mass(Func func);
 
-    uint64_t count(Func func, int val); // ...
-    // mpz_t count(); // gmp here?
+    /**
+     * @brief Number of assignments for which the Func has the value "val", counted
+     * bottom-up once per reachable node (for both complement flags), with the long
+     * edges counted by their rules. Exact if it is below 2^64, modulo 2^64 otherwise.
+     * Note: only "set" forests with the terminal encoding are supported.
+     */
+    uint64_t count(Func func, int val);
+    /// Same as count(), as the base-2 logarithm (-infinity for none), for any number of variables
+    double countLog2(Func func, int val);
+    /// Same as count(), exactly
+    BigInt countExact(Func func, int val);
     uint64_t count(Func func, long min, long max); // min and max are both included
     uint64_t count(Func func, double min, double max); // min and max are both included
     uint64_t count(Func func, SpecialValue val);
@@ -392,8 +423,31 @@ class REXBDD::Forest {
     /************************* Garbage Collection *******************/
     void deleteNode(NodeHandle handle);
     inline void sweepNodeMan(uint16_t level) {nodeMan->sweep(level);}
+    /**
+     * @brief Reclaim the nodes that are not reachable from any Func of this forest:
+     * mark from all the Funcs, remove the compute table entries on unmarked nodes,
+     * then sweep the unique table and the node manager.
+     * Note: edges that are not held by a Func are not kept alive.
+     */
     void markSweep();
-    // TBD
+    /**
+     * @brief Run markSweep if the live nodes reached the trigger: the GC threshold of
+     * the setting, or twice the nodes that survived the last collection if larger.
+     * Operations call this when they finish.
+     */
+    inline void autoMarkSweep() {
+        if (setting.getGCThreshold() && (getCurrentNodes() >= nextGC)) markSweep();
+    }
+    /**
+     * @brief Run sifting, within the reordering time of the setting, if dynamic reordering is on
+     * and the live nodes doubled since the last reordering. Operations call this when they finish.
+     */
+    inline void autoReorder() {
+        if ((setting.getReorderTime() > 0) && (getCurrentNodes() >= nextReorder)) sift(setting.getReorderTime());
+    }
+    /// Register a compute table holding edges of this forest, so markSweep sweeps it
+    inline void registerCache(ComputeTable* ct) {caches.push_back(ct);}
+    void unregisterCache(ComputeTable* ct);
 
     /************************* Statistics Information ***************/
     inline uint32_t getNodeManUsed(const uint16_t level) const {
@@ -405,18 +459,55 @@ class REXBDD::Forest {
     inline uint32_t getUTEntriesNum(const uint16_t level) const {
         return uniqueTable->getNumEntries(level);
     }
-    uint64_t getPeakNodes();    // largest result of getCurrentNodes(), since the last call to resetPeakNodes()
-    uint64_t getCurrentNodes(); // number of nodes in UT, including disconnected
-    void resetPeakNodes();
+    inline uint64_t getCurrentNodes() const {   // number of nodes in UT, including disconnected
+        return uniqueTable->getNumEntries();
+    }
+    /// Largest result of getCurrentNodes(), since the last call to resetPeakNodes()
+    inline uint64_t getPeakNodes() const {
+        uint64_t current = getCurrentNodes();
+        return (current > stats->getPeakNodes()) ? current : stats->getPeakNodes();
+    }
+    inline void resetPeakNodes() {stats->resetPeakNodes(getCurrentNodes());}
+    inline const Statistics& getStatistics() const {return *stats;}
+    /// Copy of the statistics, with the counters of all workers added up
+    inline StatsSnapshot getStatsSnapshot() const {return stats->snapshot(getCurrentNodes());}
     // TBD
 
     /****************************** I/O *****************************/
-    // for transform files
+    /*
+     * Binary format, in the byte order of the writing machine (a reader with the other
+     * byte order fails on the magic number):
+     *  - magic number "RXBD" and format version;
+     *  - the forest setting: number of variables, dimension, encoding, value type, swap
+     *    and complement flags, reduction rules, maximal range, and the variable order;
+     *  - for each level from 1 up: the number of nodes, then their child edge handles;
+     *    a child edge to a node stores the index of that node within its level instead
+     *    of its node handle, and terminal edges are stored as they are;
+     *  - the number of Funcs, then for each Func its root edge handle (same remapping)
+     *    and its name.
+     * Only the nodes reachable from the written Funcs are stored.
+     */
+    /**
+     * @brief Write the given Funcs of this forest, with the nodes reachable from them.
+     * Note: only the terminal encoding is supported for now.
+     */
     void exportFunc(std::ostream& out, FuncArray func);
+    /// Write all the Funcs of this forest
     void exportForest(std::ostream& out);
+    /**
+     * @brief Read Funcs written by exportFunc or exportForest. The setting in the file
+     * must match the one of this forest, including the variable order; the nodes are
+     * rebuilt bottom-up through the unique table, in a single pass over the file.
+     */
     FuncArray importFunc(std::istream& in);
+    /**
+     * @brief Read Funcs like importFunc, and keep them in this forest (replacing the
+     * ones kept by a previous call), so they stay alive until the forest goes away.
+     */
     void importForest(std::istream& in);
-    
+    /// The Funcs kept by the last importForest; null if none
+    inline const FuncArray* getImportedFuncs() const {return funcSets;}
+
     // TBD
 
 
@@ -426,11 +517,37 @@ class REXBDD::Forest {
      */
     inline const ForestSetting& getSetting() const {return setting;}
     inline void exportSetting(std::ostream out, int format) const {setting.output(out, format);}
+    /// Check if the reduction uses the kernels specialized for a predefined forest, or reads the setting
+    inline bool hasPredefKernel() const {return isPredefKernel;}
+    /// Read the setting in the reduction and the operations even if it is a predefined forest: the same
+    /// nodes, built without the specialized kernels. Meant for comparing the kernels, before any node is built
+    void useSettingKernel();
 
     /*************************** Reordering *************************/
+    /**
+     * @brief Move the variable at the given level up by one level, exchanging it with the
+     * variable above. The Funcs of this forest are rebuilt for the new order, and the nodes
+     * they no longer use are reclaimed; the compute tables are cleared.
+     * Note: edges that are not held by a Func are not rebuilt.
+     * 
+     * @param lvl           The level, below the top level.
+     */
     void shiftUp(unsigned lvl);
+    /// Move the variable at the given level, above level 1, down by one level
     void shiftDown(unsigned lvl);
+    /**
+     * @brief Reorder the variables by adjacent level exchanges.
+     * 
+     * @param level2Var     The variable at each level 1 ... numVars; level2Var[0] is not used.
+     */
     void reorder(unsigned* level2Var);
+    /**
+     * @brief Reorder the variables by sifting: each variable, from the most populated level,
+     * is moved through all the levels and left where the forest is the smallest.
+     * 
+     * @param seconds       The time limit; 0 for no limit.
+     */
+    void sift(const double seconds = 0);
 
     /*-------------------------------------------------------------*/
     private:
@@ -447,10 +564,12 @@ class REXBDD::Forest {
      * @brief Normalize a node to ensure canonicity.
      * 
      * @param nodeLevel     The given node level.
-     * @param down          The vector of child edges of the node.
+     * @param down          The child edges of the node.
      * @param out           Output: edge label (rule/value, flags).
      */
-    Edge normalizeNode(const uint16_t nodeLevel, const std::vector<Edge>& down);
+    inline Edge normalizeNode(const uint16_t nodeLevel, const ChildEdges& down) {
+        return (this->*normalizeNodeFn)(nodeLevel, down);
+    }
 
     /**
      * @brief Normalize a long edge to be legal for this forest setting. If the reduction rule
@@ -461,15 +580,24 @@ class REXBDD::Forest {
      * @return Edge         Output: normalized edge.
      */
     Edge normalizeEdge(const uint16_t level, const Edge& edge);
+    /**
+     * @brief The label part of normalizeEdge: the rule, flags and terminal of the normalized
+     * edge, where its rule may still not be allowed. No node is built.
+     */
+    Edge normalizeLabel(const uint16_t level, const Edge& edge) const;
+    /// Build the rule-transition tables from the setting, by normalizeLabel on each label
+    void buildRuleTables();
     
     /**
      * @brief Reduce a node assuming the incoming edge is a short edge with 0 edge value.
      * 
      * @param nodeLevel     The level of the unreduced node.
-     * @param down          The vector of child edges of the unreduced node.
+     * @param down          The child edges of the unreduced node.
      * @return Edge         - Output: reduced edge.
      */
-    Edge reduceNode(const uint16_t nodeLevel, const std::vector<Edge>& down);
+    inline Edge reduceNode(const uint16_t nodeLevel, const ChildEdges& down) {
+        return (this->*reduceNodeFn)(nodeLevel, down);
+    }
 
     /**
      * @brief Merge the incoming edge having EdgeLabel "label", which is respect of 
@@ -484,7 +612,9 @@ class REXBDD::Forest {
      * @param value         [Optional] The value attached on the incoming edge.
      * @return Edge         - Output: merged edge (label, target node handle).
      */
-    Edge mergeEdge(const uint16_t beginLevel, const uint16_t mergeLevel, const EdgeLabel label, const Edge& reduced, const Value& value = Value());
+    inline Edge mergeEdge(const uint16_t beginLevel, const uint16_t mergeLevel, const EdgeLabel label, const Edge& reduced, const Value& value = Value()) {
+        return (this->*mergeEdgeFn)(beginLevel, mergeLevel, label, reduced, value);
+    }
 
     /**
      * @brief Check if the swap-all bit is useless, by giving the parent forest and edge
@@ -499,11 +629,138 @@ class REXBDD::Forest {
 
     // these are only used by BDDs operations
 
-    Edge buildHalf(const uint16_t beginLvl, const uint16_t endLvl, const Edge& e1, const Edge& e2, const bool isLow);
+    inline Edge buildHalf(const uint16_t beginLvl, const uint16_t endLvl, const Edge& e1, const Edge& e2, const bool isLow) {
+        return (this->*buildHalfFn)(beginLvl, endLvl, e1, e2, isLow);
+    }
+    /// The edge beginning at level "to" for the function of "edge" beginning at level "from" (independent of the levels between)
+    inline Edge liftEdge(const uint16_t from, const uint16_t to, const Edge& edge) {
+        return (this->*liftEdgeFn)(from, to, edge);
+    }
     Edge buildUmb(const uint16_t beginLvl, const uint16_t endLvl, const Edge& e1, const Edge& e2, const Edge& e3);
 
+    /* Kernels: the methods above for the specification "K" of this forest (see settings/kernels.h),
+     * where a call within a kernel is bound to the same kernel */
+    template <class K>
+    Edge reduceEdgeKernel(const uint16_t beginLevel, const EdgeLabel label, const uint16_t nodeLevel, const ChildEdges& down, const Value& value = Value());
+    template <class K>
+    Edge reduceNodeKernel(const uint16_t nodeLevel, const ChildEdges& down);
+    template <class K>
+    Edge normalizeNodeKernel(const uint16_t nodeLevel, const ChildEdges& down);
+    template <class K>
+    Edge mergeEdgeKernel(const uint16_t beginLevel, const uint16_t mergeLevel, const EdgeLabel label, const Edge& reduced, const Value& value = Value());
+    template <class K>
+    Edge buildHalfKernel(const uint16_t beginLvl, const uint16_t endLvl, const Edge& e1, const Edge& e2, const bool isLow);
+    template <class K>
+    Edge liftEdgeKernel(const uint16_t from, const uint16_t to, const Edge& edge);
+    /// Point the reduction methods to the kernels of K
+    template <class K>
+    void useKernel();
+    /// Select the kernels at construction: the predefined forest whose specification is the setting, if any
+    void selectKernel();
+    /**
+     * @brief The instance "S::template of<K>()" of a method template over the kernels K of this
+     * forest, for the operations that bind their recursion to the same kernels as the reduction.
+     * S gives the type "Fn" of the instances.
+     */
+    template <class S>
+    inline typename S::Fn kernelOf() const {
+        if (isPredefKernel) {
+            switch (kernelType) {
+                case PredefForest::REXBDD:  return S::template of<PredefKernel<PredefForest::REXBDD> >();
+                case PredefForest::QBDD:    return S::template of<PredefKernel<PredefForest::QBDD> >();
+                case PredefForest::FBDD:    return S::template of<PredefKernel<PredefForest::FBDD> >();
+                case PredefForest::ZBDD:    return S::template of<PredefKernel<PredefForest::ZBDD> >();
+                case PredefForest::ESRBDD:  return S::template of<PredefKernel<PredefForest::ESRBDD> >();
+                case PredefForest::FBMXD:   return S::template of<PredefKernel<PredefForest::FBMXD> >();
+                case PredefForest::IBMXD:   return S::template of<PredefKernel<PredefForest::IBMXD> >();
+                case PredefForest::ESRBMXD: return S::template of<PredefKernel<PredefForest::ESRBMXD> >();
+            }
+        }
+        return S::template of<SettingKernel>();
+    }
+
+    /* Reordering helpers */
+    /// The nodes changed so far by an exchange of the levels k and k+1
+    struct LevelSwap {
+        uint16_t                                                    k;
+        std::vector<std::unordered_set<NodeHandle> >                inPlace;    // Rewritten in place, by level
+        std::vector<std::unordered_map<NodeHandle, ChildEdges> >    replaced;   // Left to be freed, with the new children of their functions, by level
+        std::unordered_map<NodeHandle, NodeHandle>                  moved;      // Copies of the old nodes of level k+1 rewritten in place
+        std::vector<std::unordered_map<EdgeHandle, Edge> >          memo;       // Rebuilt edges, by beginning level
+    };
+    /**
+     * @brief Exchange the variables at levels lvl and lvl+1. Only the nodes of the two levels are rehashed;
+     * a node above them changes only if one of its edges does, and is rewritten in place when it can be.
+     */
+    void swapLevels(const uint16_t lvl);
+    /**
+     * @brief The edge beginning at the given level, for the exchange of levels k and k+1.
+     * Nodes below k are kept; an edge that skips both levels is kept too, since the rules are
+     * symmetric in the skipped variables.
+     */
+    Edge swapEdge(const uint16_t lvl, const Edge& edge, LevelSwap& swap);
+    /// Give the node at level m (out of the unique table) its new children: in place, unless they reduce to another node
+    void swapNode(const uint16_t m, const NodeHandle handle, const ChildEdges& child, LevelSwap& swap);
+    /// Reclaim the nodes not reachable from any Func, and purge the compute tables
+    void reclaim();
+    /// The edge handle as written in a file: an edge to a node refers to the index of the node within its level
+    static inline EdgeHandle remapHandle(EdgeHandle handle, const std::vector<std::vector<NodeHandle> >& levels) {
+        uint16_t lvl = unpackLevel(handle);
+        if (lvl == 0) return handle;
+        const std::vector<NodeHandle>& nodes = levels[lvl];
+        packTarget(handle, (NodeHandle)(std::lower_bound(nodes.begin(), nodes.end(), unpackTarget(handle)) - nodes.begin()));
+        return handle;
+    }
+    /**
+     * @brief Number of assignments of the variables at levels 1 ... lvl for which an edge
+     * beginning at lvl gives the value "val"; T is uint64_t (modulo 2^64), double (the
+     * base-2 logarithm), or BigInt.
+     */
+    template <typename T>
+    T countEdge(const uint16_t lvl, const Edge& edge, const int val) const;
+    /// Number of those assignments giving a nonzero value, with the same result types
+    template <typename T>
+    T cardinalityEdge(const uint16_t lvl, const Edge& edge) const;
+    /// Write the setting part of the binary file header
+    void writeSetting(std::ostream& out) const;
+    /// Read the setting part of a binary file header, and check it matches this forest
+    void checkSetting(std::istream& in) const;
+
     /* Marker */
     void markNodes(const Edge& edge) const;
+    /**
+     * @brief Mark all the nonterminal nodes reachable from the given root edges, without
+     * recursion: newly marked nodes are queued by level, and the levels are visited from
+     * the top down, each in the order of node handles, so the node storage is read forward.
+     * 
+     * @param roots         The root edges.
+     * @param perLevel      [Optional] perLevel[k] is increased by the number of newly marked
+     *                      nodes at level k, for k = 1 ... numVars.
+     * @param reached       [Optional] Output (*reached)[k], the sorted handles of the newly
+     *                      marked nodes at level k.
+     * @return uint64_t     - Output the number of newly marked nodes.
+     */
+    uint64_t markNodes(const std::vector<Edge>& roots, uint64_t* perLevel = 0,
+                       std::vector<std::vector<NodeHandle> >* reached = 0) const;
+    /// The edges of all the Funcs of this forest
+    inline std::vector<Edge> funcRoots() const {
+        std::vector<Edge> roots;
+        for (const Func* f = funcs; f; f = f->nextFunc) roots.push_back(f->edge);
+        return roots;
+    }
+
+    /**
+     * @brief Switch on/off the concurrent mode, where several threads reduce and insert
+     * nodes in this forest at the same time (parallel operations).
+     * 
+     * @param concurrent    If threads are about to share this forest.
+     * @param numWorkers    Number of threads that may add nodes.
+     */
+    inline void setConcurrent(const bool concurrent, const int numWorkers = 1) {
+        if (concurrent) stats->setNumWorkers(numWorkers);
+        uniqueTable->setConcurrent(concurrent);
+        nodeMan->setConcurrent(concurrent, numWorkers);
+    }
 
     /// =============================================================
     friend class NodeManager;
@@ -511,13 +768,39 @@ class REXBDD::Forest {
     friend class Func;
     friend class UnaryOperation;
     friend class BinaryOperation;
+    friend class Snapshot;
+    friend class SaturationOperation;
         ForestSetting       setting;        // Specification setting of this forest.
         NodeManager*        nodeMan;        // Node manager.
         UniqueTable*        uniqueTable;    // Unique table.
         Func*               funcs;          // Registry of Func edges.
-        FuncArray*          funcSets;       // Sets of Func used for I/O.
+        FuncArray*          funcSets;       // Funcs kept by importForest.
         Statistics*         stats;          // Performance measurement.
+        std::vector<ComputeTable*>  caches; // Compute tables holding edges of this forest.
+        uint64_t            nextGC;         // Number of live nodes triggering the next markSweep.
+        uint64_t            nextReorder;    // Number of live nodes triggering the next dynamic reordering.
         int                 nodeSize;       // Number of uint32 slots for one Node storage.
+        /* Rule-transition tables, built from the setting at construction: the outcomes of
+         * normalizeEdge and cofact that only depend on the edge label */
+        static constexpr uint16_t NORM_GENERIC = 0xFFFF;    // normalizeLabel is called
+        static constexpr uint8_t COFACT_ZERO = 0, COFACT_ONE = 1, COFACT_SHORT = 2, COFACT_LONG = 3;
+        uint16_t            ruleSet;                    // Bit r: reduction rule r is allowed.
+        EdgeHandle          terminals[2];               // Terminals 0 and 1 of the value type, without label.
+        EdgeHandle          reducedTerminals[2];        // Terminals 0 and 1 of the patterns matched by reduceNode.
+        uint16_t            normTerminal[16][2][2][3];  // Normalized label (bits 0-7) and terminal (bit 8) of edges
+                                                        // to terminal 0 or 1, by [rule][comp][one][level: 0, 1, more].
+        uint8_t             normNode[16][3];            // Normalized rule of edges to nodes, by [rule][skipped: 0, 1, more].
+        uint8_t             cofactKind[16][2][4];       // Cofactor of long edges, by [rule][skips one level][child index]:
+                                                        // terminal 0 or 1 of the rule, the target (short), or normalized (long).
+        /* Kernels selected at construction */
+        bool                isPredefKernel;             // If the kernels are specialized for a predefined forest.
+        PredefForest        kernelType;                 // The predefined forest of the kernels, if isPredefKernel.
+        Edge                (Forest::*reduceEdgeFn)(const uint16_t, const EdgeLabel, const uint16_t, const ChildEdges&, const Value&);
+        Edge                (Forest::*reduceNodeFn)(const uint16_t, const ChildEdges&);
+        Edge                (Forest::*normalizeNodeFn)(const uint16_t, const ChildEdges&);
+        Edge                (Forest::*mergeEdgeFn)(const uint16_t, const uint16_t, const EdgeLabel, const Edge&, const Value&);
+        Edge                (Forest::*buildHalfFn)(const uint16_t, const uint16_t, const Edge&, const Edge&, const bool);
+        Edge                (Forest::*liftEdgeFn)(const uint16_t, const uint16_t, const Edge&);
 };
 
 
@@ -2,6 +2,8 @@
 #include "forest.h"
 #include "node.h"
 
+#include <algorithm>
+
 using namespace REXBDD;
 // ******************************************************************
 // *                                                                *
@@ -12,29 +14,73 @@ using namespace REXBDD;
 // ******************************************************************
 Func::Func()
 {
-    //
+    parent = 0;
+    name = "";
+    prevFunc = 0;
+    nextFunc = 0;
 }
 Func::Func(Forest* f)
 {
-    parent = f;
+    parent = 0;
     name = "";
     prevFunc = 0;
     nextFunc = 0;
+    attach(f);
 }
 Func::Func(Forest* f, const Edge& e)
 :edge(e)
 {
-    parent = f;
+    parent = 0;
     name = "";
     prevFunc = 0;
     nextFunc = 0;
+    attach(f);
+}
+Func::Func(const Func& f)
+:edge(f.edge)
+{
+    parent = 0;
+    name = f.name;
+    prevFunc = 0;
+    nextFunc = 0;
+    attach(f.parent);
 }
 Func::~Func()
 {
-    //
+    attach(nullptr);
 }
 
 /***************************** General **************************/
+Func& Func::operator=(const Func& f)
+{
+    if (this == &f) return *this;
+    if (parent != f.parent) attach(f.parent);
+    edge = f.edge;
+    name = f.name;
+    return *this;
+}
+
+void Func::attach(Forest* p)
+{
+    // unlink from the current registry
+    if (parent) {
+        if (prevFunc) {
+            prevFunc->nextFunc = nextFunc;
+        } else {
+            parent->funcs = nextFunc;
+        }
+        if (nextFunc) nextFunc->prevFunc = prevFunc;
+    }
+    parent = p;
+    prevFunc = 0;
+    nextFunc = 0;
+    // link to the front of the new one
+    if (parent) {
+        nextFunc = parent->funcs;
+        if (nextFunc) nextFunc->prevFunc = this;
+        parent->funcs = this;
+    }
+}
 
 /**************************** Make edge *************************/
 void Func::trueFunc()
@@ -106,6 +152,16 @@ Value Func::evaluate(const std::vector<bool>& assignment) const
     SwapSet st = parent->getSetting().getSwapType();
     CompSet ct = parent->getSetting().getCompType();
 
+    /* the assignment is indexed by variables; read it by levels */
+    std::vector<bool> permuted;
+    if (!parent->getSetting().isDefaultOrder()) {
+        permuted.resize(assignment.size());
+        for (uint16_t k=1; k<assignment.size(); k++) {
+            permuted[k] = assignment[parent->getSetting().getVar(k)];
+        }
+    }
+    const std::vector<bool>& atLevel = (parent->getSetting().isDefaultOrder()) ? assignment : permuted;
+
     /* tmp store edge info for "for" loop */
     Edge current = edge;
     /* get target node info */
@@ -130,8 +186,8 @@ Value Func::evaluate(const std::vector<bool>& assignment) const
         if ((targetLvl < k) && (incoming != RULE_X)) {
             // determine flags of all-ones and exist-ones
             for (uint16_t i=k; i>targetLvl; i--) {
-                allOne &= assignment[i];
-                existOne |= assignment[i];
+                allOne &= atLevel[i];
+                existOne |= atLevel[i];
             }
             if (encode == TERMINAL) {
                 // terminal value, don't care the Value on edge
@@ -162,7 +218,7 @@ Value Func::evaluate(const std::vector<bool>& assignment) const
             isSwap = (st==ONE || st==ALL) ? current.getSwap(0) : 0;
             // get swap/comp bit only when it's allowed, since user may insert illegal nodes into nodemanager (which is allowed)
             isComp = (ct==COMP) ? current.getComp() : 0;
-            current = parent->getChildEdge(targetLvl, targetHandle, isSwap^assignment[targetLvl]);
+            current = parent->getNodeView(targetLvl, targetHandle)[isSwap^atLevel[targetLvl]];
             if (isComp) current.complement();
             if (isSwap && st==ALL) current.swap();  // for swap-all
             /* update varibles */
@@ -216,6 +272,130 @@ Value Func::evaluate(const std::vector<bool>& aFrom, const std::vector<bool>& aT
     return ans;
 }
 
+/* If a terminal edge leads to a nonzero value; special values count as zero */
+static inline bool isTerminalNonzero(const EdgeHandle handle, const bool isComp, const long maxRange)
+{
+    NodeHandle target = unpackTarget(handle);
+    if (handle & FLOAT_VALUE_FLAG_MASK) {
+        float terminalVal = *reinterpret_cast<float*>(&target);
+        if (isComp) terminalVal = maxRange - terminalVal;
+        return terminalVal != 0;
+    }
+    if (handle & INT_VALUE_FLAG_MASK) {
+        int terminalVal = *reinterpret_cast<int*>(&target);
+        if (isComp) terminalVal = maxRange - terminalVal;
+        return terminalVal != 0;
+    }
+    return 0;
+}
+
+void Func::evaluate(const std::vector<uint64_t>& slices, std::vector<uint64_t>& results) const
+{
+    const ForestSetting& setting = parent->getSetting();
+    uint16_t numVars = setting.getNumVars();
+    if (setting.isRelation() || (setting.getEncodeMechanism() != TERMINAL)) {
+        std::cout << "[REXBDD] ERROR!\t Func::evaluate(): batch evaluation supports only set forests with the terminal encoding!" << std::endl;
+        exit(0);
+    }
+    if (slices.size() % (numVars+1) != 0) {
+        std::cout << "[REXBDD] ERROR!\t Func::evaluate(): Variable number check failed in evaluation! Blocks should be of "
+                  << numVars+1 << " words" << std::endl;
+        exit(0);
+    }
+    size_t numBlocks = slices.size() / (numVars+1);
+    results.assign(numBlocks, 0);
+    /* edge flags type */
+    SwapSet st = setting.getSwapType();
+    CompSet ct = setting.getCompType();
+    long maxRange = setting.getMaxRange();
+    /* The lanes following each edge into the nodes of a level; merged by edge before visiting the node */
+    std::vector<std::vector<std::pair<EdgeHandle, uint64_t> > > queues(numVars+1);
+    /* The slices read by levels */
+    std::vector<uint64_t> atLevel(numVars+1, 0);
+    for (size_t b=0; b<numBlocks; b++) {
+        const uint64_t* block = slices.data() + b * (numVars+1);
+        for (uint16_t k=1; k<=numVars; k++) atLevel[k] = block[setting.getVar(k)];
+        uint64_t& ans = results[b];
+        /* Follow an edge beginning at level k for the given lanes: the rule of a long edge
+         * decides some of them, as in evaluate(), and the others reach the target */
+        auto follow = [&](const uint16_t k, const Edge& current, uint64_t lanes) {
+            uint16_t targetLvl = current.getNodeLevel();
+            ReductionRule incoming = current.getRule();
+            if ((targetLvl < k) && (incoming != RULE_X)) {
+                uint64_t allOne = ~(uint64_t)0, existOne = 0;
+                for (uint16_t i=k; i>targetLvl; i--) {
+                    allOne &= atLevel[i];
+                    existOne |= atLevel[i];
+                }
+                uint64_t decided = 0;
+                if (isRuleAH(incoming)) decided = allOne;
+                else if (isRuleEL(incoming)) decided = ~allOne;
+                else if (isRuleEH(incoming)) decided = existOne;
+                else if (isRuleAL(incoming)) decided = ~existOne;
+                decided &= lanes;
+                if (hasRuleTerminalOne(incoming)) ans |= decided;
+                lanes &= ~decided;
+            }
+            if (!lanes) return;
+            if (targetLvl == 0) {
+                if (isTerminalNonzero(current.getEdgeHandle(), current.getComp() && (ct != NO_COMP), maxRange)) ans |= lanes;
+                return;
+            }
+            queues[targetLvl].push_back(std::make_pair(current.getEdgeHandle(), lanes));
+        };
+        follow(numVars, edge, ~(uint64_t)0);
+        for (uint16_t lvl=numVars; lvl>0; lvl--) {
+            std::vector<std::pair<EdgeHandle, uint64_t> >& queue = queues[lvl];
+            if (queue.empty()) continue;
+            std::sort(queue.begin(), queue.end());
+            for (size_t i=0; i<queue.size(); ) {
+                Edge current;
+                current.setEdgeHandle(queue[i].first);
+                uint64_t lanes = 0;
+                for (; (i<queue.size()) && (queue[i].first == current.getEdgeHandle()); i++) lanes |= queue[i].second;
+                // get swap/comp bit only when it's allowed, as in evaluate()
+                bool isSwap = (st==ONE || st==ALL) ? current.getSwap(0) : 0;
+                bool isComp = (ct==COMP) ? current.getComp() : 0;
+                NodeView view = parent->getNodeView(lvl, current.getNodeHandle());
+                for (char c=0; c<2; c++) {
+                    // child c is taken when the variable is c^isSwap
+                    uint64_t sub = lanes & ((c ^ isSwap) ? atLevel[lvl] : ~atLevel[lvl]);
+                    if (!sub) continue;
+                    Edge child = view[c];
+                    if (isComp) child.complement();
+                    if (isSwap && st==ALL) child.swap();  // for swap-all
+                    follow(lvl-1, child, sub);
+                }
+            }
+            queue.clear();
+        }
+    }
+}
+
+void Func::evaluate(const std::vector<std::vector<bool> >& assignments, std::vector<bool>& results) const
+{
+    uint16_t numVars = parent->getSetting().getNumVars();
+    size_t num = assignments.size();
+    /* Bit-slice the assignments, 64 per block */
+    std::vector<uint64_t> slices(((num + 63) / 64) * (numVars+1), 0);
+    for (size_t a=0; a<num; a++) {
+        if (assignments[a].size() != (size_t)numVars+1) {
+            std::cout << "[REXBDD] ERROR!\t Func::evaluate(): Variable number check failed in evaluation! It was "
+                      << assignments[a].size()-1 << ", it should be " << numVars << std::endl;
+            exit(0);
+        }
+        uint64_t* block = slices.data() + (a / 64) * (numVars+1);
+        uint64_t bit = (uint64_t)1 << (a % 64);
+        for (uint16_t v=1; v<=numVars; v++) {
+            if (assignments[a][v]) block[v] |= bit;
+        }
+    }
+    std::vector<uint64_t> words;
+    evaluate(slices, words);
+    results.resize(num);
+    for (size_t a=0; a<num; a++) results[a] = (words[a / 64] >> (a % 64)) & 1;
+}
+
 void Func::unionAssignments(const ExplictFunc& assignments) {
     // check applicability based on setting TBD <== relation? levels?
         // throw error(ErrCode::INVALID_BOUND, __FILE__, __LINE__);
@@ -256,6 +436,124 @@ Edge Func::unionAssignmentRecursive(uint16_t n, Edge& root, ExplictFunc assignme
     return ans;
 }
 
+// ******************************************************************
+// *                                                                *
+// *                                                                *
+// *                       CompiledFunc  methods                    *
+// *                                                                *
+// *                                                                *
+// ******************************************************************
+CompiledFunc::CompiledFunc(const Func& func)
+{
+    static_assert(sizeof(Step) == 16, "compiled steps are 16 bytes");
+    const Forest* forest = func.getForest();
+    const ForestSetting& setting = forest->getSetting();
+    if (setting.isRelation() || (setting.getEncodeMechanism() != TERMINAL)) {
+        std::cout << "[REXBDD] ERROR!\t CompiledFunc: only set forests with the terminal encoding are supported!" << std::endl;
+        exit(0);
+    }
+    uint16_t numVars = setting.getNumVars();
+    var.resize(numVars+1, 0);
+    for (uint16_t k=1; k<=numVars; k++) var[k] = setting.getVar(k);
+    /* edge flags type */
+    SwapSet st = setting.getSwapType();
+    CompSet ct = setting.getCompType();
+    long maxRange = setting.getMaxRange();
+    bool isFloat = (setting.getValType() == FLOAT) || (setting.getValType() == DOUBLE);
+    /* Steps 0 and 1: the constants reached by the rules */
+    for (int one=0; one<2; one++) {
+        terminals.push_back(isFloat ? makeTerminal(FLOAT, (float)one) : makeTerminal(INT, one));
+        Step step;
+        memset((void*)&step, 0, sizeof(Step));
+        step.next[0] = one;
+        steps.push_back(step);
+    }
+    /* The step of an edge beginning at a level, added if new; its next steps are set later */
+    std::vector<std::unordered_map<EdgeHandle, uint32_t> > memo(numVars+1);
+    std::vector<std::pair<uint32_t, Edge> > pending;
+    auto stepOf = [&](const uint16_t top, const Edge& edge) {
+        std::unordered_map<EdgeHandle, uint32_t>::iterator it = memo[top].find(edge.getEdgeHandle());
+        if (it != memo[top].end()) return it->second;
+        Step step;
+        memset((void*)&step, 0, sizeof(Step));
+        step.level = edge.getNodeLevel();
+        step.top = top;
+        ReductionRule rule = edge.getRule();
+        if ((step.level < top) && (rule != RULE_X)) {
+            if (isRuleAH(rule)) step.rule = STEP_AH;
+            else if (isRuleEL(rule)) step.rule = STEP_EL;
+            else if (isRuleEH(rule)) step.rule = STEP_EH;
+            else if (isRuleAL(rule)) step.rule = STEP_AL;
+            step.one = hasRuleTerminalOne(rule);
+        }
+        uint32_t index = steps.size();
+        if (step.level == 0) {
+            // the value of the terminal, complemented if needed
+            EdgeHandle handle = edge.getEdgeHandle();
+            if (edge.getComp() && (ct != NO_COMP)) {
+                NodeHandle target = unpackTarget(handle);
+                if (handle & FLOAT_VALUE_FLAG_MASK) {
+                    handle = makeTerminal(FLOAT, (float)(maxRange - *reinterpret_cast<float*>(&target)));
+                } else if (handle & INT_VALUE_FLAG_MASK) {
+                    handle = makeTerminal(INT, (int)(maxRange - *reinterpret_cast<int*>(&target)));
+                }
+            }
+            step.next[0] = terminals.size();
+            terminals.push_back(handle);
+        } else {
+            pending.push_back(std::make_pair(index, edge));
+        }
+        steps.push_back(step);
+        memo[top][edge.getEdgeHandle()] = index;
+        return index;
+    };
+    /* Step 2: the root; the others in breadth-first order */
+    stepOf(numVars, func.getEdge());
+    for (size_t i=0; i<pending.size(); i++) {
+        uint32_t index = pending[i].first;
+        Edge current = pending[i].second;
+        uint16_t lvl = current.getNodeLevel();
+        // get swap/comp bit only when it's allowed, as in Func::evaluate
+        bool isSwap = (st==ONE || st==ALL) ? current.getSwap(0) : 0;
+        bool isComp = (ct==COMP) ? current.getComp() : 0;
+        NodeView view = forest->getNodeView(lvl, current.getNodeHandle());
+        for (char c=0; c<2; c++) {
+            Edge child = view[c];
+            if (isComp) child.complement();
+            if (isSwap && st==ALL) child.swap();  // for swap-all
+            // child c is taken when the variable is c^isSwap
+            uint32_t next = stepOf(lvl-1, child);
+            steps[index].next[c ^ isSwap] = next;
+        }
+    }
+}
+
+Value CompiledFunc::evaluate(const std::vector<bool>& assignment) const
+{
+    if (assignment.size() != var.size()) {
+        std::cout << "[REXBDD] ERROR!\t CompiledFunc::evaluate(): Variable number check failed in evaluation! It was "
+                  << assignment.size()-1 << ", it should be " << getNumVars() << std::endl;
+        exit(0);
+    }
+    const Step* step = &steps[2];
+    for (;;) {
+        if (step->rule != STEP_NONE) {
+            bool allOne = 1, existOne = 0;
+            for (uint16_t k=step->top; k>step->level; k--) {
+                bool value = assignment[var[k]];
+                allOne &= value;
+                existOne |= value;
+            }
+            if (((step->rule == STEP_AH) && allOne) || ((step->rule == STEP_EL) && !allOne)
+                || ((step->rule == STEP_EH) && existOne) || ((step->rule == STEP_AL) && !existOne)) {
+                step = &steps[step->one];
+            }
+        }
+        if (step->level == 0) return getTerminalValue(terminals[step->next[0]]);
+        step = &steps[step->next[assignment[var[step->level]]]];
+    }
+}
+
 // ******************************************************************
 // *                                                                *
 // *                                                                *
@@ -265,18 +563,30 @@ Edge Func::unionAssignmentRecursive(uint16_t n, Edge& root, ExplictFunc assignme
 // ******************************************************************
 FuncArray::FuncArray()
 {
-    //
+    parent = 0;
 }
 FuncArray::FuncArray(Forest* f, int size)
 {
-    //
+    parent = f;
+    set.reserve(size);
 }
 FuncArray::~FuncArray()
 {
     //
 }
 
+void FuncArray::attach(Forest* p)
+{
+    if (p != parent) set.clear();
+    parent = p;
+}
+
 void FuncArray::add(Func f)
 {
-    // TBD
-}
\ No newline at end of file
+    if (!parent) parent = f.getForest();
+    if (!f.isAttachedTo(parent)) {
+        std::cout << "[REXBDD] ERROR!\t FuncArray::add(): the Func is in another forest!" << std::endl;
+        exit(0);
+    }
+    set.push_back(f);
+}
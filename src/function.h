@@ -8,6 +8,7 @@
 namespace REXBDD {
     class Func;
     class FuncArray;
+    class CompiledFunc;
     class ExplictFunc;
 };
 
@@ -25,6 +26,7 @@ class REXBDD::Func {
     Func();
     Func(Forest* f);
     Func(Forest* f, const Edge& e);
+    Func(const Func& f);
     ~Func();
 
     /***************************** General **************************/
@@ -57,17 +59,29 @@ class REXBDD::Func {
     void variable(uint16_t lvl, bool isPrime, Value low, Value high);
 
     // Assignment operator
-    // Func operator=(Func e);
+    Func& operator=(const Func& f);
 
 
     /************************* Within Operations ********************/
 
     /** Compute and get the encoded function value by giving the assignment.
+     *  "assignment" is indexed by variables, whatever their levels.
      *  Note: the first element of "assignment" (assignment[0]) is not used!
      * 
      */
     Value evaluate(const std::vector<bool>& assignment) const;
     Value evaluate(const std::vector<bool>& aFrom, const std::vector<bool>& aTo) const;
+    /**
+     * @brief Evaluate 64 assignments per traversal, bit-sliced: block b of "slices" is the
+     * numVars+1 words slices[b*(numVars+1) + var], where bit j is the value of variable
+     * "var" in assignment 64*b+j (word 0 of each block is not used). Bit j of results[b]
+     * is set if the function is nonzero on that assignment.
+     * Each block visits every node at most once per incoming edge label, top-down.
+     * Note: only "set" forests with the terminal encoding are supported.
+     */
+    void evaluate(const std::vector<uint64_t>& slices, std::vector<uint64_t>& results) const;
+    /// Evaluate each assignment (indexed like above) 64 at a time; results[i] is set if nonzero
+    void evaluate(const std::vector<std::vector<bool> >& assignments, std::vector<bool>& results) const;
 
     // ExplictFunc including info of assignments, outcomes, 
     void unionAssignments(const ExplictFunc& assignments);
@@ -80,15 +94,14 @@ class REXBDD::Func {
     private:
     /*-------------------------------------------------------------*/
     // ======================Helper Methods====================
-    /// Attach to a forest and link to its registry.
+    /// Attach to a forest and link to its registry; detach if null.
     void attach(Forest* p);
     void init(Func& f);
     inline bool equals(const Func f) const {
         //
         return
             (parent == f.parent) &&
-            (edge.handle == f.edge.handle) &&
-            (edge.value.getType());
+            (edge.handle == f.edge.handle);
     }
     Edge unionAssignmentRecursive(uint16_t num, Edge& root, ExplictFunc assignments);
 
@@ -122,19 +135,75 @@ class REXBDD::FuncArray {
     inline bool isAttachedTo(const Forest* p) const {return getForest() == p;}
     inline bool isSameForestSet(const FuncArray &e) const {return parent == e.getForest();}
     
-    /// Attach to a forest.
+    /// Attach to a forest; the Funcs of another forest are dropped.
     void attach(Forest* p);
     /// Detach from the forest.
     inline void detach() {attach(nullptr);}
+    /// Append a Func of the parent forest.
     void add(Func f);
 
+    inline int size() const {return (int)set.size();}
+    inline const Func& operator[](int i) const {return set[i];}
+    inline Func& operator[](int i) {return set[i];}
 
     /*-------------------------------------------------------------*/
     private:
     /*-------------------------------------------------------------*/
     friend class Forest;
-    Forest*     parent;     // parent forest
-    Func*       set;        // set of the Funcs
+    Forest*             parent;     // parent forest
+    std::vector<Func>   set;        // set of the Funcs; kept alive in the parent's registry
+};
+
+// ******************************************************************
+// *                                                                *
+// *                                                                *
+// *                     CompiledFunc class                         *
+// *                                                                *
+// *                                                                *
+// ******************************************************************
+/** Flat program evaluating a fixed Func, for functions evaluated very often.
+ *  Each reachable edge (with the level it begins at) becomes one 16-byte step,
+ *  in breadth-first order from the root, holding the decoded levels, the rule
+ *  of the skipped levels, and the indices of the next steps for both values of
+ *  the variable: the complement and swap flags are resolved when compiling.
+ *  Steps 0 and 1 are the constants 0 and 1 reached by the rules; terminal values
+ *  are resolved too. The program does not depend on the forest once built, so
+ *  it is not affected by later garbage collections or reorderings.
+ *  Note: only "set" forests with the terminal encoding are supported.
+ */
+class REXBDD::CompiledFunc {
+    /*-------------------------------------------------------------*/
+    public:
+    /*-------------------------------------------------------------*/
+    CompiledFunc(const Func& func);
+
+    /// Same as Func::evaluate: "assignment" is indexed by variables, and assignment[0] is not used
+    Value evaluate(const std::vector<bool>& assignment) const;
+
+    inline uint16_t getNumVars() const {return (uint16_t)(var.size()-1);}
+    inline size_t getNumSteps() const {return steps.size();}
+
+    /*-------------------------------------------------------------*/
+    private:
+    /*-------------------------------------------------------------*/
+    /// Rule of the levels skipped by a step
+    enum StepRule : uint8_t {
+        STEP_NONE = 0,  // no level skipped, or the rule X
+        STEP_AH,        // to "one" if all the skipped variables are 1
+        STEP_EL,        // to "one" if some skipped variable is 0
+        STEP_EH,        // to "one" if some skipped variable is 1
+        STEP_AL         // to "one" if all the skipped variables are 0
+    };
+    struct Step {
+        uint32_t    next[2];    // next steps by the variable at "level"; next[0] indexes the terminals if "level" is 0
+        uint16_t    level;      // level of the target node; 0 for a terminal
+        uint16_t    top;        // level the edge begins at: levels (level, top] are skipped
+        uint8_t     rule;       // StepRule of the skipped levels
+        uint8_t     one;        // step (0 or 1) taken when the rule applies
+    };
+    std::vector<Step>       steps;
+    std::vector<EdgeHandle> terminals;  // resolved terminal values
+    std::vector<uint16_t>   var;        // var[k] is the variable at level k
 };
 
 // ******************************************************************
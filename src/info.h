@@ -0,0 +1,9 @@
+#define PROJECT_VERSION "0.0.1"
+#define PROJECT_VERSION_MAJOR 0
+#define PROJECT_VERSION_MINOR 0
+#define PROJECT_VERSION_PATCH 1
+#define PROJECT_NAME "RexBDD"
+#define PROJECT_URL "https://github.com/lcdeng1/RexBDD.git"
+#define PROJECT_COPYRIGHT "Copyright (C) 2024, ."
+#define PROJECT_LICENSE "Apache License, version 2.0"
+#define PROJECT_DATE "Jun 14, 2024"
@@ -9,7 +9,10 @@
 namespace REXBDD {
     static const uint32_t NODE_LABEL_MASK = (uint32_t)((0x01<<27)-1)<<5;
     static const uint32_t MARK_MASK = (uint32_t)(0x01);
+    // slots of the largest node: a relation node with 64-bit values and child levels
+    static const int MAX_NODE_SIZE = 14;
     class Node;
+    class NodeView;
 }
 
 // ******************************************************************
@@ -64,6 +67,10 @@ namespace REXBDD {
  *  Mxnode has 3 (or 6 for LONG and DOUBLE) more slots for values if needed.
  * 
  *  The construction can depend on the forest setting to further compress?
+ *
+ *  Nodes stored in a forest live in the per-level slabs of NodeManager;
+ *  a Node obtained from the forest is a view of its slots in the slab,
+ *  and it is only valid until the slab of that level is expanded or shrunk.
  * 
  */
 class REXBDD::Node {
@@ -75,13 +82,20 @@ class REXBDD::Node {
         int infoSize = s.nodeSize();
         info = (uint32_t*)malloc(infoSize * sizeof(uint32_t));
         for (int i=0; i<infoSize; i++) info[i] = 0;
+        isOwner = 1;
     }
     Node(const int size) {
         info = (uint32_t*)malloc(size * sizeof(uint32_t));
         for (int i=0; i<size; i++) info[i] = 0;
+        isOwner = 1;
     }
+    // view of a node slot stored in NodeManager; the storage is not owned
+    Node(uint32_t* slot):info(slot),isOwner(0) {}
+    // copies are always views
+    Node(const Node& node):info(node.info),isOwner(0) {}
+    Node& operator=(const Node& node) = delete;
     ~Node() {
-        free(info);
+        if (isOwner) free(info);
     }
 
     /// Methods =====================================================
@@ -265,6 +279,7 @@ class REXBDD::Node {
      * @param swap  for Mxnode: 0 for from swap; 1 for to swap
      * @return true 
      * @return false 
+     * Set nodes have no "to" swap: it is always false for them.
      */
     inline bool edgeSwap(char child, bool swap, bool isMxd) const {
         if (((!isMxd) && child > 1) || child > 3) {
@@ -272,7 +287,7 @@ class REXBDD::Node {
             throw error(ErrCode::INVALID_BOUND, __FILE__, __LINE__);
             exit(ErrCode::INVALID_BOUND);
         }
-        if ((!isMxd)) return info[1] & (0x01 << (10 + 2 * (1 - (child % 2))));
+        if ((!isMxd)) return (!swap) && (info[1] & (0x01 << (10 + 2 * (1 - (child % 2)))));
         return info[1] & (0x01 << (5 + 2 * (3 - child) + (1 - swap)));
     }
 
@@ -377,8 +392,87 @@ class REXBDD::Node {
     /*-------------------------------------------------------------*/
     /// ============================================================
     friend class Forest;
+    friend class NodeView;
     uint32_t* info;         // Next pointer, edge rules, edge flags, node handles, and levels
+    bool      isOwner;      // If the info slots are allocated by this node
 };
 
 
+
+// ******************************************************************
+// *                                                                *
+// *                        NodeView class                          *
+// *                                                                *
+// ******************************************************************
+/** Decoded child edges of a stored node.
+ *
+ *  All the child edges (rule, flags, level, target, and terminal type) are
+ *  unpacked at once, from one read of the label slot and the handle and level
+ *  slots, without the bounds checks of the Node accessors. The view holds
+ *  copies, so it stays valid when the slabs of NodeManager move.
+ *
+ *  As by Forest::getChildEdge, the child edges of a set node only carry the
+ *  "from" swap flag: set forests have no "to" swap.
+ */
+class REXBDD::NodeView {
+    /*-------------------------------------------------------------*/
+    public:
+    /*-------------------------------------------------------------*/
+    /**
+     * @brief Decode the child edges of a node.
+     *
+     * @param node          The node stored in NodeManager.
+     * @param level         The level of the node.
+     * @param isMxd         If the node is a relation node, with 4 children.
+     * @param hasLvl        If the node stores the levels of its children; otherwise they are at level-1.
+     * @param valueFlag     The header of terminal children that are not special values:
+     *                      INT_VALUE_FLAG_MASK or FLOAT_VALUE_FLAG_MASK.
+     */
+    NodeView(const Node& node, const uint16_t level, const bool isMxd, const bool hasLvl, const EdgeHandle valueFlag)
+    :down(isMxd ? 4 : 2) {
+        const uint32_t* info = node.info;
+        const uint32_t labels = info[1];
+        for (int c=0; c<(int)down.size(); c++) {
+            EdgeHandle handle = (EdgeHandle)info[2 + c];
+            uint16_t lvl = level - 1;
+            if (hasLvl) lvl = (uint16_t)(((isMxd) ? info[6 + (c / 2)] : info[4]) >> (16 * (1 - (c % 2))));
+            handle |= (EdgeHandle)((labels >> (16 + 4 * (3 - c))) & 0x0F) << 51;
+            if (c > 0) handle |= (EdgeHandle)((labels >> (13 + (3 - c))) & 0x01) << 48;
+            if (isMxd) {
+                handle |= (EdgeHandle)((labels >> (6 + 2 * (3 - c))) & 0x01) << 50;
+                handle |= (EdgeHandle)((labels >> (5 + 2 * (3 - c))) & 0x01) << 49;
+            } else {
+                handle |= (EdgeHandle)((labels >> (10 + 2 * (1 - c))) & 0x01) << 50;
+            }
+            if (lvl > 0) {
+                handle |= (EdgeHandle)lvl << 32;
+            } else {
+                handle |= (labels & (0x01 << (4 - c))) ? SPECIAL_VALUE_FLAG_MASK : valueFlag;
+            }
+            down[c] = Edge(handle);
+        }
+    }
+
+    /// Methods =====================================================
+    /// Get the number of child edges
+    inline size_t size() const {return down.size();}
+    /// Get the child edge of the given index
+    inline const Edge& operator[](const size_t child) const {return down[child];}
+    /// Get all the child edges, as given to the reduction
+    inline const ChildEdges& children() const {return down;}
+    /// Get the rule of the given child edge
+    inline ReductionRule childRule(const size_t child) const {return down[child].getRule();}
+    /// Get the level of the given child node
+    inline uint16_t childLevel(const size_t child) const {return down[child].getNodeLevel();}
+    /// Get the handle of the given child node; for a terminal child, its value bits
+    inline NodeHandle childHandle(const size_t child) const {return down[child].getNodeHandle();}
+    /// Check if the given child is a terminal node
+    inline bool isChildTerminal(const size_t child) const {return down[child].getNodeLevel() == 0;}
+
+    /*-------------------------------------------------------------*/
+    private:
+    /*-------------------------------------------------------------*/
+    ChildEdges      down;       // The decoded child edges
+};
+
 #endif
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "node_manager.h"
 #include "forest.h"
+#include "operations/work_pool.h"
 
 // #define REXBDD_NM_TRACE
 
@@ -15,8 +16,9 @@ using namespace REXBDD;
 NodeManager::SubManager::SubManager(Forest *f):parent(f)
 {
     sizeIndex = 0;
-    nodes = (Node*)malloc((PRIMES[sizeIndex] + 1) * sizeof(Node));
-    if (!nodes) {
+    slotSize = f->nodeSize;
+    slab.store((uint32_t*)malloc((PRIMES[sizeIndex] + 1) * slotSize * sizeof(uint32_t)));
+    if (!slab.load()) {
         std::cout << "[REXBDD] ERROR!\t Malloc fail for submanager!"<< std::endl;
         exit(0);
     }
@@ -24,22 +26,24 @@ NodeManager::SubManager::SubManager(Forest *f):parent(f)
     firstUnalloc = 1;
     freeList = 0;
     numFrees = PRIMES[sizeIndex];
+    caches = 0;
+    numCaches = 0;
 }
 NodeManager::SubManager::~SubManager()
 {
-    for (uint32_t i=1; i<firstUnalloc; i++) {
-        nodes[i].~Node();
-    }
-    free(nodes);
+    free(slab.load());
+    for (size_t i=0; i<retired.size(); i++) free(retired[i]);
+    delete[] caches;
 }
 
 NodeHandle NodeManager::SubManager::getFreeNodeHandle(const Node& node)
 {
+    if (caches) return getFreeNodeHandleConcurrent(node);
     /* Re-use the recycled handle, if we have one */
     if (recycled) {
         const NodeHandle h = recycled;
         recycled = 0;
-        nodes[h].assign(node, parent->nodeSize);
+        Node(slot(h)).assign(node, slotSize);
         return h;
     }
     /* Enlarge if there is no free/unused slots */
@@ -49,24 +53,89 @@ NodeHandle NodeManager::SubManager::getFreeNodeHandle(const Node& node)
     if (freeList) {
         // pull from the free list
         NodeHandle h = freeList;
-        freeList = nodes[h].nextFree();
-        nodes[h].assign(node, parent->nodeSize);
+        Node slotNode(slot(h));
+        freeList = slotNode.nextFree();
+        slotNode.assign(node, slotSize);
         return h;
     }
     /* Free list is empty, so pull from the unallocated end portion */
-    new (&nodes[firstUnalloc]) Node(parent->nodeSize);
-    nodes[firstUnalloc].assign(node, parent->nodeSize);
+    Node(slot(firstUnalloc)).assign(node, slotSize);
     return firstUnalloc++;
 }
 
-Node& NodeManager::SubManager::getNodeFromHandle(const NodeHandle h)
+NodeHandle NodeManager::SubManager::getFreeNodeHandleConcurrent(const Node& node)
+{
+    FreeCache& cache = caches[WorkPool::workerIndex()];
+    if (!cache.count) refill(cache);
+    const NodeHandle h = cache.handles[--cache.count];
+    /* The slab must not move while we write */
+    std::shared_lock<std::shared_mutex> guard(slabLock);
+    Node(slot(h)).assign(node, slotSize);
+    return h;
+}
+
+void NodeManager::SubManager::returnFreeNodeHandle(const NodeHandle h)
+{
+    FreeCache& cache = caches[WorkPool::workerIndex()];
+    if (cache.count < FREE_BATCH) {
+        cache.handles[cache.count++] = h;
+        return;
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    std::shared_lock<std::shared_mutex> slabGuard(slabLock);
+    Node(slot(h)).recycle(freeList);
+    freeList = h;
+    numFrees++;
+}
+
+void NodeManager::SubManager::refill(FreeCache& cache)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    while (cache.count < FREE_BATCH) {
+        if (!numFrees) expand();
+        numFrees--;
+        if (freeList) {
+            cache.handles[cache.count++] = freeList;
+            freeList = Node(slot(freeList)).nextFree();
+        } else {
+            cache.handles[cache.count++] = firstUnalloc++;
+        }
+    }
+}
+
+void NodeManager::SubManager::flushCaches()
+{
+    for (int i=0; i<numCaches; i++) {
+        while (caches[i].count) {
+            const NodeHandle h = caches[i].handles[--caches[i].count];
+            Node(slot(h)).recycle(freeList);
+            freeList = h;
+            numFrees++;
+        }
+    }
+    delete[] caches;
+    caches = 0;
+    numCaches = 0;
+}
+
+void NodeManager::SubManager::setNext(const NodeHandle h, const NodeHandle next)
+{
+    if (caches) {
+        std::shared_lock<std::shared_mutex> guard(slabLock);
+        Node(slot(h)).setNext(next);
+        return;
+    }
+    Node(slot(h)).setNext(next);
+}
+
+Node NodeManager::SubManager::getNodeFromHandle(const NodeHandle h)
 {
     if (h>=firstUnalloc) {
         std::cout << "[REXBDD] ERROR!\t Invalid handle in node submanager; " 
         << firstUnalloc-1 << "nodes are allocated" << std::endl;
         exit(0);
     }
-    return nodes[h];
+    return Node(slot(h));
 }
 
 void NodeManager::SubManager::expand()
@@ -84,7 +153,26 @@ void NodeManager::SubManager::expand()
     } else {
         newSize = PRIMES[sizeIndex] + 1;
     }
-    nodes = (Node*)realloc(nodes, newSize * sizeof(Node));
+    if (caches) {
+        // other threads may be reading the old slab: copy, publish, and retire it,
+        // while nobody writes a slot
+        uint32_t* newSlab = (uint32_t*)malloc((uint64_t)newSize * slotSize * sizeof(uint32_t));
+        if (!newSlab) {
+            std::cout << "[REXBDD] ERROR!\t Malloc fail for submanager!"<< std::endl;
+            exit(0);
+        }
+        std::unique_lock<std::shared_mutex> guard(slabLock);
+        memcpy(newSlab, slab.load(), (uint64_t)firstUnalloc * slotSize * sizeof(uint32_t));
+        retired.push_back(slab.load());
+        slab.store(newSlab, std::memory_order_release);
+    } else {
+        uint32_t* newSlab = (uint32_t*)realloc(slab.load(), (uint64_t)newSize * slotSize * sizeof(uint32_t));
+        if (!newSlab) {
+            std::cout << "[REXBDD] ERROR!\t Realloc fail for submanager!"<< std::endl;
+            exit(0);
+        }
+        slab.store(newSlab, std::memory_order_release);
+    }
     numFrees += (newSize - PRIMES[sizeIndex-1] - 1);
 }
 
@@ -92,34 +180,39 @@ void NodeManager::SubManager::shrink()
 {
     sizeIndex--;
     uint32_t newSize = PRIMES[sizeIndex] + 1;
-    nodes = (Node*)realloc(nodes, newSize * sizeof(Node));
+    uint32_t* newSlab = (uint32_t*)realloc(slab.load(), (uint64_t)newSize * slotSize * sizeof(uint32_t));
+    if (!newSlab) {
+        std::cout << "[REXBDD] ERROR!\t Realloc fail for submanager!"<< std::endl;
+        exit(0);
+    }
+    slab.store(newSlab, std::memory_order_release);
     numFrees -= (PRIMES[sizeIndex+1] + 1 - newSize);
 }
 
 void NodeManager::SubManager::sweep()
 {
-    if (!nodes) return;
-    /* Expand the unallocated portion as much as we  can */
-    while (firstUnalloc) {
-        if ((nodes+firstUnalloc-1)->isMarked()) {
+    if (!slab.load()) return;
+    /* Expand the unallocated portion as much as we  can; handle 0 is never used */
+    while (firstUnalloc > 1) {
+        if (Node(slot(firstUnalloc-1)).isMarked()) {
             break;
         }
-        (nodes+firstUnalloc-1)->~Node();
         firstUnalloc--;
     }
     numFrees = ((PRIMES[sizeIndex]>UINT32_MAX)? UINT32_MAX:PRIMES[sizeIndex]) + 1 - firstUnalloc;
     /* Check if we can shrink */
-    if (firstUnalloc < PRIMES[sizeIndex-1]) {
+    if ((sizeIndex > 0) && (firstUnalloc < PRIMES[sizeIndex-1])) {
         shrink();
     }
     /* Rebuild the free list, by scanning all nodes backwards.
        Unmarked nodes are added to the list. */
     freeList = 0;
     for (uint32_t i=firstUnalloc; i>1; --i) {
-        if (nodes[i-1].isMarked()) {
-            nodes[i-1].unmark();
+        Node node(slot(i-1));
+        if (node.isMarked()) {
+            node.unmark();
         } else {
-            nodes[i-1].recycle(freeList);
+            node.recycle(freeList);
             freeList = i-1;
             numFrees++;
         }
@@ -135,6 +228,7 @@ void NodeManager::SubManager::sweep()
 
 NodeManager::NodeManager(Forest *f):parent(f)
 {
+    isConcurrent = 0;
     uint16_t lvls = f->getSetting().getNumVars();
     chunks = (SubManager*)malloc(lvls * sizeof(SubManager));
     for (uint32_t i=0; i<lvls; i++) {
@@ -150,6 +244,15 @@ NodeManager::~NodeManager()
     parent = 0;
 }
 
+void NodeManager::recycleNodeHandle(uint16_t lvl, NodeHandle h)
+{
+    /* Only outside the concurrent mode, where the free list is not shared */
+    SubManager& chunk = chunks[lvl-1];
+    Node(chunk.slot(h)).recycle(chunk.freeList);
+    chunk.freeList = h;
+    chunk.numFrees++;
+}
+
 void NodeManager::sweep(uint16_t lvl)
 {
     chunks[lvl-1].sweep();
@@ -157,7 +260,7 @@ void NodeManager::sweep(uint16_t lvl)
 
 void NodeManager::sweep()
 {
-    for (uint16_t k=0; k<parent->getSetting().getNumVars(); k++) {
+    for (uint16_t k=1; k<=parent->getSetting().getNumVars(); k++) {
         sweep(k);
     }
 }
@@ -169,8 +272,9 @@ void NodeManager::unmark(uint16_t lvl)
     std::cout << "\tfirstUnalloc = " << chunks[lvl-1].firstUnalloc << "; size = " << PRIMES[chunks[lvl-1].sizeIndex] << std::endl;
 #endif
     for (uint32_t i=1; i<chunks[lvl-1].firstUnalloc; i++) {
-        if (chunks[lvl-1].nodes[i].isMarked()) {
-            chunks[lvl-1].nodes[i].unmark();
+        Node node(chunks[lvl-1].slot(i));
+        if (node.isMarked()) {
+            node.unmark();
         }
     }
 }
@@ -180,4 +284,25 @@ void NodeManager::unmark()
     for (uint16_t k=1; k<=parent->getSetting().getNumVars(); k++) {
         unmark(k);
     }
-}
\ No newline at end of file
+}
+
+void NodeManager::setConcurrent(bool concurrent, int numWorkers)
+{
+    if (concurrent == isConcurrent) return;
+    isConcurrent = concurrent;
+    for (uint16_t k=0; k<parent->getSetting().getNumVars(); k++) {
+        SubManager& chunk = chunks[k];
+        if (concurrent) {
+            chunk.caches = new FreeCache[numWorkers];
+            chunk.numCaches = numWorkers;
+            for (int i=0; i<numWorkers; i++) chunk.caches[i].count = 0;
+            continue;
+        }
+        /* No more concurrent readers, release the retired slabs and cached handles */
+        chunk.flushCaches();
+        for (size_t i=0; i<chunk.retired.size(); i++) {
+            free(chunk.retired[i]);
+        }
+        chunk.retired.clear();
+    }
+}
@@ -4,9 +4,15 @@
 #include "defines.h"
 #include "node.h"
 
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+
 namespace REXBDD {
     class Forest;
     class NodeManager;
+    /// Number of free node handles a thread takes at once in the concurrent mode
+    static const int FREE_BATCH = 32;
 
     // I/O TBD
     // stats for performance measurement TBD
@@ -35,10 +41,25 @@ class REXBDD::NodeManager {
         return chunks[lvl-1].getFreeNodeHandle(node);
     }
 
+    /**
+     *  Give back a handle obtained by getFreeNodeHandle() that was
+     *  never published, e.g., another thread inserted the same node first.
+     */
+    inline void returnFreeNodeHandle(const uint16_t lvl, const NodeHandle h) {
+        chunks[lvl-1].returnFreeNodeHandle(h);
+    }
+
+    /**
+     *  Set the next pointer (unique table chain) of a node
+     */
+    inline void setNodeNext(const uint16_t lvl, const NodeHandle h, const NodeHandle next) {
+        chunks[lvl-1].setNext(h, next);
+    }
+
     /**
      *  Find the node corresponding to a node handle
      */
-    inline Node& getNodeFromHandle(const uint16_t lvl, const NodeHandle h) {
+    inline Node getNodeFromHandle(const uint16_t lvl, const NodeHandle h) {
         return chunks[lvl-1].getNodeFromHandle(h);
     }
 
@@ -62,12 +83,32 @@ class REXBDD::NodeManager {
     void unmark(uint16_t lvl);
     void unmark();
 
+    /**
+     *  Switch on/off the concurrent mode, where several threads read and
+     *  add nodes at the same time.
+     *  In this mode each worker (by WorkPool::workerIndex()) takes free
+     *  handles in batches into its own cache, so the level's lock is only
+     *  taken once per FREE_BATCH nodes. A slab is never moved in place:
+     *  expanding copies it while no slot is being written, and the old copy
+     *  is kept for readers until the mode is switched off; then the unused
+     *  cached handles go back to the free lists.
+     *
+     *  @param concurrent   If threads are about to share this manager.
+     *  @param numWorkers   Number of workers that may add nodes.
+     */
+    void setConcurrent(bool concurrent, int numWorkers = 1);
+
     inline uint32_t numUsed(uint16_t lvl) const { return PRIMES[chunks[lvl-1].sizeIndex] - chunks[lvl-1].numFrees; }
     inline uint32_t numAlloc(uint16_t lvl) const { return chunks[lvl-1].firstUnalloc; }
 
     /*-------------------------------------------------------------*/
     private:
     /*-------------------------------------------------------------*/
+    /// Free handles reserved by one worker, on their own cache lines
+    struct alignas(64) FreeCache {
+        NodeHandle  handles[FREE_BATCH];
+        int         count;
+    };
     class SubManager {
         public:
             SubManager(Forest *f);
@@ -78,8 +119,22 @@ class REXBDD::NodeManager {
         // ======================Helper Methods====================
             /// Get a free NodeHandle and fill it with a given node
             NodeHandle getFreeNodeHandle(const Node& node);
+            /// Get a free NodeHandle from the calling worker's cache and fill it
+            NodeHandle getFreeNodeHandleConcurrent(const Node& node);
+            /// Give back an unpublished handle
+            void returnFreeNodeHandle(const NodeHandle h);
+            /// Take a batch of free handles into a worker's cache
+            void refill(FreeCache& cache);
+            /// Put the cached handles back to the free list
+            void flushCaches();
+            /// Set the next pointer of a node
+            void setNext(const NodeHandle h, const NodeHandle next);
             /// Find the node corresponding to a node handle
-            Node& getNodeFromHandle(const NodeHandle h);
+            Node getNodeFromHandle(const NodeHandle h);
+            /// The slots of a node handle in the slab
+            inline uint32_t* slot(const NodeHandle h) const {
+                return slab.load(std::memory_order_acquire) + (uint64_t)h * slotSize;
+            }
 
             /// Expand the nodes to next size (if possible)
             void expand();
@@ -89,12 +144,19 @@ class REXBDD::NodeManager {
         // ========================================================
             friend class NodeManager;
             Forest*     parent;         // Parent forest
-            Node*       nodes;          // Actual node storage; the 1st slot (nodes[0]) will not be used
+            std::atomic<uint32_t*>  slab;   // Actual node storage, contiguous slots of all nodes; node h starts at slab[h*slotSize],
+                                        // the 1st node slot (handle 0) will not be used
+            int         slotSize;       // Number of uint32 slots per node
             int         sizeIndex;      // Index of prime number for size
-            uint32_t    firstUnalloc;   // Index of first unallocated slot
+            std::atomic<uint32_t>   firstUnalloc;   // Index of first unallocated slot; read without locks in concurrent mode
             uint32_t    freeList;       // Header of the list of unused slots
             uint32_t    numFrees;       // Number of free/unused slots
             uint32_t    recycled;       // Last recycled node index
+            std::vector<uint32_t*>  retired;    // Old slabs still visible to concurrent readers
+            FreeCache*          caches;         // Per worker caches of free handles (concurrent mode)
+            int                 numCaches;      // Number of caches
+            std::mutex          lock;           // Guards the free handles in concurrent mode
+            std::shared_mutex   slabLock;       // Shared by slot writers, exclusive to move the slab
 
     }; // class SubManager
 
@@ -104,6 +166,7 @@ class REXBDD::NodeManager {
     // ========================================================
     Forest* parent;        // Parent Forest
     SubManager* chunks;    // Chunks by levels
+    bool isConcurrent;     // If nodes are read and added by several threads
 
 };
 
@@ -11,6 +11,7 @@ namespace REXBDD {
     /* Unary */
     typedef UnaryOperation* (*UnaryBuiltin1)(Forest* arg, Forest* res);
     typedef UnaryOperation* (*UnaryBuiltin2)(Forest* arg, OpndType res);
+    typedef UnaryOperation* (*UnaryBuiltin3)(Forest* arg, std::vector<uint16_t> vars, Forest* res);
     /* Binary */
     typedef BinaryOperation* (*BinaryBuiltin1)(Forest* arg1, Forest* arg2, Forest* res);
     typedef BinaryOperation* (*BinaryBuiltin2)(Forest* arg1, OpndType arg2, Forest* res);
@@ -33,6 +34,16 @@ namespace REXBDD {
         UnaryOperation* uop = ub(arg.getForest(), OpndType::REAL);
         uop->compute(arg, res);
     }
+    inline void apply(UnaryBuiltin2 ub, const Func& arg, BigInt& res)
+    {
+        UnaryOperation* uop = ub(arg.getForest(), OpndType::HUGEINT);
+        uop->compute(arg, res);
+    }
+    inline void apply(UnaryBuiltin3 ub, const Func& arg, const std::vector<uint16_t>& vars, Func& res)
+    {
+        UnaryOperation* uop = ub(arg.getForest(), vars, res.getForest());
+        uop->compute(arg, res);
+    }
     // ******************************************************************
     // *                         Binary  apply                          *
     // ******************************************************************
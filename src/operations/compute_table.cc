@@ -15,87 +15,103 @@ ComputeTable::ComputeTable()
 {
     sizeIndex = 0;
     numEnries = 0;
-    table = std::vector<CacheEntry>(PRIMES[sizeIndex], CacheEntry());
+    ways = 1;
+    opTag = 0;
+    isConcurrent = 0;
+    workerStats = 0;
+    numWorkers = 0;
+    forests[0] = forests[1] = forests[2] = 0;
+    table = allocTable(getSize());
     countHits = 0;
+    countMisses = 0;
     countOverwrite = 0;
+    for (int w=0; w<4; w++) {
+        countWayHits[w] = 0;
+        countWayEvicts[w] = 0;
+    }
 }
 ComputeTable::~ComputeTable()
 {
-    table.clear();
+    setForests(0, 0, 0);
+    free(table);
+    table = 0;
+    delete[] workerStats;
+    workerStats = 0;
 }
 
-bool ComputeTable::check(const uint16_t lvl, const Edge& a, Edge& ans)
+void ComputeTable::setConcurrent(const bool concurrent, const int num, const uint64_t numExpected)
 {
-    CacheEntry entry(lvl, a);
-    uint64_t size = PRIMES[sizeIndex] ? PRIMES[sizeIndex] : ((uint64_t)0x01 << 60);
-    uint64_t id = entry.hash() % size;
-    if (table[id].isInUse) {
-        /* Valid entry, then check if match */
-        if ((table[id].lvl == lvl) && (table[id].keySize == 1)
-            && (table[id].key[0] == a)) {
-            countHits++;
-            ans = table[id].res;
-            return 1;
+    if (concurrent == isConcurrent) return;
+    isConcurrent = concurrent;
+    if (concurrent) {
+        // the workers do not enlarge the table: make room for them now
+        int newIndex = sizeIndex;
+        while (PRIMES[newIndex + 1] && isOverloaded(numEnries + numExpected, PRIMES[newIndex])) newIndex++;
+        if (newIndex > sizeIndex) enlarge(newIndex);
+        // fresh counters for this run
+        if (num > numWorkers) {
+            delete[] workerStats;
+            workerStats = new WorkerStats[num];
         }
+        numWorkers = num;
+        memset((void*)workerStats, 0, numWorkers * sizeof(WorkerStats));
+        return;
+    }
+    /* Add up the counters of the workers */
+    for (int i=0; i<numWorkers; i++) {
+        countHits += workerStats[i].hits;
+        countMisses += workerStats[i].misses;
+        numEnries += workerStats[i].inserts;
+        countOverwrite += workerStats[i].overwrites;
     }
-    /* Not cached */
-    return 0;
 }
 
-bool ComputeTable::check(const uint16_t lvl, const Edge& a, const Edge& b, Edge& ans)
+void ComputeTable::setWays(const int numWays)
 {
-    CacheEntry entry(lvl, a, b);
-    uint64_t size = PRIMES[sizeIndex] ? PRIMES[sizeIndex] : ((uint64_t)0x01 << 60);
-    uint64_t id = entry.hash() % size;
-#ifdef REXBDD_CACHE_TRACE
-    std::cout << "checking in cache, id = " << id << "; size = " << size << std::endl;
-#endif
-    if (table[id].isInUse) {
-        /* Valid entry, then check if match */
-        if ((table[id].lvl == lvl) && (table[id].keySize == 2)
-            && (table[id].key[0] == a) && (table[id].key[1] == b)) {
-            countHits++;
-            ans = table[id].res;
-            return 1;
-        }
+    if ((numWays != 1) && (numWays != 2) && (numWays != 4)) {
+        std::cout << "[REXBDD] ERROR!\t Compute table supports 1, 2 or 4 ways; given: " << numWays << std::endl;
+        exit(0);
     }
-    /* Not cached */
-    return 0;
+    free(table);
+    ways = numWays;
+    sizeIndex = 0;
+    numEnries = 0;
+    table = allocTable(getSize());
 }
 
-void ComputeTable::add(const uint16_t lvl, const Edge& a, const Edge& ans)
+CacheEntry* ComputeTable::allocTable(const uint64_t buckets) const
 {
-    /* Check if we should enlage the table when  */
-    uint64_t size = PRIMES[sizeIndex] ? PRIMES[sizeIndex] : ((uint64_t)0x01 << 60);
-    if ((numEnries > (size / 1.5)) && (numEnries < (uint64_t)0x01 << 60)) {
-        sizeIndex++;
-        size = PRIMES[sizeIndex] ? PRIMES[sizeIndex] : ((uint64_t)0x01 << 60);
-        enlarge(size);
-    }
-    CacheEntry entry(lvl, a);
-    uint64_t id = entry.hash() % size;
-    /* new entry */
-    if (!table[id].isInUse) {
-        numEnries++;
+    CacheEntry* entries = 0;
+    uint64_t bytes = buckets * ways * sizeof(CacheEntry);
+    if (ways > 1) {
+        // buckets start at cache line boundaries; bytes is a multiple of 64 here
+        entries = (CacheEntry*)aligned_alloc(64, bytes);
+        if (entries) memset((void*)entries, 0, bytes);
     } else {
-        countOverwrite++;
+        entries = (CacheEntry*)calloc(buckets, sizeof(CacheEntry));
     }
-    /* overwrite */
-    entry.setResult(ans);
-    table[id] = entry;
-#ifdef REXBDD_CACHE_TRACE
-    std::cout << "entry ID = " << id << ": a: ";
-    entry.key[0].print(std::cout);
-    std::cout << " ans: ";
-    entry.res.print(std::cout);
-    std::cout << std::endl;
-    std::cout << "table entry: a: ";
-    table[id].key[0].print(std::cout);
-    std::cout << " ans: ";
-    table[id].res.print(std::cout);
-    std::cout << std::endl;
-#endif
+    if (!entries) {
+        std::cout << "[REXBDD] ERROR!\t Malloc fail for compute table!"<< std::endl;
+        exit(0);
+    }
+    return entries;
+}
+
+bool ComputeTable::check(const uint16_t lvl, const Edge& a, Edge& ans)
+{
+    return find(lvl, a.getEdgeHandle(), 0, 1, ans);
 }
+
+bool ComputeTable::check(const uint16_t lvl, const Edge& a, const Edge& b, Edge& ans)
+{
+    return find(lvl, a.getEdgeHandle(), b.getEdgeHandle(), 2, ans);
+}
+
+void ComputeTable::add(const uint16_t lvl, const Edge& a, const Edge& ans)
+{
+    insert(lvl, a.getEdgeHandle(), 0, 1, ans);
+}
+
 void ComputeTable::add(const uint16_t lvl, const Edge& a, const Edge& b, const Edge& ans)
 {
 #ifdef REXBDD_CACHE_TRACE
@@ -107,79 +123,221 @@ void ComputeTable::add(const uint16_t lvl, const Edge& a, const Edge& b, const E
     ans.print(std::cout);
     std::cout << std::endl;
 #endif
-    /* Check if we should enlage the table when  */
-    uint64_t size = PRIMES[sizeIndex] ? PRIMES[sizeIndex] : ((uint64_t)0x01 << 60);
-    if ((numEnries > (size / 1.5)) && (numEnries < (uint64_t)0x01 << 60)) {
+    insert(lvl, a.getEdgeHandle(), b.getEdgeHandle(), 2, ans);
+}
+
+bool ComputeTable::find(const uint16_t lvl, const EdgeHandle a, const EdgeHandle b, const uint8_t keySize, Edge& ans)
+{
+    uint64_t id = CacheEntry::hash(opTag, lvl, a, b) % getSize();
 #ifdef REXBDD_CACHE_TRACE
-    std::cout << "enlarge table: entries = " << numEnries << ", size = " << size << std::endl;
+    std::cout << "checking in cache, id = " << id << "; size = " << getSize() << std::endl;
 #endif
-        sizeIndex++;
-        size = PRIMES[sizeIndex] ? PRIMES[sizeIndex] : ((uint64_t)0x01 << 60);
-        enlarge(size);
+    if (isConcurrent) return findShared(id, lvl, a, b, keySize, ans);
+    return findIn(id, lvl, a, b, keySize, ans);
+}
+
+bool ComputeTable::findIn(const uint64_t id, const uint16_t lvl, const EdgeHandle a, const EdgeHandle b, const uint8_t keySize, Edge& ans)
+{
+    CacheEntry* bucket = table + id * ways;
+    for (int w=0; w<ways; w++) {
+        /* Valid entry, then check if match */
+        if (bucket[w].matches(opTag, lvl, a, b, keySize)) {
+            countHits++;
+            countWayHits[w]++;
+            if (ways > 1) touch(bucket, w);
+            ans.setEdgeHandle(bucket[w].res);
+            return 1;
+        }
     }
-    CacheEntry entry(lvl, a, b);
-#ifdef REXBDD_CACHE_TRACE
-    std::cout << "compute hash\n";
-#endif
-    uint64_t id = entry.hash() % size;
+    /* Not cached */
+    countMisses++;
+    return 0;
+}
+
+void ComputeTable::insert(const uint16_t lvl, const EdgeHandle a, const EdgeHandle b, const uint8_t keySize, const Edge& ans)
+{
+    /* Check if we should enlage the table when  */
+    if (!isConcurrent && isOverloaded(numEnries, getSize())) {
 #ifdef REXBDD_CACHE_TRACE
-    std::cout << "compute hash done\n";
+    std::cout << "enlarge table: entries = " << numEnries << ", size = " << getSize() << std::endl;
 #endif
+        enlarge(sizeIndex + 1);
+    }
+    uint64_t size = getSize();
+    uint64_t id = CacheEntry::hash(opTag, lvl, a, b) % size;
+    if (isConcurrent) {
+        insertShared(id, lvl, a, b, keySize, ans);
+        return;
+    }
+    insertIn(id, lvl, a, b, keySize, ans);
+}
+
+void ComputeTable::insertIn(const uint64_t id, const uint16_t lvl, const EdgeHandle a, const EdgeHandle b, const uint8_t keySize, const Edge& ans)
+{
+    CacheEntry* bucket = table + id * ways;
+    /* Choose the way: the same key, an unused entry, or the oldest one */
+    int way = 0;
+    for (int w=0; w<ways; w++) {
+        if (!bucket[w].isInUse() || bucket[w].matches(opTag, lvl, a, b, keySize)) {
+            way = w;
+            break;
+        }
+        if (bucket[w].age > bucket[way].age) way = w;
+    }
     /* new entry */
-    if (!table[id].isInUse) {
+    if (!bucket[way].isInUse()) {
         numEnries++;
-    } else {
+    } else if (!bucket[way].matches(opTag, lvl, a, b, keySize)) {
         countOverwrite++;
+        countWayEvicts[way]++;
     }
     /* overwrite */
-    entry.setResult(ans);
-    table[id] = entry;
+    bucket[way].set(opTag, lvl, a, b, keySize, ans.getEdgeHandle());
+    if (ways > 1) touch(bucket, way);
 #ifdef REXBDD_CACHE_TRACE
-    std::cout << "entry ID = " << id << ": a: ";
-    entry.key[0].print(std::cout);
-    std::cout << " b: ";
-    entry.key[1].print(std::cout);
-    std::cout << " ans: ";
-    entry.res.print(std::cout);
-    std::cout << std::endl;
-    std::cout << "table entry: a: ";
-    table[id].key[0].print(std::cout);
-    std::cout << " b: ";
-    table[id].key[1].print(std::cout);
-    std::cout << " ans: ";
-    table[id].res.print(std::cout);
-    std::cout << std::endl;
+    std::cout << "entry ID = " << id << ", way = " << way << ": a: " << a << " b: " << b
+              << " ans: " << bucket[way].res << std::endl;
 #endif
 }
 
-void ComputeTable::sweep()
+bool ComputeTable::findShared(const uint64_t id, const uint16_t lvl, const EdgeHandle a, const EdgeHandle b, const uint8_t keySize, Edge& ans)
+{
+    WorkerStats& stats = workerStats[WorkPool::workerIndex()];
+    CacheEntry* bucket = table + id * ways;
+    CacheEntry entry;
+    for (int w=0; w<ways; w++) {
+        // a torn copy is a miss
+        if (entry.snapshot(bucket[w]) && entry.matches(opTag, lvl, a, b, keySize)) {
+            stats.hits++;
+            ans.setEdgeHandle(entry.res);
+            return 1;
+        }
+    }
+    stats.misses++;
+    return 0;
+}
+
+void ComputeTable::insertShared(const uint64_t id, const uint16_t lvl, const EdgeHandle a, const EdgeHandle b, const uint8_t keySize, const Edge& ans)
+{
+    WorkerStats& stats = workerStats[WorkPool::workerIndex()];
+    CacheEntry* bucket = table + id * ways;
+    /* Choose the way: the same key, an unused entry, or else round robin; ages are not kept */
+    int way = -1;
+    bool isNew = 0;
+    CacheEntry entry;
+    for (int w=0; w<ways; w++) {
+        if (!entry.snapshot(bucket[w])) continue;
+        if (!entry.isInUse() || entry.matches(opTag, lvl, a, b, keySize)) {
+            way = w;
+            isNew = !entry.isInUse();
+            break;
+        }
+    }
+    bool isEvict = (way < 0);
+    if (isEvict) way = (int)((stats.inserts + stats.overwrites) % ways);
+    entry.set(opTag, lvl, a, b, keySize, ans.getEdgeHandle());
+    // if another worker is writing the same entry, ours is simply lost
+    if (!entry.publish(bucket[way])) return;
+    if (isNew) stats.inserts++;
+    if (isEvict) stats.overwrites++;
+}
+
+void ComputeTable::setForests(Forest* key0, Forest* key1, Forest* res)
 {
-    //
+    /* Registered once in each distinct forest */
+    for (int i=0; i<3; i++) {
+        if (isFirstForest(i)) forests[i]->unregisterCache(this);
+    }
+    forests[0] = key0;
+    forests[1] = key1;
+    forests[2] = res;
+    for (int i=0; i<3; i++) {
+        if (isFirstForest(i)) forests[i]->registerCache(this);
+    }
+}
+
+void ComputeTable::sweep(const Forest* forest)
+{
+    uint64_t size = getSize() * ways;
+    for (uint64_t i=0; i<size; i++) {
+        if (!table[i].isInUse()) continue;
+        const EdgeHandle edges[3] = {table[i].key[0], table[i].key[1], table[i].res};
+        bool isDead = 0;
+        for (int k=0; k<3 && !isDead; k++) {
+            if ((forests[k] != forest) || (k == 1 && table[i].keySize < 2)) continue;
+            // terminal edges are always alive
+            if (unpackLevel(edges[k]) == 0) continue;
+            isDead = !forest->getNode(unpackLevel(edges[k]), unpackTarget(edges[k])).isMarked();
+        }
+        if (isDead) {
+            memset((void*)(table + i), 0, sizeof(CacheEntry));
+            numEnries--;
+        }
+    }
+}
+
+void ComputeTable::clear()
+{
+    memset((void*)table, 0, getSize() * ways * sizeof(CacheEntry));
+    numEnries = 0;
+}
+
+void ComputeTable::detach(const Forest* forest)
+{
+    clear();
+    for (int i=0; i<3; i++) {
+        if (forests[i] == forest) forests[i] = 0;
+    }
 }
 
 void ComputeTable::reportStat(std::ostream& out, int format) const
 {
     if (format == 0) {
-        uint64_t size = PRIMES[sizeIndex] ? PRIMES[sizeIndex] : ((uint64_t)0x01 << 60);
         out << "Computing Table Statistics: \n";
-        out << "Size: \t\t" << size << "\n";
+        out << "Size: \t\t" << getSize() * ways << "\n";
+        out << "Ways: \t\t" << ways << "\n";
         out << "Ents: \t\t" << numEnries << "\n";
         out << "Hits: \t\t" << countHits << "\n";
+        out << "Miss: \t\t" << countMisses << "\n";
         out << "OWs:  \t\t" << countOverwrite << "\n";
+        if (ways > 1) {
+            for (int w=0; w<ways; w++) {
+                out << "Way " << w << ": \t\thits " << countWayHits[w]
+                    << "; evictions " << countWayEvicts[w] << "\n";
+            }
+        }
+        for (int i=0; i<numWorkers; i++) {
+            out << "Worker " << i << ": \thits " << workerStats[i].hits
+                << "; misses " << workerStats[i].misses << "\n";
+        }
     }
 }
 
-void ComputeTable::enlarge(uint64_t newSize)
+void ComputeTable::enlarge(const int newIndex)
 {
-    // copy the old table
-    std::vector<CacheEntry> oldTable = table;
-    // resize the table
-    table.resize(newSize);
-    // rehash
-    for (size_t i=0; i<oldTable.size(); i++) {
-        if (oldTable[i].isInUse) {
-            table[oldTable[i].hash() % newSize] = oldTable[i];
+    // keep the old table
+    CacheEntry* oldTable = table;
+    uint64_t oldSize = getSize() * ways;
+    // the new table
+    sizeIndex = newIndex;
+    uint64_t newSize = getSize();
+    table = allocTable(newSize);
+    // rehash, keeping the younger entries when a bucket is full
+    numEnries = 0;
+    for (uint64_t i=0; i<oldSize; i++) {
+        if (!oldTable[i].isInUse()) continue;
+        CacheEntry* bucket = table + (oldTable[i].hash() % newSize) * ways;
+        int way = 0;
+        for (int w=0; w<ways; w++) {
+            if (!bucket[w].isInUse()) {
+                way = w;
+                break;
+            }
+            if (bucket[w].age > bucket[way].age) way = w;
         }
+        if (bucket[way].isInUse() && (bucket[way].age < oldTable[i].age)) continue;
+        if (!bucket[way].isInUse()) numEnries++;
+        bucket[way] = oldTable[i];
     }
-    oldTable.clear();
+    free(oldTable);
 }
@@ -4,6 +4,10 @@
 #include "../defines.h"
 #include "../forest.h"
 #include "../hash_stream.h"
+#include "work_pool.h"
+
+#include <atomic>
+#include <cstddef>
 
 namespace REXBDD {
     class CacheEntry;
@@ -17,70 +21,106 @@ namespace REXBDD {
 // *                                                                *
 // *                                                                *
 // ******************************************************************
+/** Fixed-size entry of the compute table: plain data only, so entries
+ *  are stored inline in the table and lookups never allocate.
+ *  32 bytes, two entries per cache line; the age is used for replacement
+ *  within a set-associative bucket.
+ *  When several threads share the table, each entry is a seqlock: the
+ *  sequence number (in the last word) is odd while a thread writes the
+ *  entry, and readers retry nothing, they simply miss on a torn copy.
+ *  Note: only edge handles are stored; edge values for edge-valued
+ *  forests TBD.
+ */
 class REXBDD::CacheEntry {
     /*-------------------------------------------------------------*/
     public:
     /*-------------------------------------------------------------*/
-    CacheEntry() {
-        lvl = 0;
-        keySize = 2;
-        key = std::vector<Edge>(keySize);
-        isInUse = 0;
-    }
-    CacheEntry(const uint16_t level, const Edge& a) {
-        lvl = level;
-        keySize = 1;
-        key = std::vector<Edge>(keySize);
-        key[0] = a;
-        isInUse = 0;
-    }
-    CacheEntry(const uint16_t level, const Edge& a, const Edge& b) {
-        lvl = level;
-        keySize = 2;
-        key = std::vector<Edge>(keySize);
+    inline void set(const uint8_t tag, const uint16_t level, const EdgeHandle a, const EdgeHandle b, const uint8_t size, const EdgeHandle r) {
         key[0] = a;
         key[1] = b;
-        isInUse = 0;
+        res = r;
+        lvl = level;
+        keySize = size;
+        op = tag;
+        age = 0;
     }
 
-    inline void setResult(const Edge& r) {
-        res = r;
-        // only be in use when the result is set
-        isInUse = 1;
+    inline bool isInUse() const {return keySize != 0;}
+
+    inline bool matches(const uint8_t tag, const uint16_t level, const EdgeHandle a, const EdgeHandle b, const uint8_t size) const {
+        return (key[0] == a) && (key[1] == b) && (lvl == level) && (keySize == size) && (op == tag);
     }
 
-    inline uint64_t hash() const {
+    static inline uint64_t hash(const uint8_t tag, const uint16_t level, const EdgeHandle a, const EdgeHandle b) {
         hash_stream hs;
         hs.start(0);
         // push info
-        hs.push(lvl);
-        for (char i=0; i<keySize; i++) {
-            hs.push(key[i].getEdgeHandle());
-        }
+        hs.push(((unsigned)tag << 16) | level, (unsigned)a, (unsigned)(a >> 32));
+        hs.push((unsigned)b, (unsigned)(b >> 32));
         // for edge valued, TBD
         return (uint64_t)hs.finish64();
     }
 
+    inline uint64_t hash() const {
+        return hash(op, lvl, key[0], key[1]);
+    }
+
+    /// Copy a shared entry; fails if it is being written, or was written meanwhile
+    inline bool snapshot(const CacheEntry& shared) {
+        const std::atomic<uint64_t>* w = words(shared);
+        uint64_t v[4];
+        v[3] = w[3].load(std::memory_order_acquire);
+        if (seqOf(v[3]) & 1) return 0;
+        for (int i=0; i<3; i++) v[i] = w[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (w[3].load(std::memory_order_relaxed) != v[3]) return 0;
+        memcpy((void*)this, v, sizeof(CacheEntry));
+        return 1;
+    }
+    /// Write this entry into a shared one; fails (the entry is lost) if another thread is writing it
+    inline bool publish(CacheEntry& shared) {
+        std::atomic<uint64_t>* w = words(shared);
+        uint64_t last = w[3].load(std::memory_order_relaxed);
+        uint16_t s = seqOf(last);
+        if (s & 1) return 0;
+        uint64_t locked = last;
+        memcpy((char*)&locked + SEQ_OFFSET, &++s, sizeof(s));
+        if (!w[3].compare_exchange_strong(last, locked, std::memory_order_relaxed)) return 0;
+        std::atomic_thread_fence(std::memory_order_release);
+        seq = s + 1;
+        uint64_t v[4];
+        memcpy(v, (const void*)this, sizeof(CacheEntry));
+        for (int i=0; i<3; i++) w[i].store(v[i], std::memory_order_relaxed);
+        w[3].store(v[3], std::memory_order_release);
+        return 1;
+    }
+
     /*-------------------------------------------------------------*/
     private:
     /*-------------------------------------------------------------*/
     friend class ComputeTable;
-
-    inline bool equals(const CacheEntry& e) const {
-        if (lvl != e.lvl) return 0;
-        for (char i=0; i<keySize; i++) {
-            if (key[i] != e.key[i]) return 0;
-        }
-        return 1;
+    /// The entry as four words, for the seqlock
+    static inline std::atomic<uint64_t>* words(const CacheEntry& e) {
+        return reinterpret_cast<std::atomic<uint64_t>*>(const_cast<CacheEntry*>(&e));
+    }
+    /// Offset of the sequence number within the last word
+    static const size_t SEQ_OFFSET = 6;
+    static inline uint16_t seqOf(const uint64_t last) {
+        uint16_t s;
+        memcpy(&s, (const char*)&last + SEQ_OFFSET, sizeof(s));
+        return s;
     }
 
-
-    std::vector<Edge>   key;
-    Edge                res;
-    uint16_t            lvl;
-    char                keySize;
-    bool                isInUse;
+    EdgeHandle          key[2];     // Key edge handles; the 2nd one is 0 for unary keys
+    EdgeHandle          res;        // Result edge handle
+    uint16_t            lvl;        // Level of the computation
+    uint8_t             keySize;    // Number of key edges; 0 for unused entry
+    uint8_t             op;         // Operation tag
+    uint8_t             age;        // Number of bucket accesses since last used, saturated
+    uint8_t             unused;
+    uint16_t            seq;        // Seqlock sequence number, for the shared table
 };
+static_assert(sizeof(REXBDD::CacheEntry) == 32, "compute table entries are 32 bytes");
 
 // ******************************************************************
 // *                                                                *
@@ -95,6 +135,35 @@ class REXBDD::ComputeTable {
     /*-------------------------------------------------------------*/
     ComputeTable();
     ~ComputeTable();
+    ComputeTable(const ComputeTable&) = delete;
+    ComputeTable& operator=(const ComputeTable&) = delete;
+
+    /// Set the tag of the operation owning this table
+    inline void setOpTag(const uint8_t tag) {opTag = tag;}
+    /**
+     * @brief Set the associativity: 1 (direct mapped), 2 or 4 ways per bucket.
+     * A 2-way bucket fills one cache line; a 4-way bucket fills two.
+     * This clears the table.
+     */
+    void setWays(const int numWays);
+    /**
+     * @brief Switch on/off the concurrent mode, where workers of a pool share this table
+     * without locks: entries are read and written as seqlocks, and a torn or contended
+     * entry is just a miss or a lost insertion. Hits and misses are then counted per
+     * worker (by WorkPool::workerIndex()), and the table is not enlarged until the mode
+     * is switched off: it is enlarged up front instead, to hold the expected entries.
+     *
+     * @param concurrent    If workers are about to share this table.
+     * @param numWorkers    Number of workers of the pool.
+     * @param numExpected   Number of entries the workers are expected to add.
+     */
+    void setConcurrent(const bool concurrent, const int numWorkers = 1, const uint64_t numExpected = 0);
+
+    /// Number of workers of the last concurrent mode
+    inline int getNumWorkers() const {return numWorkers;}
+    /// Hits and misses of a worker in the last concurrent mode
+    inline uint64_t getWorkerHits(const int worker) const {return workerStats[worker].hits;}
+    inline uint64_t getWorkerMisses(const int worker) const {return workerStats[worker].misses;}
 
     bool check(const uint16_t lvl, const Edge& a, Edge& ans);
     bool check(const uint16_t lvl, const Edge& a, const Edge& b, Edge& ans);
@@ -102,7 +171,21 @@ class REXBDD::ComputeTable {
     void add(const uint16_t lvl, const Edge& a, const Edge& ans);
     void add(const uint16_t lvl, const Edge& a, const Edge& b, const Edge& ans);
 
-    void sweep();
+    /**
+     * @brief Set the forests of the key edges and of the result edge; null for
+     * non-edge arguments or results. The table registers itself in these forests,
+     * so their garbage collections can sweep it.
+     */
+    void setForests(Forest* key0, Forest* key1, Forest* res);
+    /**
+     * @brief Remove the entries referring to unmarked nodes of the given forest.
+     * This is called by the forest's garbage collection, after marking.
+     */
+    void sweep(const Forest* forest);
+    /// Remove all entries
+    void clear();
+    /// Remove all entries, and forget the given forest that is going away
+    void detach(const Forest* forest);
 
     void reportStat(std::ostream& out, int format=0) const;
 
@@ -110,17 +193,71 @@ class REXBDD::ComputeTable {
     private:
     /*-------------------------------------------------------------*/
     /**
-     * @brief This will enlarge the table and rehash the old data with the new size
+     * @brief This will enlarge the table to the given index of PRIMES, and rehash the
+     * old data with the new size
      * 
      */
-    void enlarge(uint64_t newSize);
+    void enlarge(const int newIndex);
+    /// If a table of the given number of buckets needs enlarging to hold the given number of entries
+    inline bool isOverloaded(const uint64_t entries, const uint64_t buckets) const {
+        return (entries > (buckets * ways / 1.5)) && (entries < (uint64_t)0x01 << 60);
+    }
+
+    /// Lookup and insertion shared by the unary and binary keys
+    bool find(const uint16_t lvl, const EdgeHandle a, const EdgeHandle b, const uint8_t keySize, Edge& ans);
+    void insert(const uint16_t lvl, const EdgeHandle a, const EdgeHandle b, const uint8_t keySize, const Edge& ans);
+
+    /// Number of buckets
+    inline uint64_t getSize() const {
+        return PRIMES[sizeIndex] ? PRIMES[sizeIndex] : ((uint64_t)0x01 << 60);
+    }
+    /// Age every other valid entry in the bucket, and make the given way the youngest
+    inline void touch(CacheEntry* bucket, const int way) {
+        for (int w=0; w<ways; w++) {
+            if ((w != way) && bucket[w].isInUse() && (bucket[w].age < UINT8_MAX)) bucket[w].age++;
+        }
+        bucket[way].age = 0;
+    }
+    /// If forests[i] is a forest not listed before i
+    inline bool isFirstForest(const int i) const {
+        if (!forests[i]) return 0;
+        for (int j=0; j<i; j++) {
+            if (forests[j] == forests[i]) return 0;
+        }
+        return 1;
+    }
+    /// Allocate a cleared table for the given number of buckets
+    CacheEntry* allocTable(const uint64_t buckets) const;
+    /// Lookup and insertion within a bucket, by a single thread
+    bool findIn(const uint64_t id, const uint16_t lvl, const EdgeHandle a, const EdgeHandle b, const uint8_t keySize, Edge& ans);
+    void insertIn(const uint64_t id, const uint16_t lvl, const EdgeHandle a, const EdgeHandle b, const uint8_t keySize, const Edge& ans);
+    /// Lookup and insertion within a bucket, by one of the workers
+    bool findShared(const uint64_t id, const uint16_t lvl, const EdgeHandle a, const EdgeHandle b, const uint8_t keySize, Edge& ans);
+    void insertShared(const uint64_t id, const uint16_t lvl, const EdgeHandle a, const EdgeHandle b, const uint8_t keySize, const Edge& ans);
+
+    /// Counters of a worker, on their own cache line
+    struct alignas(64) WorkerStats {
+        uint64_t    hits;
+        uint64_t    misses;
+        uint64_t    inserts;        // New entries
+        uint64_t    overwrites;
+    };
 
-    std::vector<CacheEntry>     table;
+    CacheEntry*                 table;      // buckets of "ways" consecutive entries
     uint64_t                    numEnries;
     int                         sizeIndex;
+    int                         ways;       // Entries per bucket: 1, 2 or 4
+    uint8_t                     opTag;
+    bool                        isConcurrent;
+    WorkerStats*                workerStats;    // Counters of the workers in the last concurrent mode
+    int                         numWorkers;
+    Forest*                     forests[3];     // Forests of key[0], key[1] and res; null if not edges
 
     uint64_t                    countHits;
+    uint64_t                    countMisses;
     uint64_t                    countOverwrite;
+    uint64_t                    countWayHits[4];    // Hits by the way of the matched entry
+    uint64_t                    countWayEvicts[4];  // Evictions by the way of the replaced entry
 
 };
 
@@ -1,4 +1,5 @@
 #include "operation.h"
+#include "operations_generator.h"
 #include "../IO/out_dot.h"
 
 // #define REXBDD_TRACE_OPERATION
@@ -32,6 +33,12 @@ UnaryOperation::UnaryOperation(UnaryOperationType type, Forest* source, Forest*
     sourceForest = source;
     targetForest = target;
     targetType = OpndType::FOREST;
+    quantId = 0;
+    combineOp = 0;
+    inParallel = 0;
+    cache.setOpTag((uint8_t)type);
+    cache.setForests(source, 0, target);
+    if (target->getSetting().getCacheWays() != 1) cache.setWays(target->getSetting().getCacheWays());
 }
 UnaryOperation::UnaryOperation(UnaryOperationType type, Forest* source, OpndType target)
 :opType(type)
@@ -39,10 +46,16 @@ UnaryOperation::UnaryOperation(UnaryOperationType type, Forest* source, OpndType
     sourceForest = source;
     targetForest = source;
     targetType = target;
+    quantId = 0;
+    combineOp = 0;
+    inParallel = 0;
+    cache.setOpTag((uint8_t)type);
+    cache.setForests(source, 0, 0);
+    if (source->getSetting().getCacheWays() != 1) cache.setWays(source->getSetting().getCacheWays());
 }
 UnaryOperation::~UnaryOperation()
 {
-    cache.~ComputeTable();
+    // the compute table is destroyed as a member
 }
 
 void UnaryOperation::compute(const Func& source, Func& target)
@@ -64,14 +77,27 @@ void UnaryOperation::compute(const Func& source, Func& target)
                 ans = targetForest->normalizeEdge(numVars, ans);
             }
             target.setEdge(ans);
+            targetForest->autoMarkSweep();
+            targetForest->autoReorder();
             return;
         }
         // here is the forest that does not allow complement bit, recursively compute
-        ans = computeCOMPLEMENT(numVars, ans);
+        ans = (this->*targetForest->kernelOf<ComplementOf>())(numVars, ans);
+    } else if ((opType == UnaryOperationType::UOP_EQUANTIFY) || (opType == UnaryOperationType::UOP_UQUANTIFY)) {
+        // abstracted levels, in the current variable order
+        std::vector<bool> isQuant(numVars+1, 0);
+        for (size_t i=0; i<quantVars.size(); i++) isQuant[targetForest->getSetting().getLevel(quantVars[i])] = 1;
+        quantBelow.assign(numVars+1, 0);
+        for (uint16_t k=1; k<=numVars; k++) quantBelow[k] = quantBelow[k-1] + isQuant[k];
+        combineOp = (opType == UnaryOperationType::UOP_EQUANTIFY) ? UNION(targetForest, targetForest, targetForest)
+                                                                : INTERSECTION(targetForest, targetForest, targetForest);
+        ans = computeQUANTIFY(numVars, ans);
     } else {
         // TBD
     }
     target.setEdge(ans);
+    targetForest->autoMarkSweep();
+    targetForest->autoReorder();
     // other info TBD
 }
 void UnaryOperation::compute(const Func& source, long& target)
@@ -79,21 +105,77 @@ void UnaryOperation::compute(const Func& source, long& target)
     if (!checkForestCompatibility()) {
         throw error(ErrCode::INVALID_OPERATION, __FILE__, __LINE__);
     }
-    // TBD
+    uint16_t numVars = sourceForest->getSetting().getNumVars();
+    if (opType == UnaryOperationType::UOP_CARDINALITY) {
+        target = computeCARD(numVars, source.getEdge());
+    } else {
+        // TBD
+    }
 }
 void UnaryOperation::compute(const Func& source, double& target)
 {
     if (!checkForestCompatibility()) {
         throw error(ErrCode::INVALID_OPERATION, __FILE__, __LINE__);
     }
-    // TBD
+    uint16_t numVars = sourceForest->getSetting().getNumVars();
+    if (opType == UnaryOperationType::UOP_CARDINALITY) {
+        // counted in log space, so it does not overflow before the double does
+        target = std::exp2(sourceForest->cardinalityEdge<double>(numVars, source.getEdge()));
+    } else {
+        // TBD
+    }
+}
+void UnaryOperation::compute(const Func& source, BigInt& target)
+{
+    if (!checkForestCompatibility()) {
+        throw error(ErrCode::INVALID_OPERATION, __FILE__, __LINE__);
+    }
+    uint16_t numVars = sourceForest->getSetting().getNumVars();
+    if (opType == UnaryOperationType::UOP_CARDINALITY) {
+        target = sourceForest->cardinalityEdge<BigInt>(numVars, source.getEdge());
+    } else {
+        // TBD
+    }
+}
+void UnaryOperation::setQuantifiedVars(const std::vector<uint16_t>& vars)
+{
+    uint16_t numVars = sourceForest->getSetting().getNumVars();
+    std::vector<uint16_t> sorted = vars;
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    if (!sorted.empty() && ((sorted.front() == 0) || (sorted.back() > numVars))) {
+        std::cout << "[REXBDD] ERROR!\t UnaryOperation::setQuantifiedVars(): Invalid variable for quantification!" << std::endl;
+        exit(0);
+    }
+    quantVars = sorted;
+    std::map<std::vector<uint16_t>, uint64_t>::iterator it = quantIds.find(quantVars);
+    if (it == quantIds.end()) {
+        it = quantIds.insert(std::make_pair(quantVars, (uint64_t)quantIds.size())).first;
+    }
+    quantId = it->second;
+}
+void UnaryOperation::setConcurrent(const bool concurrent, const int numWorkers)
+{
+    inParallel = concurrent;
+    // the shared table is sized for about one entry per node of the forest
+    cache.setConcurrent(concurrent, numWorkers, targetForest->getCurrentNodes());
 }
 bool UnaryOperation::checkForestCompatibility() const
 {
     bool ans = 1;
-    // TBD
+    if ((opType == UnaryOperationType::UOP_EQUANTIFY) || (opType == UnaryOperationType::UOP_UQUANTIFY)) {
+        // sets in one forest, for now
+        ans = (sourceForest == targetForest)
+            && !sourceForest->getSetting().isRelation()
+            && (sourceForest->getSetting().getEncodeMechanism() == TERMINAL);
+    }
+    // others TBD
     return ans;
 }
+long UnaryOperation::computeCARD(const uint16_t lvl, const Edge& source)
+{
+    return (long)sourceForest->cardinalityEdge<uint64_t>(lvl, source);
+}
 Edge UnaryOperation::computeCOPY(const uint16_t lvl, const Edge& source)
 {
     // Direct return if the target forest is the source forest
@@ -108,34 +190,135 @@ Edge UnaryOperation::computeCOPY(const uint16_t lvl, const Edge& source)
     //TBD
     return ans;
 }
+template <class K>
 Edge UnaryOperation::computeCOMPLEMENT(const uint16_t lvl, const Edge& source)
 {
     /* Assuming this is within the same target forest
      Here is forest that does not allow complement bit */
     
     Edge ans;    
+    const int w = worker();
+    targetForest->stats->countOp(w);
+    ReductionRule rule = source.getRule();
+    // a pattern whose complemented rule is not in the forest, or that can not be merged
+    // onto a reduced node, is rebuilt from its parts
+    const ForestSetting& setting = targetForest->getSetting();
+    bool isNoMerge = (K::mergeType(setting) == NO_MERGE);
+    bool isRebuilt = !K::isRelation(setting) && (rule != RULE_X) && !isRuleI(rule)
+                    && (!K::hasRule(setting, compRule(rule))
+                        || (isNoMerge && (source.getNodeLevel() > 0)));
     // terminal case
-    if (source.getNodeLevel() == 0) {
+    if ((source.getNodeLevel() == 0) && !isRebuilt) {
         ans = source;
         ans.complement();
         return targetForest->normalizeEdge(lvl, ans);
     } else {
-        // check cache, TBD
-        std::vector<Edge> childEdges;
-        if (targetForest->getSetting().isRelation()) {
-            childEdges = std::vector<Edge>(4);
-        } else {
-            childEdges = std::vector<Edge>(2);
+        // check cache
+        targetForest->stats->countLookup(w);
+        if (cache.check(lvl, source, ans)) {
+            targetForest->stats->countHit(w);
+            return ans;
+        }
+        if (isRebuilt) {
+            // "any skipped variable = b gives A, else B": the same pattern of !A and !B
+            uint16_t m = source.getNodeLevel();
+            bool b = isRuleEH(rule) || isRuleAL(rule);
+            Edge any = computeCOMPLEMENT<K>(m, source.part(b));
+            Edge all = computeCOMPLEMENT<K>(m, source.part(!b));
+            ans = (b) ? targetForest->buildHalf(lvl, m+1, all, any, 0)
+                      : targetForest->buildHalf(lvl, m+1, any, all, 1);
+            cache.add(lvl, source, ans);
+            return ans;
         }
+        ChildEdges childEdges = targetForest->getNodeView(source.getNodeLevel(), source.getNodeHandle()).children();
         for (char i=0; (size_t)i<childEdges.size(); i++) {
-            childEdges[i] = targetForest->getChildEdge(source.getNodeLevel(), source.getNodeHandle(), i);
-            childEdges[i] = computeCOMPLEMENT(source.getNodeLevel()-1, childEdges[i]);
+            childEdges[i] = computeCOMPLEMENT<K>(source.getNodeLevel()-1, childEdges[i]);
         }
         EdgeLabel label = 0;
         packRule(label, compRule(source.getRule()));
-        ans = targetForest->reduceEdge(lvl, label, source.getNodeLevel(), childEdges, source.getValue());
+        if (isNoMerge && !K::isRelation(setting)) {
+            // the reduced node may not take the long X: lifted one level at a time
+            ans = targetForest->reduceEdge(source.getNodeLevel(), label, source.getNodeLevel(), childEdges);
+            ans = targetForest->liftEdge(source.getNodeLevel(), lvl, ans);
+        } else {
+            ans = targetForest->reduceEdge(lvl, label, source.getNodeLevel(), childEdges);
+        }
+        cache.add(lvl, source, ans);
+    }
+    return ans;
+}
+
+Edge UnaryOperation::computeQUANTIFY(const uint16_t lvl, const Edge& source)
+{
+    // Base case: constant, or no abstracted level left
+    if (source.isConstantZero() || source.isConstantOne() || (quantBelow[lvl] == 0)) return source;
+    Edge ans;
+    targetForest->stats->countOp(0);
+    // check cache here
+    Edge key;
+    key.setEdgeHandle((EdgeHandle)quantId);
+    targetForest->stats->countLookup(0);
+    if (cache.check(lvl, source, key, ans)) {
+        targetForest->stats->countHit(0);
+        return ans;
     }
-    // cache, TBD
+    bool isExist = (opType == UnaryOperationType::UOP_EQUANTIFY);
+    uint16_t m = source.getNodeLevel();
+    EdgeLabel root = 0;
+    packRule(root, RULE_X);
+    if (m == lvl) {
+        /* Short edge: the cofactors of the node, combined if its level is abstracted */
+        Edge child[2];
+        for (int c=0; c<2; c++) child[c] = targetForest->cofact(lvl, source, c);
+        Edge r0 = computeQUANTIFY(lvl-1, child[0]);
+        if (numQuantified(lvl-1, lvl)) {
+            // the other cofactor can not change an absorbing one
+            Edge u = ((isExist && r0.isConstantOne()) || (!isExist && r0.isConstantZero())) ? r0
+                    : (isExist) ? combineOp->computeUNION(lvl-1, r0, computeQUANTIFY(lvl-1, child[1]))
+                                : combineOp->computeINTERSECTION(lvl-1, r0, computeQUANTIFY(lvl-1, child[1]));
+            ans = targetForest->liftEdge(lvl-1, lvl, u);
+        } else {
+            ChildEdges down(2);
+            down[0] = r0;
+            down[1] = computeQUANTIFY(lvl-1, child[1]);
+            ans = targetForest->reduceEdge(lvl, root, lvl, down);
+        }
+    } else {
+        /* Long edge: "any skipped variable = b gives A, else B", or independent for X.
+         * Abstracting a skipped variable x gives A op (the pattern without x), and since the
+         * pattern is A or B, the pattern over the levels left with B replaced by A op B. */
+        ReductionRule rule = source.getRule();
+        bool b = isRuleEH(rule) || isRuleAL(rule);
+        Edge any = computeQUANTIFY(m, source.part(b));
+        Edge all = computeQUANTIFY(m, source.part(!b));
+        if (rule == RULE_X) {
+            ans = targetForest->liftEdge(m, lvl, any);
+        } else if (numQuantified(m, lvl) == 0) {
+            ans = (b) ? targetForest->buildHalf(lvl, m+1, all, any, 0)
+                      : targetForest->buildHalf(lvl, m+1, any, all, 1);
+        } else {
+            Edge cur = (isExist) ? combineOp->computeUNION(m, any, all)
+                                 : combineOp->computeINTERSECTION(m, any, all);
+            // runs of abstracted levels are lifted through, the others keep the pattern
+            uint16_t k = m;
+            while (k < lvl) {
+                bool isQuant = numQuantified(k, k+1);
+                uint16_t top = k+1;
+                while ((top < lvl) && ((bool)numQuantified(top, top+1) == isQuant)) top++;
+                if (isQuant) {
+                    cur = targetForest->liftEdge(k, top, cur);
+                } else {
+                    cur = (b) ? targetForest->buildHalf(top, k+1, cur, any, 0)
+                              : targetForest->buildHalf(top, k+1, any, cur, 1);
+                }
+                if (top < lvl) any = targetForest->liftEdge(k, top, any);
+                k = top;
+            }
+            ans = cur;
+        }
+    }
+    // save to cache
+    cache.add(lvl, source, key, ans);
     return ans;
 }
 
@@ -201,6 +384,46 @@ void UnaryList::searchRemove(UnaryOperation* uop)
     }
 }
 
+void UnaryList::removeForest(const Forest* f)
+{
+    UnaryOperation** link = &front;
+    while (*link) {
+        UnaryOperation* curr = *link;
+        if ((curr->sourceForest == f) || (curr->targetForest == f)) {
+            *link = curr->next;
+            delete curr;
+        } else {
+            link = &curr->next;
+        }
+    }
+}
+
+// ******************************************************************
+// *                                                                *
+// *                 BinaryOperation::ApplyTask class               *
+// *                                                                *
+// ******************************************************************
+/// A sub-problem of a parallel apply
+class BinaryOperation::ApplyTask : public Task {
+    public:
+    inline void set(BinaryOperation* o, Compute f, const uint16_t l, const Edge& e1, const Edge& e2) {
+        op = o;
+        compute = f;
+        lvl = l;
+        a = e1;
+        b = e2;
+    }
+    void run() override {
+        res = (op->*compute)(lvl, a, b);
+    }
+    private:
+    friend class BinaryOperation;
+    BinaryOperation*    op;
+    Compute             compute;
+    uint16_t            lvl;
+    Edge                a, b, res;
+};
+
 // ******************************************************************
 // *                                                                *
 // *                                                                *
@@ -214,10 +437,24 @@ BinaryOperation::BinaryOperation(BinaryOperationType type, Forest* source1, Fore
     source1Forest = source1;
     source2Forest = source2;
     resForest = res;
+    unionOp = 0;
+    compOp = 0;
+    pool = 0;
+    inParallel = 0;
+    parallelLevel = 0;
+    // binary tags follow the unary ones
+    cache.setOpTag(0x80 | (uint8_t)type);
+    // images work on the source forests; the others on copies in the result forest
+    if ((type == BinaryOperationType::BOP_PREIMAGE) || (type == BinaryOperationType::BOP_POSTIMAGE)) {
+        cache.setForests(source1, source2, source1);
+    } else {
+        cache.setForests(res, res, res);
+    }
+    if (res->getSetting().getCacheWays() != 1) cache.setWays(res->getSetting().getCacheWays());
 }
 BinaryOperation::~BinaryOperation()
 {
-    cache.~ComputeTable();
+    // the compute table is destroyed as a member
 }
 
 void BinaryOperation::compute(const Func& source1, const Func& source2, Func& res)
@@ -245,27 +482,46 @@ void BinaryOperation::compute(const Func& source1, const Func& source2, Func& re
         }
         cp2->compute(source2, source2Equ);
     }
+    // parallel apply, if the result forest asks for threads
+    int numThreads = resForest->getSetting().getNumThreads();
+    Compute f = elementwise();
+    if ((numThreads > 1) && f) {
+        pool = WorkPool::getPool(numThreads);
+        parallelLevel = resForest->getSetting().getParallelLevel();
+        // the workers complement operands without complement flags: created now, and shared
+        if (!compOp && (resForest->getSetting().getCompType() == NO_COMP)) compOp = COMPLEMENT(resForest, resForest);
+        pool->begin();
+        resForest->setConcurrent(1, pool->getNumWorkers());
+        // the shared table is sized for about one entry per node of the forest
+        cache.setConcurrent(1, pool->getNumWorkers(), resForest->getCurrentNodes());
+        if (compOp) compOp->setConcurrent(1, pool->getNumWorkers());
+        inParallel = 1;
+    }
     // compute the result
-    if (opType == BinaryOperationType::BOP_UNION) {
-        ans = computeUNION(numVars, source1Equ.getEdge(), source2Equ.getEdge());
-    } else if (opType == BinaryOperationType::BOP_INTERSECTION) {
-        ans = computeINTERSECTION(numVars, source1Equ.getEdge(), source2Equ.getEdge());
-    } else if (opType == BinaryOperationType::BOP_PREIMAGE) {
-        ans = computeIMAGE(numVars, source1.getEdge(), source2.getEdge(), 1);
-        Func ansEqu(source1.getForest(), ans);
-        cp1->compute(ansEqu, res);
-        return;
-    } else if (opType == BinaryOperationType::BOP_POSTIMAGE) {
-        ans = computeIMAGE(numVars, source1.getEdge(), source2.getEdge());
+    if (f) {
+        ans = (this->*f)(numVars, source1Equ.getEdge(), source2Equ.getEdge());
+    } else if ((opType == BinaryOperationType::BOP_PREIMAGE) || (opType == BinaryOperationType::BOP_POSTIMAGE)) {
+        // images work in the set forest, then the result is copied
+        unionOp = UNION(source1Forest, source1Forest, source1Forest);
+        ans = computeIMAGE(numVars, source1.getEdge(), source2.getEdge(), opType == BinaryOperationType::BOP_PREIMAGE);
         Func ansEqu(source1.getForest(), ans);
         cp1->compute(ansEqu, res);
         return;
     } else {
-        // TBD
+        throw error(ErrCode::INVALID_OPERATION, __FILE__, __LINE__);
+    }
+    if (inParallel) {
+        inParallel = 0;
+        if (compOp) compOp->setConcurrent(0);
+        cache.setConcurrent(0);
+        resForest->setConcurrent(0);
+        pool->end();
     }
     // passing result
     res.setEdge(ans);
     cache.reportStat(std::cout);
+    resForest->autoMarkSweep();
+    resForest->autoReorder();
 }
 
 void BinaryOperation::compute(const Func& source1, const ExplictFunc source2, Func& res)
@@ -276,168 +532,116 @@ void BinaryOperation::compute(const Func& source1, const ExplictFunc source2, Fu
 bool BinaryOperation::checkForestCompatibility() const
 {
     bool ans = 1;
-    // TBD
-    return ans;
-}
-Edge BinaryOperation::computeUNION(const uint16_t lvl, const Edge& source1, const Edge& source2)
-{
-    Edge ans;
-    Edge e1, e2;
-    // normalize edges
-    e1 = resForest->normalizeEdge(lvl, source1);
-    e2 = resForest->normalizeEdge(lvl, source2);
-
-    // Base case 1: two edges are the same
-    if (e1 == e2) return e1;
-    // Base case 2: two edges are complemented
-    // Base case 3: one edge is constant ONE edge
-    if (e1.isComplementTo(e2) || e1.isConstantOne() || e2.isConstantOne()) {
-        EdgeHandle constant = makeTerminal(INT, 1);
-        if (resForest->getSetting().getValType() == FLOAT) {
-            constant = makeTerminal(FLOAT, 1.0f);
-        }
-        ans.setEdgeHandle(constant);
-        ans = resForest->normalizeEdge(lvl, ans);
-        return ans;
-    }
-    // Base case 4: one edge is constant ZERO edge
-    if (e1.isConstantZero()) return e2;
-    if (e2.isConstantZero()) return e1;
-
-    uint16_t m1, m2;
-    m1 = e1.getNodeLevel();
-    m2 = e2.getNodeLevel();
-    // ordering
-    if (m1<m2) {
-        SWAP(e1, e2);
-        SWAP(m1, m2);
-    }
-    
-    // check cache here
-    if (cache.check(lvl, e1, e2, ans)) return ans;
-
-    // Case that edge1 is a short edge
-    if (m1 == lvl) {
-        Edge x1, y1, x2, y2;
-        x1 = resForest->cofact(lvl, e1, 0);
-        y1 = resForest->cofact(lvl, e1, 1);
-        x2 = resForest->cofact(lvl, e2, 0);
-        y2 = resForest->cofact(lvl, e2, 1);
-        std::vector<Edge> child(2);
-        child[0] = computeUNION(lvl-1, x1, x2);
-        child[1] = computeUNION(lvl-1, y1, y2);
-        EdgeLabel root = 0;
-        packRule(root, RULE_X);
-        ans = resForest->reduceEdge(lvl, root, lvl, child);
-
-        // save to cache
-        cache.add(lvl, e1, e2, ans);
-        return ans;
-    }
-
-    // Here we have m1>=m2, it's time to decide pattern types and use pattern operations
-    char t1, t2;
-    t1 = rulePattern(e1.getRule());
-    t2 = rulePattern(e2.getRule());
-    if (t1 == 'L') {
-        if (t2 == 'L' || t2 == 'U') {
-            ans = operateLL(lvl, e1, e2);
-        } else {
-            ans = operateLH(lvl, e1, e2);
+    if ((opType == BinaryOperationType::BOP_PREIMAGE) || (opType == BinaryOperationType::BOP_POSTIMAGE)) {
+        // a set and a relation over the same variables, in the same order
+        const ForestSetting& set = source1Forest->getSetting();
+        const ForestSetting& rel = source2Forest->getSetting();
+        ans = !set.isRelation() && rel.isRelation() && (set.getNumVars() == rel.getNumVars())
+            && (set.getEncodeMechanism() == TERMINAL) && (rel.getEncodeMechanism() == TERMINAL);
+        for (uint16_t k=1; ans && (k<=set.getNumVars()); k++) {
+            ans = (set.getVar(k) == rel.getVar(k));
         }
-    } else if (t1 == 'H') {
-        if (t2 == 'H' || t2 == 'U') {
-            ans = operateHH(lvl, e1, e2);
-        } else {
-            ans = operateLH(lvl, e2, e1);
+    } else if (elementwise()) {
+        // the recursions are on Boolean functions: minimum, maximum, multiply and the
+        // comparisons are only their Boolean counterparts on 0/1 values
+        const Forest* forests[3] = {source1Forest, source2Forest, resForest};
+        for (int i=0; ans && (i<3); i++) {
+            ans = (forests[i]->getSetting().getRangeType() == BOOLEAN) && (forests[i]->getSetting().getMaxRange() == 1);
         }
     } else {
-        if (t2 == 'L' || t2 == 'U') {
-            ans = operateLL(lvl, e1, e2);
-        } else {
-            ans = operateHH(lvl, e1, e2);
-        }
+        // plus, minus, divide, modulo: TBD
+        ans = 0;
     }
-    // save cache
-    cache.add(lvl, e1, e2, ans);
     return ans;
 }
-
-Edge BinaryOperation::computeINTERSECTION(const uint16_t lvl, const Edge& source1, const Edge& source2)
+template <uint8_t TT, class K>
+Edge BinaryOperation::computeElementwise(const uint16_t lvl, const Edge& source1, const Edge& source2)
 {
 #ifdef REXBDD_TRACE_OPERATION
-    std::cout << "compute INTERSECTION: lvl: " << lvl << "; e1: ";
+    std::cout << "compute elementwise " << (int)TT << ": lvl: " << lvl << "; e1: ";
     source1.print(std::cout);
     std::cout << "; e2: ";
     source2.print(std::cout);
     std::cout << std::endl;
 #endif
-
+    typedef ElementwiseRule<TT> Rule;
+    const Compute f = &BinaryOperation::computeElementwise<TT, K>;
     Edge ans;
     Edge e1, e2;
     // normalize edges
     e1 = resForest->normalizeEdge(lvl, source1);
     e2 = resForest->normalizeEdge(lvl, source2);
+    const int w = worker();
+    resForest->stats->countOp(w);
 
-    // Base case 1: two edges are the same
-    if (e1 == e2) return e1;
-    // Base case 2: two edges are complemented
-    // Base case 3: one edge is constant ZERO edge
-    if (e1.isComplementTo(e2) || e1.isConstantZero() || e2.isConstantZero()) {
-        EdgeHandle constant = makeTerminal(INT, 0);
-        if (resForest->getSetting().getValType() == FLOAT) {
-            constant = makeTerminal(FLOAT, 0.0f);
-        }
-        ans.setEdgeHandle(constant);
-        ans = resForest->normalizeEdge(lvl, ans);
-        return ans;
+    /* Terminal cases, resolved by the truth table:
+     * the result is a constant, an operand or its complement */
+    typename Rule::Outcome out;
+    const Edge* arg;
+    bool isComp = 0;
+    if (e1 == e2) {
+        // Base case 1: two edges are the same
+        out = Rule::same;
+        arg = &e1;
+    } else if (e1.isComplementTo(e2)) {
+        // Base case 2: two edges are complemented, "e1 op !e1" as a function of e1
+        out = Rule::complement;
+        arg = &e1;
+        isComp = 1;
+    } else if (e1.isConstantOne() || e1.isConstantZero()) {
+        // Base case 3: one edge is constant
+        out = Rule::constFirst(e1.isConstantOne());
+        arg = &e2;
+    } else if (e2.isConstantOne() || e2.isConstantZero()) {
+        out = Rule::constSecond(e2.isConstantOne());
+        arg = &e1;
+    } else {
+        arg = 0;
+    }
+    if (arg) {
+        if (out == Rule::ZERO) return constantEdge(resForest, lvl, 0);
+        if (out == Rule::ONE) return constantEdge(resForest, lvl, 1);
+        if (out == Rule::ARG) return *arg;
+        // with two complemented edges, "!e1" is e2
+        return (isComp) ? e2 : complementEdge<K>(lvl, *arg);
     }
-    // Base case 4: one edge is constant ONE edge
-    if (e1.isConstantOne()) return e2;
-    if (e2.isConstantOne()) return e1;
 
     uint16_t m1, m2;
     m1 = e1.getNodeLevel();
     m2 = e2.getNodeLevel();
-    // ordering
+    // ordering; the operands of a non-commutative operation are then swapped
+    bool isSwapped = 0;
     if (m1 < m2) {
         SWAP(e1, e2);
         SWAP(m1, m2);
+        isSwapped = !Rule::isCommutative;
     }
     
-    // check cache here
-    if (cache.check(lvl, e1, e2, ans)) return ans;
+    // check cache here, keyed by the operands in their order
+    const Edge& key1 = (isSwapped) ? e2 : e1;
+    const Edge& key2 = (isSwapped) ? e1 : e2;
+    resForest->stats->countLookup(w);
+    if (cache.check(lvl, key1, key2, ans)) {
+        resForest->stats->countHit(w);
+        return ans;
+    }
 
     // Case that edge1 is a short edge
     if (m1 == lvl) {
         Edge x1, y1, x2, y2;
-        x1 = resForest->cofact(lvl, e1, 0);
-        y1 = resForest->cofact(lvl, e1, 1);
-        x2 = resForest->cofact(lvl, e2, 0);
-        y2 = resForest->cofact(lvl, e2, 1);
-        std::vector<Edge> child(2);
-#ifdef REXBDD_TRACE_OPERATION
-    std::cout << "\trecursive 0 from level: " << lvl << std::endl;
-#endif
-        child[0] = computeINTERSECTION(lvl-1, x1, x2);
-#ifdef REXBDD_TRACE_OPERATION
-    std::cout << "\trecursive 1 from level: " << lvl << std::endl;
-#endif
-        child[1] = computeINTERSECTION(lvl-1, y1, y2);
+        x1 = resForest->cofact<K>(lvl, key1, 0);
+        y1 = resForest->cofact<K>(lvl, key1, 1);
+        x2 = resForest->cofact<K>(lvl, key2, 0);
+        y2 = resForest->cofact<K>(lvl, key2, 1);
+        ChildEdges child(2);
+        Edge a[2] = {x1, y1}, b[2] = {x2, y2};
+        computeSubs(f, lvl-1, 2, a, b, child.data());
         EdgeLabel root = 0;
         packRule(root, RULE_X);
         ans = resForest->reduceEdge(lvl, root, lvl, child);
 
         // save to cache
-#ifdef REXBDD_TRACE_OPERATION
-    std::cout << "\tcase 1: save to cache: ";
-    ans.print(std::cout);
-    std::cout << std::endl;
-#endif
-        cache.add(lvl, e1, e2, ans);
-#ifdef REXBDD_TRACE_OPERATION
-    std::cout << "\tsave done\n";
-#endif
+        cache.add(lvl, key1, key2, ans);
         return ans;
     }
 
@@ -447,43 +651,127 @@ Edge BinaryOperation::computeINTERSECTION(const uint16_t lvl, const Edge& source
     t2 = rulePattern(e2.getRule());
     if (t1 == 'L') {
         if (t2 == 'L' || t2 == 'U') {
-            ans = operateLL(lvl, e1, e2);
+            ans = operateLL<K>(f, lvl, e1, e2, isSwapped);
         } else {
-            ans = operateLH(lvl, e1, e2);
+            ans = operateLH<K>(f, lvl, e1, e2, isSwapped);
         }
     } else if (t1 == 'H') {
         if (t2 == 'H' || t2 == 'U') {
-            ans = operateHH(lvl, e1, e2);
+            ans = operateHH<K>(f, lvl, e1, e2, isSwapped);
         } else {
-            ans = operateLH(lvl, e2, e1);
+            ans = operateLH<K>(f, lvl, e2, e1, !isSwapped && !Rule::isCommutative);
         }
     } else {
         if (t2 == 'L' || t2 == 'U') {
-            ans = operateLL(lvl, e1, e2);
+            ans = operateLL<K>(f, lvl, e1, e2, isSwapped);
         } else {
-            ans = operateHH(lvl, e1, e2);
+            ans = operateHH<K>(f, lvl, e1, e2, isSwapped);
         }
     }
     // save cache
-#ifdef REXBDD_TRACE_OPERATION
-    std::cout << "\tcase 2: save to cache: ";
-    ans.print(std::cout);
-    std::cout << std::endl;
-#endif
-    cache.add(lvl, e1, e2, ans);
-#ifdef REXBDD_TRACE_OPERATION
-    std::cout << "\tsave done\n";
-#endif
+    cache.add(lvl, key1, key2, ans);
     return ans;
 }
+
+BinaryOperation::Compute BinaryOperation::elementwise() const
+{
+    switch (opType) {
+        case BinaryOperationType::BOP_UNION:
+        case BinaryOperationType::BOP_MAXIMUM:
+            return resForest->kernelOf<ElementwiseOf<TABLE_OR> >();
+        case BinaryOperationType::BOP_INTERSECTION:
+        case BinaryOperationType::BOP_MINIMUM:
+        case BinaryOperationType::BOP_MULTIPLY:
+            return resForest->kernelOf<ElementwiseOf<TABLE_AND> >();
+        case BinaryOperationType::BOP_DIFFERENCE:
+        case BinaryOperationType::BOP_GREATERTHAN:
+            return resForest->kernelOf<ElementwiseOf<TABLE_DIFFERENCE> >();
+        case BinaryOperationType::BOP_EQUAL:
+            return resForest->kernelOf<ElementwiseOf<TABLE_EQUAL> >();
+        case BinaryOperationType::BOP_NOTEQUAL:
+            return resForest->kernelOf<ElementwiseOf<TABLE_NOTEQUAL> >();
+        case BinaryOperationType::BOP_LESSTHAN:
+            return resForest->kernelOf<ElementwiseOf<TABLE_LESSTHAN> >();
+        case BinaryOperationType::BOP_LESSTHANEQ:
+            return resForest->kernelOf<ElementwiseOf<TABLE_LESSTHANEQ> >();
+        case BinaryOperationType::BOP_GREATERTHANEQ:
+            return resForest->kernelOf<ElementwiseOf<TABLE_GREATERTHANEQ> >();
+        default:
+            // plus, minus, divide: values beyond 0 and 1, TBD
+            return 0;
+    }
+}
+template <class K>
+Edge BinaryOperation::complementEdge(const uint16_t lvl, const Edge& edge)
+{
+    Edge ans = edge;
+    // the result forest allows complement flag
+    if (K::compType(resForest->getSetting()) != NO_COMP) {
+        ans.complement();
+        if (!K::hasRule(resForest->getSetting(), ans.getRule())) {
+            ans = resForest->normalizeEdge(lvl, ans);
+        }
+        return ans;
+    }
+    if (!compOp) compOp = COMPLEMENT(resForest, resForest);
+    return compOp->computeCOMPLEMENT<K>(lvl, ans);
+}
+Edge BinaryOperation::constantEdge(Forest* forest, const uint16_t lvl, const bool isOne) const
+{
+    Edge ans;
+    EdgeHandle constant = makeTerminal(INT, isOne ? 1 : 0);
+    if (forest->getSetting().getValType() == FLOAT) {
+        constant = makeTerminal(FLOAT, isOne ? 1.0f : 0.0f);
+    }
+    ans.setEdgeHandle(constant);
+    ans.setRule(RULE_X);
+    return forest->normalizeEdge(lvl, ans);
+}
 Edge BinaryOperation::computeIMAGE(const uint16_t lvl, const Edge& source1, const Edge& trans, bool isPre)
 {
-    //
     Edge ans;
-    //TBD
+    Forest* setForest = source1Forest;
+    Forest* relForest = source2Forest;
+    setForest->stats->countOp(0);
+
+    // Base case 1: empty set or relation
+    if (source1.isConstantZero() || trans.isConstantZero()) return constantEdge(setForest, lvl, 0);
+    // Base case 2: universal relation, every state is reached from a nonempty set
+    if (trans.isConstantOne() || (lvl == 0)) return constantEdge(setForest, lvl, 1);
+    // Base case 3: identity down to the terminal one, the image is the set itself
+    if ((trans.getNodeLevel() == 0) && (trans.getRule() == RULE_I0)
+        && (isTerminalOne(trans.getEdgeHandle()) ^ (trans.getComp() && (relForest->getSetting().getCompType() != NO_COMP)))) {
+        return source1;
+    }
+
+    // check cache here
+    setForest->stats->countLookup(0);
+    if (cache.check(lvl, source1, trans, ans)) {
+        setForest->stats->countHit(0);
+        return ans;
+    }
+    /* Post-image: child y is the union over x of the images of s[x] by r[x][y];
+     * pre-image: child x is the union over y of the images of s[y] by r[x][y] */
+    Edge s[2], r[4];
+    for (int c=0; c<2; c++) s[c] = setForest->cofact(lvl, source1, c);
+    for (int c=0; c<4; c++) r[c] = relForest->cofact(lvl, trans, c);
+    ChildEdges child(2);
+    for (int b=0; b<2; b++) {
+        // the relation children for (x, y) = (0, b) and (1, b), or (b, 0) and (b, 1)
+        Edge low = computeIMAGE(lvl-1, s[0], r[(isPre) ? 2*b : b], isPre);
+        Edge high = computeIMAGE(lvl-1, s[1], r[(isPre) ? 2*b+1 : 2+b], isPre);
+        child[b] = unionOp->computeUNION(lvl-1, low, high);
+    }
+    EdgeLabel root = 0;
+    packRule(root, RULE_X);
+    ans = setForest->reduceEdge(lvl, root, lvl, child);
+
+    // save to cache
+    cache.add(lvl, source1, trans, ans);
     return ans;
 }
-Edge BinaryOperation::operateLL(const uint16_t lvl, const Edge& e1, const Edge& e2)
+template <class K>
+Edge BinaryOperation::operateLL(Compute f, const uint16_t lvl, const Edge& e1, const Edge& e2, const bool isSwapped)
 {
 #ifdef REXBDD_TRACE_OPERATION
     std::cout << "operateLL: lvl: " << lvl << "; e1: ";
@@ -501,18 +789,14 @@ Edge BinaryOperation::operateLL(const uint16_t lvl, const Edge& e1, const Edge&
     x1 = e1.part(0);
     x2 = e2.part(0);
     y1 = e1.part(1);
-    y2 = (m1==m2) ? e2.part(1) : resForest->cofact(m1+1, e2, 1);
+    y2 = (m1==m2) ? e2.part(1) : resForest->cofact<K>(m1+1, e2, 1);
 
     Edge x, y;
-    if (opType == BinaryOperationType::BOP_UNION) {
-        x = computeUNION(m1, x1, x2);
-        y = computeUNION(m1, y1, y2);
-    } else if (opType == BinaryOperationType::BOP_INTERSECTION) {
-        x = computeINTERSECTION(m1, x1, x2);
-        y = computeINTERSECTION(m1, y1, y2);
-    }
-    // more operations TBD
-    Edge ans = resForest->buildHalf(lvl, m1+1, x, y, 0);
+    Edge a[2] = {x1, y1}, b[2] = {x2, y2}, r[2];
+    computeSubs(f, m1, 2, (isSwapped) ? b : a, (isSwapped) ? a : b, r);
+    x = r[0];
+    y = r[1];
+    Edge ans = resForest->buildHalf(lvl, m1+1, x, y, 1);
 #ifdef REXBDD_TRACE_OPERATION
     std::cout << "build Low with x: ";
     x.print(std::cout);
@@ -526,7 +810,8 @@ Edge BinaryOperation::operateLL(const uint16_t lvl, const Edge& e1, const Edge&
     return ans;
 
 }
-Edge BinaryOperation::operateHH(const uint16_t lvl, const Edge& e1, const Edge& e2)
+template <class K>
+Edge BinaryOperation::operateHH(Compute f, const uint16_t lvl, const Edge& e1, const Edge& e2, const bool isSwapped)
 {
 #ifdef REXBDD_TRACE_OPERATION
     std::cout << "operateHH: lvl: " << lvl << "; e1: ";
@@ -541,19 +826,15 @@ Edge BinaryOperation::operateHH(const uint16_t lvl, const Edge& e1, const Edge&
 
     Edge x1, x2, y1, y2;
     x1 = e1.part(0);
-    x2 = (m1==m2) ? e2.part(0) : resForest->cofact(m1+1, e2, 0);
+    x2 = (m1==m2) ? e2.part(0) : resForest->cofact<K>(m1+1, e2, 0);
     y1 = e1.part(1);
     y2 = e2.part(1);
 
     Edge x, y;
-    if (opType == BinaryOperationType::BOP_UNION) {
-        x = computeUNION(m1, x1, x2);
-        y = computeUNION(m1, y1, y2);
-    } else if (opType == BinaryOperationType::BOP_INTERSECTION) {
-        x = computeINTERSECTION(m1, x1, x2);
-        y = computeINTERSECTION(m1, y1, y2);
-    }
-    // more operations TBD
+    Edge a[2] = {x1, y1}, b[2] = {x2, y2}, r[2];
+    computeSubs(f, m1, 2, (isSwapped) ? b : a, (isSwapped) ? a : b, r);
+    x = r[0];
+    y = r[1];
     Edge ans = resForest->buildHalf(lvl, m1+1, x, y, 0);
 #ifdef REXBDD_TRACE_OPERATION
     std::cout << "build High with x: ";
@@ -568,7 +849,8 @@ Edge BinaryOperation::operateHH(const uint16_t lvl, const Edge& e1, const Edge&
     return ans;
 
 }
-Edge BinaryOperation::operateLH(const uint16_t lvl, const Edge& e1, const Edge& e2)
+template <class K>
+Edge BinaryOperation::operateLH(Compute f, const uint16_t lvl, const Edge& e1, const Edge& e2, const bool isSwapped)
 {
 #ifdef REXBDD_TRACE_OPERATION
     std::cout << "operateLH: lvl: " << lvl << "; e1: ";
@@ -590,40 +872,28 @@ Edge BinaryOperation::operateLH(const uint16_t lvl, const Edge& e1, const Edge&
         m = m1;
     } else if (m1>m2) {
         y1 = e1.part(1);
-        x2 = resForest->cofact(m1+1, e2, 0);
+        x2 = resForest->cofact<K>(m1+1, e2, 0);
         m = m1;
     } else {
-        y1 = resForest->cofact(m2+1, e1, 1);
+        y1 = resForest->cofact<K>(m2+1, e1, 1);
         x2 = e2.part(0);
         m = m2;
     }
     Edge x, y, z;
-    if (opType == BinaryOperationType::BOP_UNION) {
-        x = computeUNION(m, x1, x2);
-        z = computeUNION(m, y1, y2);
-        if (lvl - m == 1) {
-            EdgeLabel root = 0;
-            packRule(root, RULE_X);
-            std::vector<Edge> child(2);
-            child[0] = x;
-            child[1] = z;
-            return resForest->reduceEdge(lvl, root, lvl, child);
-        }
-        y = computeUNION(m, x1, y2);
-    } else if (opType == BinaryOperationType::BOP_INTERSECTION) {
-        x = computeINTERSECTION(m, x1, x2);
-        z = computeINTERSECTION(m, y1, y2);
-        if (lvl - m == 1) {
-            EdgeLabel root = 0;
-            packRule(root, RULE_X);
-            std::vector<Edge> child(2);
-            child[0] = x;
-            child[1] = z;
-            return resForest->reduceEdge(lvl, root, lvl, child);
-        }
-        y = computeINTERSECTION(m, x1, y2);
+    // sub-problems x, z, and y (only needed for a long umbrella)
+    Edge a[3] = {x1, y1, x1}, b[3] = {x2, y2, y2}, r[3];
+    computeSubs(f, m, (lvl - m == 1) ? 2 : 3, (isSwapped) ? b : a, (isSwapped) ? a : b, r);
+    x = r[0];
+    z = r[1];
+    if (lvl - m == 1) {
+        EdgeLabel root = 0;
+        packRule(root, RULE_X);
+        ChildEdges child(2);
+        child[0] = x;
+        child[1] = z;
+        return resForest->reduceEdge(lvl, root, lvl, child);
     }
-    // more operations TBD
+    y = r[2];
     Edge ans = resForest->buildUmb(lvl, m+1, x, y, z);
 #ifdef REXBDD_TRACE_OPERATION
     std::cout << "build Umbrella with x: ";
@@ -639,6 +909,25 @@ Edge BinaryOperation::operateLH(const uint16_t lvl, const Edge& e1, const Edge&
 #endif
     return ans;
 }
+void BinaryOperation::computeSubs(Compute f, const uint16_t lvl, const int num, const Edge* a, const Edge* b, Edge* res)
+{
+    if (!inParallel || (lvl < parallelLevel)) {
+        for (int i=0; i<num; i++) res[i] = (this->*f)(lvl, a[i], b[i]);
+        return;
+    }
+    // spawn all but the first sub-problem, and compute that one here
+    ApplyTask tasks[3];
+    for (int i=1; i<num; i++) {
+        tasks[i].set(this, f, lvl, a[i], b[i]);
+        pool->spawn(&tasks[i]);
+    }
+    res[0] = (this->*f)(lvl, a[0], b[0]);
+    // join in reverse order of spawning
+    for (int i=num-1; i>0; i--) {
+        pool->join(&tasks[i]);
+        res[i] = tasks[i].res;
+    }
+}
 // ******************************************************************
 // *                                                                *
 // *                       BinaryList  methods                      *
@@ -700,6 +989,20 @@ void BinaryList::searchRemove(BinaryOperation* bop)
     }
 }
 
+void BinaryList::removeForest(const Forest* f)
+{
+    BinaryOperation** link = &front;
+    while (*link) {
+        BinaryOperation* curr = *link;
+        if ((curr->source1Forest == f) || (curr->source2Forest == f) || (curr->resForest == f)) {
+            *link = curr->next;
+            delete curr;
+        } else {
+            link = &curr->next;
+        }
+    }
+}
+
 
 // // ******************************************************************
 // // *                                                                *
@@ -713,14 +1016,211 @@ void BinaryList::searchRemove(BinaryOperation* bop)
 //     //
 // }
 
-// // ******************************************************************
-// // *                                                                *
-// // *                                                                *
-// // *                 SaturationOperation  methods                   *
-// // *                                                                *
-// // *                                                                *
-// // ******************************************************************
-// SaturationOperation::SaturationOperation()
-// {
-//     //
-// }
\ No newline at end of file
+// ******************************************************************
+// *                                                                *
+// *                                                                *
+// *                 SaturationOperation  methods                   *
+// *                                                                *
+// *                                                                *
+// ******************************************************************
+SaturationOperation::SaturationOperation(Forest* source, Forest* trans)
+{
+    next = 0;
+    sourceForest = source;
+    transForest = trans;
+    unionOp = 0;
+    iterations = 0;
+    // tags after the unary ones, before the binary ones
+    cache.setOpTag(0x40);
+    cache.setForests(source, 0, source);
+    fireCache.setOpTag(0x41);
+    fireCache.setForests(source, trans, source);
+    if (source->getSetting().getCacheWays() != 1) {
+        cache.setWays(source->getSetting().getCacheWays());
+        fireCache.setWays(source->getSetting().getCacheWays());
+    }
+}
+SaturationOperation::~SaturationOperation()
+{
+    //
+}
+
+void SaturationOperation::compute(const Func& source, const FuncArray& forwards, Func& res)
+{
+    if (!checkForestCompatibility() || !source.isAttachedTo(sourceForest) || !res.isAttachedTo(sourceForest)
+        || ((forwards.size() > 0) && !forwards.isAttachedTo(transForest))) {
+        throw error(ErrCode::INVALID_OPERATION, __FILE__, __LINE__);
+    }
+    uint16_t numVars = sourceForest->getSetting().getNumVars();
+    /* The computing tables are only valid for the same relations */
+    std::vector<std::vector<Edge> > groups(numVars+1);
+    groupRelations(forwards, groups);
+    if (groups != relations) {
+        relations = groups;
+        roots.clear();
+        for (uint16_t k=1; k<=numVars; k++) {
+            for (size_t i=0; i<relations[k].size(); i++) roots.push_back(Func(transForest, relations[k][i]));
+        }
+        cache.clear();
+        fireCache.clear();
+    }
+    unionOp = UNION(sourceForest, sourceForest, sourceForest);
+    iterations = 0;
+    Edge ans = saturate(numVars, source.getEdge());
+    res.setEdge(ans);
+    // nodes are only added until the next garbage collection
+    uint64_t peak = sourceForest->getCurrentNodes();
+    sourceForest->stats->notePeak(peak);
+    sourceForest->stats->recordSaturation(iterations, peak);
+    sourceForest->autoMarkSweep();
+    sourceForest->autoReorder();
+}
+
+bool SaturationOperation::checkForestCompatibility() const
+{
+    // a set and a relation over the same variables, in the same order
+    const ForestSetting& set = sourceForest->getSetting();
+    const ForestSetting& rel = transForest->getSetting();
+    bool ans = !set.isRelation() && rel.isRelation() && (set.getNumVars() == rel.getNumVars())
+            && (set.getEncodeMechanism() == TERMINAL) && (rel.getEncodeMechanism() == TERMINAL);
+    for (uint16_t k=1; ans && (k<=set.getNumVars()); k++) {
+        ans = (set.getVar(k) == rel.getVar(k));
+    }
+    return ans;
+}
+
+void SaturationOperation::groupRelations(const FuncArray& forwards, std::vector<std::vector<Edge> >& groups) const
+{
+    uint16_t numVars = transForest->getSetting().getNumVars();
+    for (int i=0; i<forwards.size(); i++) {
+        Edge trans = forwards[i].getEdge();
+        // go down while the relation is the identity at the level
+        uint16_t k = numVars;
+        for (; k>0; k--) {
+            Edge r[4];
+            for (int c=0; c<4; c++) r[c] = transForest->cofact(k, trans, c);
+            if (!r[1].isConstantZero() || !r[2].isConstantZero() || (r[0] != r[3])) break;
+            trans = r[0];
+        }
+        // the identity, or the empty relation, adds no states
+        if (k > 0) groups[k].push_back(trans);
+    }
+}
+
+Edge SaturationOperation::saturate(const uint16_t lvl, const Edge& source)
+{
+    Edge ans;
+    sourceForest->stats->countOp(0);
+    // Base case: the constant sets are saturated
+    if ((lvl == 0) || source.isConstantZero() || source.isConstantOne()) return source;
+
+    // check cache here
+    sourceForest->stats->countLookup(0);
+    if (cache.check(lvl, source, ans)) {
+        sourceForest->stats->countHit(0);
+        return ans;
+    }
+    ChildEdges child(2);
+    for (int c=0; c<2; c++) child[c] = saturate(lvl-1, sourceForest->cofact(lvl, source, c));
+    fixpoint(lvl, child.data());
+    EdgeLabel root = 0;
+    packRule(root, RULE_X);
+    ans = sourceForest->reduceEdge(lvl, root, lvl, child);
+
+    // save to cache
+    cache.add(lvl, source, ans);
+    return ans;
+}
+
+Edge SaturationOperation::recFire(const uint16_t lvl, const Edge& source, const Edge& trans)
+{
+    Edge ans;
+    sourceForest->stats->countOp(0);
+    // Base case 1: empty set or relation
+    if (source.isConstantZero() || trans.isConstantZero()) return unionOp->constantEdge(sourceForest, lvl, 0);
+    // Base case 2: universal relation
+    if (trans.isConstantOne() || (lvl == 0)) return unionOp->constantEdge(sourceForest, lvl, 1);
+    // Base case 3: identity down to the terminal one
+    if ((trans.getNodeLevel() == 0) && (trans.getRule() == RULE_I0)
+        && (isTerminalOne(trans.getEdgeHandle()) ^ (trans.getComp() && (transForest->getSetting().getCompType() != NO_COMP)))) {
+        return source;
+    }
+
+    // check cache here
+    sourceForest->stats->countLookup(0);
+    if (fireCache.check(lvl, source, trans, ans)) {
+        sourceForest->stats->countHit(0);
+        return ans;
+    }
+    /* The image, as in BinaryOperation::computeIMAGE, of saturated children; then saturate it here */
+    Edge s[2], r[4];
+    for (int c=0; c<2; c++) s[c] = sourceForest->cofact(lvl, source, c);
+    for (int c=0; c<4; c++) r[c] = transForest->cofact(lvl, trans, c);
+    ChildEdges child(2, unionOp->constantEdge(sourceForest, lvl-1, 0));
+    for (int y=0; y<2; y++) {
+        for (int x=0; x<2; x++) {
+            if (s[x].isConstantZero() || r[2*x+y].isConstantZero()) continue;
+            Edge image = recFire(lvl-1, s[x], r[2*x+y]);
+            child[y] = unionOp->computeUNION(lvl-1, child[y], image);
+        }
+    }
+    fixpoint(lvl, child.data());
+    EdgeLabel root = 0;
+    packRule(root, RULE_X);
+    ans = sourceForest->reduceEdge(lvl, root, lvl, child);
+
+    // save to cache
+    fireCache.add(lvl, source, trans, ans);
+    return ans;
+}
+
+void SaturationOperation::fixpoint(const uint16_t lvl, Edge* child)
+{
+    const std::vector<Edge>& group = relations[lvl];
+    if (group.empty()) return;
+    bool isChanged;
+    do {
+        isChanged = 0;
+        iterations++;
+        for (size_t i=0; i<group.size(); i++) {
+            Edge r[4];
+            for (int c=0; c<4; c++) r[c] = transForest->cofact(lvl, group[i], c);
+            // the children are updated in place, so a firing sees the states of the previous ones
+            for (int x=0; x<2; x++) {
+                for (int y=0; y<2; y++) {
+                    if (child[x].isConstantZero() || r[2*x+y].isConstantZero()) continue;
+                    Edge image = recFire(lvl-1, child[x], r[2*x+y]);
+                    Edge merged = unionOp->computeUNION(lvl-1, child[y], image);
+                    if (merged != child[y]) {
+                        child[y] = merged;
+                        isChanged = 1;
+                    }
+                }
+            }
+        }
+    } while (isChanged);
+}
+
+// ******************************************************************
+// *                                                                *
+// *                    SaturationList  methods                     *
+// *                                                                *
+// ******************************************************************
+SaturationList::SaturationList(const std::string n)
+{
+    reset(n);
+}
+
+void SaturationList::removeForest(const Forest* f)
+{
+    SaturationOperation** link = &front;
+    while (*link) {
+        SaturationOperation* curr = *link;
+        if ((curr->sourceForest == f) || (curr->transForest == f)) {
+            *link = curr->next;
+            delete curr;
+        } else {
+            link = &curr->next;
+        }
+    }
+}
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include "../defines.h"
 #include "../forest.h"
 #include "compute_table.h"
+#include "work_pool.h"
+
+#include <map>
 
 namespace REXBDD {
     class Operation;
@@ -63,6 +66,42 @@ namespace REXBDD {
     };
     class BinaryOperation;
     class BinaryList;
+    /**
+     * Truth tables of the elementwise operations on Boolean functions: bit 2a+b is
+     * "a op b". Equivalent operations (e.g. minimum and intersection) share a table.
+     */
+    enum ElementwiseTable : uint8_t {
+        TABLE_LESSTHAN      = 0x2,
+        TABLE_DIFFERENCE    = 0x4,      // also greater than
+        TABLE_NOTEQUAL      = 0x6,
+        TABLE_AND           = 0x8,      // also minimum and multiply
+        TABLE_EQUAL         = 0x9,
+        TABLE_LESSTHANEQ    = 0xB,
+        TABLE_GREATERTHANEQ = 0xD,
+        TABLE_OR            = 0xE       // also maximum
+    };
+    /**
+     * Terminal-case policy of an elementwise operation with truth table TT, evaluated
+     * at compile time: when the operands are equal, complementary, or one is constant,
+     * the result is a constant, one operand, or its complement.
+     */
+    template <uint8_t TT>
+    struct ElementwiseRule {
+        enum Outcome {ZERO, ONE, ARG, NEG_ARG};
+        static constexpr bool at(const bool a, const bool b) {return (TT >> (2*a + b)) & 1;}
+        /// The outcome of a function of one argument, from its values at 0 and at 1
+        static constexpr Outcome outcome(const bool v0, const bool v1) {
+            return (v0 == v1) ? (v0 ? ONE : ZERO) : (v1 ? ARG : NEG_ARG);
+        }
+        static constexpr bool isCommutative = (at(0,1) == at(1,0));
+        /// "a op a"
+        static constexpr Outcome same = outcome(at(0,0), at(1,1));
+        /// "a op !a", as a function of a
+        static constexpr Outcome complement = outcome(at(0,1), at(1,0));
+        /// "c op b" as a function of b, and "a op c" as a function of a
+        static constexpr Outcome constFirst(const bool c) {return outcome(at(c,0), at(c,1));}
+        static constexpr Outcome constSecond(const bool c) {return outcome(at(0,c), at(1,c));}
+    };
 
     /// Numerical operation
 
@@ -76,6 +115,7 @@ namespace REXBDD {
 
     extern UnaryList UOPs;
     extern BinaryList BOPs;
+    extern SaturationList SATs;
 };
 
 // ******************************************************************
@@ -120,6 +160,19 @@ class REXBDD::UnaryOperation : public Operation {
     void compute(const Func& source, Func& target);
     void compute(const Func& source, long& target);
     void compute(const Func& source, double& target);
+    void compute(const Func& source, BigInt& target);
+    /**
+     * @brief Set the variables abstracted by the quantifications (EQUANTIFY, UQUANTIFY),
+     * in any order and with repetitions. Each distinct set gets an id, which keys the
+     * computing table with the source edge, so results are kept across sets.
+     */
+    void setQuantifiedVars(const std::vector<uint16_t>& vars);
+    /**
+     * @brief Switch on/off the sharing of this operation by the workers of a parallel apply,
+     * which must have created it beforehand: the compute table is then shared (see
+     * ComputeTable::setConcurrent), and the forest counters are per worker.
+     */
+    void setConcurrent(const bool concurrent, const int numWorkers = 1);
     /*-------------------------------------------------------------*/
     protected:
     /*-------------------------------------------------------------*/
@@ -132,10 +185,32 @@ class REXBDD::UnaryOperation : public Operation {
     /// Helper Methods ==============================================
     bool checkForestCompatibility() const;
     Edge computeCOPY(const uint16_t lvl, const Edge& source);
+    /// Complement in a forest without complement flag, bound to the kernels K of the target forest
+    template <class K>
     Edge computeCOMPLEMENT(const uint16_t lvl, const Edge& source);
+    typedef Edge (UnaryOperation::*Complement)(const uint16_t, const Edge&);
+    /// Selector of computeCOMPLEMENT<K>, for Forest::kernelOf
+    struct ComplementOf {
+        typedef Complement Fn;
+        template <class K> static Fn of() {return &UnaryOperation::computeCOMPLEMENT<K>;}
+    };
     long computeCARD(const uint16_t lvl, const Edge& source);
+    /**
+     * @brief Existential or universal quantification of a set edge beginning at level "lvl",
+     * over the levels of the variables set by setQuantifiedVars. Levels skipped by a long
+     * edge are resolved by its rule without building nodes: an X edge is independent of
+     * them, and an EL/EH/AL/AH edge keeps its pattern over the levels that are not abstracted.
+     */
+    Edge computeQUANTIFY(const uint16_t lvl, const Edge& source);
+    /// Number of abstracted levels in (lo, hi]
+    inline uint16_t numQuantified(const uint16_t lo, const uint16_t hi) const {
+        return quantBelow[hi] - quantBelow[lo];
+    }
+    /// Index of the calling worker, for the per-worker counters
+    inline int worker() const {return (inParallel) ? WorkPool::workerIndex() : 0;}
     // list
     friend class UnaryList;
+    friend class BinaryOperation;
     // UnaryList&          parent;
     UnaryOperation*     next;
     // arguments
@@ -143,6 +218,14 @@ class REXBDD::UnaryOperation : public Operation {
     Forest*             targetForest;
     OpndType            targetType;
     UnaryOperationType  opType;
+    // quantifications
+    std::vector<uint16_t>   quantVars;      // The abstracted variables, sorted
+    uint64_t                quantId;        // Id of "quantVars", for the computing table
+    std::map<std::vector<uint16_t>, uint64_t> quantIds; // Ids of the sets so far
+    std::vector<uint16_t>   quantBelow;     // quantBelow[k]: number of abstracted levels up to k
+    BinaryOperation*        combineOp;      // Union or intersection of the cofactors
+    // parallel apply
+    bool                    inParallel;     // If the workers of a parallel apply share this operation
 };
 
 // ******************************************************************
@@ -188,6 +271,8 @@ class REXBDD::UnaryList {
         if ((front->opType == opT) && (front->sourceForest == sourceF) && (front->targetType == targetT)) return front;
         return mtfUnary(opT, sourceF, targetT);
     }
+    /// Remove and destroy the operations on the given forest, which is going away
+    void removeForest(const Forest* f);
     /*-------------------------------------------------------------*/
     private:
     /*-------------------------------------------------------------*/
@@ -223,15 +308,65 @@ class REXBDD::BinaryOperation : public Operation {
     /*-------------------------------------------------------------*/
     /// Helper Methods ==============================================
     bool checkForestCompatibility() const;
-    Edge computeUNION(const uint16_t lvl, const Edge& source1, const Edge& source2);
-    Edge computeINTERSECTION(const uint16_t lvl, const Edge& source1, const Edge& source2);
+    /**
+     * @brief Elementwise operation with truth table TT on two edges beginning at level "lvl":
+     * one recursion for all the operations, whose terminal cases are given by ElementwiseRule<TT>.
+     * Long edges are handled by the pattern operations operateLL/HH/LH. The recursion is bound
+     * to the kernels K of the result forest (see settings/kernels.h), as its reduction is.
+     */
+    template <uint8_t TT, class K>
+    Edge computeElementwise(const uint16_t lvl, const Edge& source1, const Edge& source2);
+    inline Edge computeUNION(const uint16_t lvl, const Edge& source1, const Edge& source2) {
+        return (this->*resForest->kernelOf<ElementwiseOf<TABLE_OR> >())(lvl, source1, source2);
+    }
+    inline Edge computeINTERSECTION(const uint16_t lvl, const Edge& source1, const Edge& source2) {
+        return (this->*resForest->kernelOf<ElementwiseOf<TABLE_AND> >())(lvl, source1, source2);
+    }
+    /// The constant 0 or 1 edge of a forest, beginning at level "lvl"
+    Edge constantEdge(Forest* forest, const uint16_t lvl, const bool isOne) const;
+    /// The complement of an edge of the result forest, beginning at level "lvl"
+    template <class K>
+    Edge complementEdge(const uint16_t lvl, const Edge& edge);
+    /**
+     * @brief Relational product: the image of a set edge by a relation edge, both beginning at
+     * level "lvl", in one recursion that conjoins and abstracts the current-state (or, for
+     * pre-images, next-state) variable of each level; the result is over the other one,
+     * renamed to the unprimed variable. Relation nodes have the children (x, x') in the
+     * order 00, 01, 10, 11. The result is in the set forest.
+     */
     Edge computeIMAGE(const uint16_t lvl, const Edge& source1, const Edge& trans, bool isPre = 0);
-    // elementwise related
-    Edge operateLL(const uint16_t lvl, const Edge& e1, const Edge& e2);
-    Edge operateHH(const uint16_t lvl, const Edge& e1, const Edge& e2);
-    Edge operateLH(const uint16_t lvl, const Edge& e1, const Edge& e2);
+    // parallel apply
+    class ApplyTask;
+    typedef Edge (BinaryOperation::*Compute)(const uint16_t, const Edge&, const Edge&);
+    /// Selector of computeElementwise<TT, K>, for Forest::kernelOf
+    template <uint8_t TT>
+    struct ElementwiseOf {
+        typedef Compute Fn;
+        template <class K> static Fn of() {return &BinaryOperation::computeElementwise<TT, K>;}
+    };
+    // elementwise related: "f" is the recursion of the sub-problems, "isSwapped" if e1 and e2
+    // are the second and first operands
+    template <class K>
+    Edge operateLL(Compute f, const uint16_t lvl, const Edge& e1, const Edge& e2, const bool isSwapped = 0);
+    template <class K>
+    Edge operateHH(Compute f, const uint16_t lvl, const Edge& e1, const Edge& e2, const bool isSwapped = 0);
+    template <class K>
+    Edge operateLH(Compute f, const uint16_t lvl, const Edge& e1, const Edge& e2, const bool isSwapped = 0);
+    /// The elementwise recursion of this operation, for the kernels of the result forest;
+    /// null if it is not elementwise on Boolean functions
+    Compute elementwise() const;
+    /**
+     * @brief Compute the sub-problems "f(lvl, a[i], b[i])" into res[i], for i < num (at most 3).
+     * In a parallel apply, the sub-problems at or above the parallel level are spawned as
+     * tasks to the work pool, except the first one, which is computed by the calling thread.
+     */
+    void computeSubs(Compute f, const uint16_t lvl, const int num, const Edge* a, const Edge* b, Edge* res);
+    /// Index of the calling worker, for the per-worker counters
+    inline int worker() const {return (inParallel) ? WorkPool::workerIndex() : 0;}
     // list
     friend class BinaryList;
+    friend class UnaryOperation;
+    friend class SaturationOperation;
     // BinaryList&         parent;
     BinaryOperation*    next;
     // arguments
@@ -240,6 +375,14 @@ class REXBDD::BinaryOperation : public Operation {
     OpndType            source2Type;
     Forest*             resForest;
     BinaryOperationType opType;
+    // images
+    BinaryOperation*    unionOp;        // Union in the set forest, for the abstracted variables
+    // elementwise
+    UnaryOperation*     compOp;         // Complement in the result forest, if it has no complement flag
+    // parallel apply
+    WorkPool*           pool;           // Work pool of the running parallel apply
+    bool                inParallel;     // If a parallel apply is running
+    uint16_t            parallelLevel;  // Lowest level of spawned sub-problems
 };
 
 // ******************************************************************
@@ -285,6 +428,8 @@ class REXBDD::BinaryList {
         if ((front->opType == opT) && (front->source1Forest == source1F) && (front->source2Type == source2T) && (front->resForest == resF)) return front;
         return mtfBinary(opT, source1F, source2T, resF);
     }
+    /// Remove and destroy the operations on the given forest, which is going away
+    void removeForest(const Forest* f);
     /*-------------------------------------------------------------*/
     private:
     /*-------------------------------------------------------------*/
@@ -322,21 +467,92 @@ class REXBDD::BinaryList {
 // *                                                                *
 // ******************************************************************
 
-// class REXBDD::SaturationOperation : public Operation {
-//     /*-------------------------------------------------------------*/
-//     public:
-//     /*-------------------------------------------------------------*/
-//     SaturationOperation();
-//     /*-------------------------------------------------------------*/
-//     protected:
-//     /*-------------------------------------------------------------*/
-//     virtual ~SaturationOperation();
-//     // computing tables TBD
+/** Reachable states of a set by saturation: the nodes are saturated bottom-up, and
+ *  the relations whose top level is k are fired at the nodes of level k, until
+ *  nothing changes, once their children are saturated. A relation is over all the
+ *  levels of its forest (BMxD, with the same variables and order as the set forest),
+ *  and is the identity above its top level, the highest level where it is not.
+ */
+class REXBDD::SaturationOperation : public Operation {
+    /*-------------------------------------------------------------*/
+    public:
+    /*-------------------------------------------------------------*/
+    SaturationOperation(Forest* source, Forest* trans);
+
+    /**
+     * @brief The states reachable from "source" by the transitions "forwards", in
+     * the source forest. The relations are grouped by their top levels on every call;
+     * the computing tables are kept as long as the relations are the same.
+     * The iterations (rounds of firing the relations of a node) and the peak nodes
+     * are recorded in the statistics of the source forest.
+     */
+    void compute(const Func& source, const FuncArray& forwards, Func& res);
+    /*-------------------------------------------------------------*/
+    protected:
+    /*-------------------------------------------------------------*/
+    virtual ~SaturationOperation();
 
-//     /*-------------------------------------------------------------*/
-//     private:
-//     /*-------------------------------------------------------------*/
-// };
+    /*-------------------------------------------------------------*/
+    private:
+    /*-------------------------------------------------------------*/
+    /// Helper Methods ==============================================
+    bool checkForestCompatibility() const;
+    /// Group the relations by top levels, into "relations"
+    void groupRelations(const FuncArray& forwards, std::vector<std::vector<Edge> >& groups) const;
+    /// The saturated set edge beginning at level "lvl"
+    Edge saturate(const uint16_t lvl, const Edge& source);
+    /// The saturated image of a saturated set edge by a relation edge, both beginning at level "lvl"
+    Edge recFire(const uint16_t lvl, const Edge& source, const Edge& trans);
+    /// Fire the relations of level "lvl" on the children of a node at that level, until nothing changes
+    void fixpoint(const uint16_t lvl, Edge* child);
+    // list
+    friend class SaturationList;
+    SaturationOperation*    next;
+    // arguments
+    Forest*                 sourceForest;
+    Forest*                 transForest;
+    std::vector<std::vector<Edge> > relations;  // relations[k]: of top level k, beginning at level k
+    std::vector<Func>       roots;              // The relations, kept alive for the computing tables
+    ComputeTable            fireCache;          // recFire; "cache" is for saturate
+    BinaryOperation*        unionOp;            // Union in the source forest
+    uint64_t                iterations;         // Rounds of firing in the running compute
+};
+
+// ******************************************************************
+// *                                                                *
+// *                     SaturationList  class                      *
+// *                                                                *
+// ******************************************************************
+
+class REXBDD::SaturationList {
+    std::string name;
+    SaturationOperation* front;
+    /*-------------------------------------------------------------*/
+    public:
+    /*-------------------------------------------------------------*/
+    SaturationList(const std::string n = "");
+    inline void reset(const std::string n) {
+        front = nullptr;
+        name = n;
+    }
+    inline std::string getName() const {return name;}
+    inline bool isEmpty() const {return !front;}
+    inline SaturationOperation* add(SaturationOperation* sop) {
+        if (sop) {
+            sop->next = front;
+            front = sop;
+        }
+        return sop;
+    }
+    inline SaturationOperation* find(const Forest* sourceF, const Forest* transF) {
+        for (SaturationOperation* curr = front; curr; curr = curr->next) {
+            if ((curr->sourceForest == sourceF) && (curr->transForest == transF)) return curr;
+        }
+        return nullptr;
+    }
+    /// Remove and destroy the operations on the given forest, which is going away
+    void removeForest(const Forest* f);
+};
 
 
 #endif
\ No newline at end of file
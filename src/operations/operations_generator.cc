@@ -3,6 +3,7 @@
 namespace REXBDD {
     UnaryList UOPs;
     BinaryList BOPs;
+    SaturationList SATs;
 }
 
 using namespace REXBDD;
@@ -34,6 +35,22 @@ UnaryOperation* REXBDD::COMPLEMENT(Forest* arg, Forest* res)
     return UOPs.add(new UnaryOperation(UnaryOperationType::UOP_COMPLEMENT, arg, res));
 }
 
+UnaryOperation* REXBDD::EQUANTIFY(Forest* arg, std::vector<uint16_t> val, Forest* res)
+{
+    if (!arg) return nullptr;
+    UnaryOperation* uop = UOPs.find(UnaryOperationType::UOP_EQUANTIFY, arg, res);
+    if (!uop) uop = UOPs.add(new UnaryOperation(UnaryOperationType::UOP_EQUANTIFY, arg, res));
+    uop->setQuantifiedVars(val);
+    return uop;
+}
+UnaryOperation* REXBDD::UQUANTIFY(Forest* arg, std::vector<uint16_t> val, Forest* res)
+{
+    if (!arg) return nullptr;
+    UnaryOperation* uop = UOPs.find(UnaryOperationType::UOP_UQUANTIFY, arg, res);
+    if (!uop) uop = UOPs.add(new UnaryOperation(UnaryOperationType::UOP_UQUANTIFY, arg, res));
+    uop->setQuantifiedVars(val);
+    return uop;
+}
 
 // ... TBD
 
@@ -45,8 +62,7 @@ BinaryOperation* REXBDD::UNION(Forest* arg1, Forest* arg2, Forest* res)
     if (arg1 > arg2) SWAP(arg1, arg2);
     BinaryOperation* bop = BOPs.find(BinaryOperationType::BOP_UNION, arg1, arg2, res);
     if (bop) return bop;
-    bop = new BinaryOperation(BinaryOperationType::BOP_UNION, arg1, arg2, res);
-    return bop;
+    return BOPs.add(new BinaryOperation(BinaryOperationType::BOP_UNION, arg1, arg2, res));
 }
 BinaryOperation* REXBDD::INTERSECTION(Forest* arg1, Forest* arg2, Forest* res)
 {
@@ -55,6 +71,116 @@ BinaryOperation* REXBDD::INTERSECTION(Forest* arg1, Forest* arg2, Forest* res)
     if (arg1 > arg2) SWAP(arg1, arg2);
     BinaryOperation* bop = BOPs.find(BinaryOperationType::BOP_INTERSECTION, arg1, arg2, res);
     if (bop) return bop;
-    bop = new BinaryOperation(BinaryOperationType::BOP_INTERSECTION, arg1, arg2, res);
-    return bop;
-}
\ No newline at end of file
+    return BOPs.add(new BinaryOperation(BinaryOperationType::BOP_INTERSECTION, arg1, arg2, res));
+}
+BinaryOperation* REXBDD::DIFFERENCE(Forest* arg1, Forest* arg2, Forest* res)
+{
+    if (!arg1 || !arg2) return nullptr;
+    BinaryOperation* bop = BOPs.find(BinaryOperationType::BOP_DIFFERENCE, arg1, arg2, res);
+    if (bop) return bop;
+    return BOPs.add(new BinaryOperation(BinaryOperationType::BOP_DIFFERENCE, arg1, arg2, res));
+}
+BinaryOperation* REXBDD::MINIMUM(Forest* arg1, Forest* arg2, Forest* res)
+{
+    if (!arg1 || !arg2) return nullptr;
+    // commute
+    if (arg1 > arg2) SWAP(arg1, arg2);
+    BinaryOperation* bop = BOPs.find(BinaryOperationType::BOP_MINIMUM, arg1, arg2, res);
+    if (bop) return bop;
+    return BOPs.add(new BinaryOperation(BinaryOperationType::BOP_MINIMUM, arg1, arg2, res));
+}
+BinaryOperation* REXBDD::MAXIMUM(Forest* arg1, Forest* arg2, Forest* res)
+{
+    if (!arg1 || !arg2) return nullptr;
+    // commute
+    if (arg1 > arg2) SWAP(arg1, arg2);
+    BinaryOperation* bop = BOPs.find(BinaryOperationType::BOP_MAXIMUM, arg1, arg2, res);
+    if (bop) return bop;
+    return BOPs.add(new BinaryOperation(BinaryOperationType::BOP_MAXIMUM, arg1, arg2, res));
+}
+BinaryOperation* REXBDD::MULTIPLY(Forest* arg1, Forest* arg2, Forest* res)
+{
+    if (!arg1 || !arg2) return nullptr;
+    // commute
+    if (arg1 > arg2) SWAP(arg1, arg2);
+    BinaryOperation* bop = BOPs.find(BinaryOperationType::BOP_MULTIPLY, arg1, arg2, res);
+    if (bop) return bop;
+    return BOPs.add(new BinaryOperation(BinaryOperationType::BOP_MULTIPLY, arg1, arg2, res));
+}
+BinaryOperation* REXBDD::EQUAL(Forest* arg1, Forest* arg2, Forest* res)
+{
+    if (!arg1 || !arg2) return nullptr;
+    // commute
+    if (arg1 > arg2) SWAP(arg1, arg2);
+    BinaryOperation* bop = BOPs.find(BinaryOperationType::BOP_EQUAL, arg1, arg2, res);
+    if (bop) return bop;
+    return BOPs.add(new BinaryOperation(BinaryOperationType::BOP_EQUAL, arg1, arg2, res));
+}
+BinaryOperation* REXBDD::NOT_EQUAL(Forest* arg1, Forest* arg2, Forest* res)
+{
+    if (!arg1 || !arg2) return nullptr;
+    // commute
+    if (arg1 > arg2) SWAP(arg1, arg2);
+    BinaryOperation* bop = BOPs.find(BinaryOperationType::BOP_NOTEQUAL, arg1, arg2, res);
+    if (bop) return bop;
+    return BOPs.add(new BinaryOperation(BinaryOperationType::BOP_NOTEQUAL, arg1, arg2, res));
+}
+BinaryOperation* REXBDD::LESS_THAN(Forest* arg1, Forest* arg2, Forest* res)
+{
+    if (!arg1 || !arg2) return nullptr;
+    BinaryOperation* bop = BOPs.find(BinaryOperationType::BOP_LESSTHAN, arg1, arg2, res);
+    if (bop) return bop;
+    return BOPs.add(new BinaryOperation(BinaryOperationType::BOP_LESSTHAN, arg1, arg2, res));
+}
+BinaryOperation* REXBDD::LESS_THAN_EQUAL(Forest* arg1, Forest* arg2, Forest* res)
+{
+    if (!arg1 || !arg2) return nullptr;
+    BinaryOperation* bop = BOPs.find(BinaryOperationType::BOP_LESSTHANEQ, arg1, arg2, res);
+    if (bop) return bop;
+    return BOPs.add(new BinaryOperation(BinaryOperationType::BOP_LESSTHANEQ, arg1, arg2, res));
+}
+BinaryOperation* REXBDD::GREATER_THAN(Forest* arg1, Forest* arg2, Forest* res)
+{
+    if (!arg1 || !arg2) return nullptr;
+    BinaryOperation* bop = BOPs.find(BinaryOperationType::BOP_GREATERTHAN, arg1, arg2, res);
+    if (bop) return bop;
+    return BOPs.add(new BinaryOperation(BinaryOperationType::BOP_GREATERTHAN, arg1, arg2, res));
+}
+BinaryOperation* REXBDD::GREATER_THAN_EQUAL(Forest* arg1, Forest* arg2, Forest* res)
+{
+    if (!arg1 || !arg2) return nullptr;
+    BinaryOperation* bop = BOPs.find(BinaryOperationType::BOP_GREATERTHANEQ, arg1, arg2, res);
+    if (bop) return bop;
+    return BOPs.add(new BinaryOperation(BinaryOperationType::BOP_GREATERTHANEQ, arg1, arg2, res));
+}
+BinaryOperation* REXBDD::PRE_IMAGE(Forest* arg1, Forest* arg2, Forest* res)
+{
+    if (!arg1 || !arg2) return nullptr;
+    BinaryOperation* bop = BOPs.find(BinaryOperationType::BOP_PREIMAGE, arg1, arg2, res);
+    if (bop) return bop;
+    return BOPs.add(new BinaryOperation(BinaryOperationType::BOP_PREIMAGE, arg1, arg2, res));
+}
+BinaryOperation* REXBDD::POST_IMAGE(Forest* arg1, Forest* arg2, Forest* res)
+{
+    if (!arg1 || !arg2) return nullptr;
+    BinaryOperation* bop = BOPs.find(BinaryOperationType::BOP_POSTIMAGE, arg1, arg2, res);
+    if (bop) return bop;
+    return BOPs.add(new BinaryOperation(BinaryOperationType::BOP_POSTIMAGE, arg1, arg2, res));
+}
+
+// Saturation operations
+SaturationOperation* REXBDD::SATURATION(Forest* set, Forest* trans)
+{
+    if (!set || !trans) return nullptr;
+    SaturationOperation* sop = SATs.find(set, trans);
+    if (sop) return sop;
+    return SATs.add(new SaturationOperation(set, trans));
+}
+Func REXBDD::saturate(Func set, FuncArray forwards)
+{
+    if (forwards.size() == 0) return set;
+    SaturationOperation* sop = SATURATION(set.getForest(), forwards.getForest());
+    Func res(set.getForest());
+    sop->compute(set, forwards, res);
+    return res;
+}
@@ -24,7 +24,8 @@ namespace REXBDD {
     UnaryOperation* CONCRETIZE_RST(Forest* arg1, SpecialValue arg2, Forest* res);
     UnaryOperation* CONCRETIZE_OSM(Forest* arg1, SpecialValue arg2, Forest* res);
     UnaryOperation* CONCRETIZE_TSM(Forest* arg1, SpecialValue arg2, Forest* res);
-    UnaryOperation* EQUANTIFY(Forest* arg, std::vector<uint16_t> val, Forest* res);  // 2-L?
+    /// Quantifications over the variables "val"; the operation is shared by all the sets of variables
+    UnaryOperation* EQUANTIFY(Forest* arg, std::vector<uint16_t> val, Forest* res);
     UnaryOperation* UQUANTIFY(Forest* arg, std::vector<uint16_t> val, Forest* res);
 
     UnaryOperation* REORDER(Forest* arg, Forest* res);
@@ -36,12 +37,12 @@ namespace REXBDD {
     // ******************************************************************
     class BinaryOperation;
     
-    // elementwise
+    // elementwise; on Boolean functions, except plus, minus, divide and modulo (TBD)
     BinaryOperation* UNION(Forest* arg1, Forest* arg2, Forest* res);
     BinaryOperation* INTERSECTION(Forest* arg1, Forest* arg2, Forest* res);
     BinaryOperation* DIFFERENCE(Forest* arg1, Forest* arg2, Forest* res);
-    BinaryOperation* MINIMUM(Forest* arg1, OpndType arg2, Forest* res);
-    BinaryOperation* MAXIMUM(Forest* arg1, OpndType arg2, Forest* res);
+    BinaryOperation* MINIMUM(Forest* arg1, Forest* arg2, Forest* res);
+    BinaryOperation* MAXIMUM(Forest* arg1, Forest* arg2, Forest* res);
     BinaryOperation* PLUS(Forest* arg1, OpndType arg2, Forest* res);
     BinaryOperation* MINUS(Forest* arg1, OpndType arg2, Forest* res);
     BinaryOperation* MULTIPLY(Forest* arg1, Forest* arg2, Forest* res);
@@ -58,6 +59,7 @@ namespace REXBDD {
     
     BinaryOperation* PRE_PLUS(Forest* arg1, Forest* arg2, Forest* res);
     BinaryOperation* POST_PLUS(Forest* arg1, Forest* arg2, Forest* res);
+    /// Images of a set (arg1) by a relation (arg2, over the same variables in the same order)
     BinaryOperation* PRE_IMAGE(Forest* arg1, Forest* arg2, Forest* res);
     BinaryOperation* POST_IMAGE(Forest* arg1, Forest* arg2, Forest* res);
 
@@ -79,11 +81,9 @@ namespace REXBDD {
     // *                      Saturation operations                     *
     // *                                                                *
     // ******************************************************************
-    //TBD
-    inline Func saturate(Func set, FuncArray forwards) {
-        // TBD
-        return set;
-    }
+    SaturationOperation* SATURATION(Forest* set, Forest* trans);
+    /// The states reachable from "set" by the transition relations "forwards", by saturation
+    Func saturate(Func set, FuncArray forwards);
 }
 
 #endif
\ No newline at end of file
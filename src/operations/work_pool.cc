@@ -0,0 +1,133 @@
+#include "work_pool.h"
+
+using namespace REXBDD;
+
+namespace REXBDD {
+    /// Index of the current thread in the pool
+    static thread_local int currentWorker = 0;
+    /// The process-wide pool
+    static WorkPool* sharedPool = 0;
+};
+
+// ******************************************************************
+// *                                                                *
+// *                                                                *
+// *                       WorkPool methods                         *
+// *                                                                *
+// *                                                                *
+// ******************************************************************
+
+WorkPool::WorkPool(const int num)
+:numWorkers(num<1 ? 1 : num), isActive(0), isStopping(0)
+{
+    queues = new Queue[numWorkers];
+    for (int i=1; i<numWorkers; i++) {
+        threads.emplace_back(&WorkPool::workerLoop, this, i);
+    }
+}
+WorkPool::~WorkPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        isStopping.store(1);
+    }
+    wakeUp.notify_all();
+    for (size_t i=0; i<threads.size(); i++) {
+        threads[i].join();
+    }
+    delete[] queues;
+}
+
+WorkPool* WorkPool::getPool(const int num)
+{
+    if (!sharedPool || (sharedPool->numWorkers < num)) {
+        delete sharedPool;
+        sharedPool = new WorkPool(num);
+    }
+    return sharedPool;
+}
+
+int WorkPool::workerIndex()
+{
+    return currentWorker;
+}
+
+void WorkPool::begin()
+{
+    sectionLock.lock();
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        isActive.store(1);
+    }
+    wakeUp.notify_all();
+}
+
+void WorkPool::end()
+{
+    isActive.store(0);
+    sectionLock.unlock();
+}
+
+void WorkPool::spawn(Task* task)
+{
+    Queue& q = queues[currentWorker];
+    std::lock_guard<std::mutex> guard(q.lock);
+    q.tasks.push_back(task);
+}
+
+void WorkPool::join(Task* task)
+{
+    while (!task->done.load(std::memory_order_acquire)) {
+        // Usually the task is still the newest one of ours, then run it here
+        Task* next = pop(currentWorker);
+        if (!next) next = steal(currentWorker);
+        if (next) {
+            execute(next);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+Task* WorkPool::pop(const int id)
+{
+    Queue& q = queues[id];
+    std::lock_guard<std::mutex> guard(q.lock);
+    if (q.tasks.empty()) return 0;
+    Task* task = q.tasks.back();
+    q.tasks.pop_back();
+    return task;
+}
+
+Task* WorkPool::steal(const int thief)
+{
+    for (int i=1; i<numWorkers; i++) {
+        Queue& q = queues[(thief + i) % numWorkers];
+        std::lock_guard<std::mutex> guard(q.lock);
+        if (q.tasks.empty()) continue;
+        Task* task = q.tasks.front();
+        q.tasks.pop_front();
+        return task;
+    }
+    return 0;
+}
+
+void WorkPool::workerLoop(const int id)
+{
+    currentWorker = id;
+    while (!isStopping.load()) {
+        if (!isActive.load()) {
+            // park until the next parallel section
+            std::unique_lock<std::mutex> guard(sleepLock);
+            wakeUp.wait(guard, [this] {return isActive.load() || isStopping.load();});
+            continue;
+        }
+        Task* task = pop(id);
+        if (!task) task = steal(id);
+        if (task) {
+            execute(task);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
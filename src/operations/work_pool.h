@@ -0,0 +1,112 @@
+#ifndef REXBDD_WORK_POOL_H
+#define REXBDD_WORK_POOL_H
+
+#include "../defines.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace REXBDD {
+    class Task;
+    class WorkPool;
+};
+
+// ******************************************************************
+// *                                                                *
+// *                                                                *
+// *                           Task class                           *
+// *                                                                *
+// *                                                                *
+// ******************************************************************
+/**
+ *  A unit of work for the pool. Tasks are owned by whoever spawns
+ *  them (usually on the stack), and must be joined before going away.
+ */
+class REXBDD::Task {
+    /*-------------------------------------------------------------*/
+    public:
+    /*-------------------------------------------------------------*/
+    Task():done(0) {}
+    virtual ~Task() {}
+    virtual void run() = 0;
+    /*-------------------------------------------------------------*/
+    private:
+    /*-------------------------------------------------------------*/
+    friend class WorkPool;
+    std::atomic<bool>   done;
+};
+
+// ******************************************************************
+// *                                                                *
+// *                                                                *
+// *                        WorkPool class                          *
+// *                                                                *
+// *                                                                *
+// ******************************************************************
+/**
+ *  Work-stealing pool of threads.
+ *
+ *  Each worker owns a deque of tasks: the owner pushes and pops at the
+ *  back, and idle workers steal from the front of the others. The thread
+ *  that starts a parallel section acts as worker 0; workers 1 ... n-1
+ *  are pool threads that only look for work inside a section.
+ *  Joining a task either runs it inline (if nobody stole it) or keeps
+ *  running other tasks until the thief finishes it.
+ */
+class REXBDD::WorkPool {
+    /*-------------------------------------------------------------*/
+    public:
+    /*-------------------------------------------------------------*/
+    WorkPool(const int numWorkers);
+    ~WorkPool();
+
+    /// The process-wide pool, with at least the given number of workers
+    static WorkPool* getPool(const int numWorkers);
+
+    inline int getNumWorkers() const {return numWorkers;}
+    /// Index of the calling thread in its pool; 0 for outside threads
+    static int workerIndex();
+
+    /// Start a parallel section; one section at a time per pool
+    void begin();
+    /// Finish a parallel section; all spawned tasks must have been joined
+    void end();
+
+    /// Push a task to the calling worker's deque
+    void spawn(Task* task);
+    /// Wait until the task is done, working meanwhile
+    void join(Task* task);
+
+    /*-------------------------------------------------------------*/
+    private:
+    /*-------------------------------------------------------------*/
+    /// Deque of a worker, padded to its own cache lines
+    struct alignas(64) Queue {
+        std::mutex          lock;
+        std::deque<Task*>   tasks;
+    };
+    /// Pop the newest task of the given worker
+    Task* pop(const int id);
+    /// Steal the oldest task of some other worker
+    Task* steal(const int thief);
+    /// Run a task and publish its completion
+    static inline void execute(Task* task) {
+        task->run();
+        task->done.store(1, std::memory_order_release);
+    }
+    void workerLoop(const int id);
+
+    int                         numWorkers;
+    Queue*                      queues;
+    std::vector<std::thread>    threads;
+    std::mutex                  sectionLock;    // Held during a parallel section
+    std::mutex                  sleepLock;
+    std::condition_variable     wakeUp;
+    std::atomic<bool>           isActive;       // If a parallel section is running
+    std::atomic<bool>           isStopping;
+};
+
+#endif
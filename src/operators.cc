@@ -124,8 +124,8 @@ namespace REXBDD {
     }
     Func operator^(const Func &e1, const Func &e2)
     {
-        Func out;
-        // implementations TBD
+        Func out(e1.getForest());
+        apply(NOT_EQUAL, e1, e2, out);
         return out;
     }
     Func operator!(const Func &e)
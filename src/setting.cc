@@ -12,14 +12,59 @@ using namespace REXBDD;
 
 VarDomain::VarDomain(uint16_t size)
 {
-    maxLevel = size;
-    // ordering TBD
+    setNumVars(size);
+}
+VarDomain::VarDomain(const std::vector<uint16_t>& order, uint16_t size)
+{
+    setNumVars(size);
+    /* order[k] is the variable at level k, for k = 1 ... size */
+    if (order.size() != (size_t)size+1) {
+        std::cout << "[REXBDD] ERROR!\t VarDomain(): the order has " << order.size()-1
+                  << " levels, it should be " << size << std::endl;
+        exit(0);
+    }
+    std::vector<bool> isPlaced(size+1, 0);
+    for (uint16_t k=1; k<=size; k++) {
+        if ((order[k] == 0) || (order[k] > size) || isPlaced[order[k]]) {
+            std::cout << "[REXBDD] ERROR!\t VarDomain(): the order is not a permutation at level " << k << std::endl;
+            exit(0);
+        }
+        isPlaced[order[k]] = 1;
+        level2Var[k] = order[k];
+        var2Level[order[k]] = k;
+        if (order[k] != k) isDefault = 0;
+    }
 }
 VarDomain::~VarDomain()
 {
     //
 }
 
+void VarDomain::setNumVars(const uint16_t num)
+{
+    maxLevel = num;
+    level2Var.resize(num+1);
+    var2Level.resize(num+1);
+    for (uint16_t k=0; k<=num; k++) {
+        level2Var[k] = k;
+        var2Level[k] = k;
+    }
+    isDefault = 1;
+}
+
+void VarDomain::swapLevels(const uint16_t lvl)
+{
+    uint16_t lower = level2Var[lvl], upper = level2Var[lvl+1];
+    level2Var[lvl] = upper;
+    level2Var[lvl+1] = lower;
+    var2Level[upper] = lvl;
+    var2Level[lower] = lvl+1;
+    isDefault = 1;
+    for (uint16_t k=1; k<=maxLevel && isDefault; k++) {
+        isDefault = (level2Var[k] == k);
+    }
+}
+
 // ******************************************************************
 // *                                                                *
 // *                                                                *
@@ -36,6 +81,12 @@ ForestSetting::ForestSetting(const unsigned numVals)
     reductions = Reductions(REX);
     encodingType = TERMINAL;
     mergeType = PUSH_UP;
+    hashingType = CHAINING;
+    cacheWays = 1;
+    numThreads = 1;
+    parallelLevel = 16;
+    gcThreshold = 0;
+    reorderTime = 0;
     name = "RexBDD";
 }
 
@@ -45,6 +96,12 @@ ForestSetting::ForestSetting(const PredefForest type, const unsigned numVals, co
     // default setting
     encodingType = TERMINAL;
     mergeType = NO_MERGE;
+    hashingType = CHAINING;
+    cacheWays = 1;
+    numThreads = 1;
+    parallelLevel = 16;
+    gcThreshold = 0;
+    reorderTime = 0;
     if (type == PredefForest::REXBDD) {
         // setting for RexBDD
         reductions = Reductions(REX);
@@ -98,6 +155,12 @@ ForestSetting::ForestSetting(const std::string& bdd, const unsigned numVals, con
     // default setting
     encodingType = TERMINAL;
     mergeType = NO_MERGE;
+    hashingType = CHAINING;
+    cacheWays = 1;
+    numThreads = 1;
+    parallelLevel = 16;
+    gcThreshold = 0;
+    reorderTime = 0;
     // convert to all lower case
     std::string bddLower;
     bddLower.resize(bdd.size());
@@ -229,6 +292,28 @@ void ForestSetting::output(std::ostream& out, int format) const
         out<<std::endl;
         // merge type
         out<<"\tMege type:\t\t"<<mergeType2String(getMergeType(), isRelation())<<std::endl;
+        // unique table
+        out<<"\tUnique table hashing:\t"<<hashingType2String(getHashingType())<<std::endl;
+        // compute table
+        out<<"\tCompute table ways:\t"<<getCacheWays()<<std::endl;
+        // parallel
+        out<<"\tNumber of threads:\t"<<getNumThreads();
+        if (getNumThreads() > 1) out<<": tasks from level "<<getParallelLevel();
+        out<<std::endl;
+        // garbage collection
+        out<<"\tGC threshold (nodes):\t";
+        if (getGCThreshold()) {
+            out<<getGCThreshold()<<std::endl;
+        } else {
+            out<<"never"<<std::endl;
+        }
+        // reordering
+        out<<"\tDynamic reordering:\t";
+        if (getReorderTime() > 0) {
+            out<<"sifting, at most "<<getReorderTime()<<" s"<<std::endl;
+        } else {
+            out<<"off"<<std::endl;
+        }
         out<<"============================ Settings End ==========================="<<std::endl;
     } else if (format == 1) {
         //
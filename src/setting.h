@@ -65,6 +65,22 @@ namespace REXBDD {
         }
         return mType;
     }
+    /// Hashing mechanism of the unique table
+    enum HashingType{
+        CHAINING,           // hash chains threaded through the "next" slot of nodes
+        OPEN_ADDRESSING     // linear probing over handles with stored hash fingerprints
+    };
+    static inline std::string hashingType2String(HashingType ht) {
+        std::string hType;
+        if (ht == CHAINING) {
+            hType = "Chaining";
+        } else if (ht == OPEN_ADDRESSING) {
+            hType = "Open addressing";
+        } else {
+            hType = "Unknown";
+        }
+        return hType;
+    }
     /// Domain and ordering of variables
     class VarDomain;
     /// Settings for forest
@@ -94,12 +110,15 @@ class REXBDD::VarDomain {
         inline uint16_t getVar(uint16_t lvl) const {return level2Var[lvl];}
         /// Get the level for a given variable index
         inline uint16_t getLevel(uint16_t var) const {return var2Level[var];}
+        /// Check if variable k is at level k, for all k
+        inline bool isDefaultOrder() const {return isDefault;}
         /**
          * Setters
          */
-        /// Set the number of variables
-        inline void setNumVars(const uint16_t num) {maxLevel = num;}
-        // ordering TBD
+        /// Set the number of variables, in the default order
+        void setNumVars(const uint16_t num);
+        /// Exchange the variables at the given level and the level above
+        void swapLevels(const uint16_t lvl);
 
 
     /*-------------------------------------------------------------*/
@@ -108,6 +127,7 @@ class REXBDD::VarDomain {
         uint16_t                maxLevel;   // number of variables
         std::vector<uint16_t>   level2Var;  // Variable order: indexed by levels
         std::vector<uint16_t>   var2Level;  // Variable order: indexed by variables
+        bool                    isDefault;  // If variable k is at level k, for all k
 };
 
 // ******************************************************************
@@ -143,6 +163,8 @@ class REXBDD::ForestSetting {
         inline uint16_t getVar(uint16_t lvl) const {return domain.getVar(lvl);}
         /// Get the level for a given variable index
         inline uint16_t getLevel(uint16_t var) const {return domain.getLevel(var);}
+        /// Check if variable k is at level k, for all k
+        inline bool isDefaultOrder() const {return domain.isDefaultOrder();}
         /* Range ========================================================================*/
         /// Get the RangeType 
         inline RangeType getRangeType() const {return range.getRangeType();}
@@ -176,6 +198,23 @@ class REXBDD::ForestSetting {
         /* Merge ========================================================================*/
         /// Get the type of merge mechanism applied (will be removed later)
         inline MergeType getMergeType() const {return mergeType;}
+        /* Unique table =================================================================*/
+        /// Get the hashing mechanism of the unique table
+        inline HashingType getHashingType() const {return hashingType;}
+        /* Compute table ================================================================*/
+        /// Get the associativity (entries per bucket) of the compute tables for this forest
+        inline int getCacheWays() const {return cacheWays;}
+        /* Parallel =====================================================================*/
+        /// Get the number of threads for operations in this forest; 1 for sequential
+        inline int getNumThreads() const {return numThreads;}
+        /// Get the lowest level whose sub-problems are spawned as parallel tasks
+        inline uint16_t getParallelLevel() const {return parallelLevel;}
+        /* Garbage collection ===========================================================*/
+        /// Get the number of live nodes that triggers garbage collection; 0 for never
+        inline uint64_t getGCThreshold() const {return gcThreshold;}
+        /* Reordering ===================================================================*/
+        /// Get the time limit (seconds) of each dynamic reordering; 0 for no dynamic reordering
+        inline double getReorderTime() const {return reorderTime;}
         /* Name =========================================================================*/
         inline std::string getName() const {return name;}
 
@@ -185,7 +224,8 @@ class REXBDD::ForestSetting {
         /* Domain */
         /// Set the number of variables
         inline void setNumVars(const uint16_t num) {domain.setNumVars(num);}
-        // ordering TBD
+        /// Exchange the variables at the given level and the level above (used by reordering)
+        inline void swapLevels(const uint16_t lvl) {domain.swapLevels(lvl);}
         /* Range */
         /// Set the range type
         inline void setRangeType(const RangeType type) {range.setRangeType(type);}
@@ -219,6 +259,23 @@ class REXBDD::ForestSetting {
         /* Merge */
         /// Set the merge type (will be removed later)
         inline void setMergeType(const MergeType type) {mergeType = type;}
+        /* Unique table */
+        /// Set the hashing mechanism of the unique table
+        inline void setHashingType(const HashingType type) {hashingType = type;}
+        /* Compute table */
+        /// Set the associativity of the compute tables for this forest: 1, 2 or 4 ways
+        inline void setCacheWays(const int ways) {cacheWays = ways;}
+        /* Parallel */
+        /// Set the number of threads for operations in this forest; 1 for sequential
+        inline void setNumThreads(const int num) {numThreads = num;}
+        /// Set the lowest level whose sub-problems are spawned as parallel tasks
+        inline void setParallelLevel(const uint16_t lvl) {parallelLevel = lvl;}
+        /* Garbage collection */
+        /// Set the number of live nodes that triggers garbage collection; 0 for never
+        inline void setGCThreshold(const uint64_t num) {gcThreshold = num;}
+        /* Reordering */
+        /// Set the time limit (seconds) of each dynamic reordering; 0 for no dynamic reordering
+        inline void setReorderTime(const double seconds) {reorderTime = seconds;}
         /* Name */
         /// Set the name of the BDD or BMxD
         inline void setName(const std::string& bdd) {name = bdd;}
@@ -270,6 +327,12 @@ class REXBDD::ForestSetting {
         Flags           flags;          // Edge flags type
         EncodeMechanism encodingType;   // Encoding mechanism: terminal, edge-valued
         MergeType       mergeType;      // Merge type (will be removed in the future)
+        HashingType     hashingType;    // Hashing mechanism of the unique table
+        int             cacheWays;      // Associativity of the compute tables
+        int             numThreads;     // Number of threads for operations
+        uint16_t        parallelLevel;  // Level cutoff for spawning parallel tasks
+        uint64_t        gcThreshold;    // Live nodes triggering garbage collection; 0 for never
+        double          reorderTime;    // Time limit of dynamic reordering, in seconds; 0 for none
         std::string     name;           // The name of the forest
 };
 
@@ -0,0 +1,86 @@
+#ifndef REXBDD_KERNELS_H
+#define REXBDD_KERNELS_H
+
+#include "../setting.h"
+
+namespace REXBDD {
+    /**
+     * Kernels of the forest: the part of the specification that the reduction and
+     * building of nodes query for every node. They are the template argument "K" of
+     * the kernel methods of Forest, which are selected once at construction, and of
+     * the elementwise and complement recursions of the operations (Forest::kernelOf).
+     *
+     *      SettingKernel       reads the ForestSetting at run time, for any forest.
+     *      PredefKernel<P>     the fixed specification of the predefined forest P, as
+     *                          constants: the branches on it are resolved at compile time.
+     *
+     * The value type is not fixed by the predefined forests, it is still read from the setting.
+     */
+    struct SettingKernel;
+    template <PredefForest P> struct PredefKernel;
+
+    /// Bit r is set if reduction rule r is used by the predefined forest
+    static constexpr uint16_t predefRules(const PredefForest type) {
+        return (type == PredefForest::REXBDD) ? (uint16_t)(0x03FF & ~(0x01 << RULE_I0))
+            : (type == PredefForest::QBDD) ? (uint16_t)0
+            : (type == PredefForest::FBDD) ? (uint16_t)(0x01 << RULE_X)
+            : (type == PredefForest::ZBDD) ? (uint16_t)(0x01 << RULE_EH0)
+            : (type == PredefForest::ESRBDD) ? (uint16_t)((0x01 << RULE_X) | (0x01 << RULE_EL0) | (0x01 << RULE_EH0))
+            : (type == PredefForest::FBMXD) ? (uint16_t)(0x01 << RULE_X)
+            : (type == PredefForest::IBMXD) ? (uint16_t)(0x01 << RULE_I0)
+            : (uint16_t)((0x01 << RULE_X) | (0x01 << RULE_I0) | (0x01 << RULE_I1));
+    }
+};
+
+// ******************************************************************
+// *                                                                *
+// *                      SettingKernel struct                      *
+// *                                                                *
+// ******************************************************************
+struct REXBDD::SettingKernel {
+    static inline bool hasRule(const ForestSetting& s, const ReductionRule rule) {return s.hasReductionRule(rule);}
+    static inline bool isRelation(const ForestSetting& s) {return s.isRelation();}
+    static inline bool isTerminal(const ForestSetting& s) {return s.getEncodeMechanism() == TERMINAL;}
+    static inline SwapSet swapType(const ForestSetting& s) {return s.getSwapType();}
+    static inline CompSet compType(const ForestSetting& s) {return s.getCompType();}
+    static inline MergeType mergeType(const ForestSetting& s) {return s.getMergeType();}
+    /// If the nodes store the levels of their child edges
+    static inline bool hasLevel(const ForestSetting& s) {return s.getReductionSize() > 0;}
+};
+
+// ******************************************************************
+// *                                                                *
+// *                      PredefKernel struct                       *
+// *                                                                *
+// ******************************************************************
+template <REXBDD::PredefForest P>
+struct REXBDD::PredefKernel {
+    static constexpr uint16_t   RULES = predefRules(P);
+    static constexpr bool       IS_RELATION = (P == PredefForest::FBMXD) || (P == PredefForest::IBMXD)
+                                            || (P == PredefForest::ESRBMXD);
+    static constexpr SwapSet    SWAP_TYPE = (P == PredefForest::REXBDD) ? ONE : NO_SWAP;
+    static constexpr CompSet    COMP_TYPE = (P == PredefForest::REXBDD) ? COMP : NO_COMP;
+    static constexpr MergeType  MERGE_TYPE = ((P == PredefForest::REXBDD) || (P == PredefForest::ZBDD)
+                                            || (P == PredefForest::ESRBMXD)) ? PUSH_UP : NO_MERGE;
+
+    static constexpr bool hasRule(const ForestSetting&, const ReductionRule rule) {return (RULES >> rule) & 0x01;}
+    static constexpr bool isRelation(const ForestSetting&) {return IS_RELATION;}
+    static constexpr bool isTerminal(const ForestSetting&) {return 1;}
+    static constexpr SwapSet swapType(const ForestSetting&) {return SWAP_TYPE;}
+    static constexpr CompSet compType(const ForestSetting&) {return COMP_TYPE;}
+    static constexpr MergeType mergeType(const ForestSetting&) {return MERGE_TYPE;}
+    static constexpr bool hasLevel(const ForestSetting&) {return RULES != 0;}
+
+    /// Check if the given setting has the specification of P, which this kernel assumes
+    static inline bool matches(const ForestSetting& s) {
+        if ((s.isRelation() != IS_RELATION) || (s.getEncodeMechanism() != TERMINAL)
+            || (s.getSwapType() != SWAP_TYPE) || (s.getCompType() != COMP_TYPE)
+            || (s.getMergeType() != MERGE_TYPE)) return 0;
+        for (int r=0; r<=RULE_I1; r++) {
+            if (s.hasReductionRule((ReductionRule)r) != (bool)((RULES >> r) & 0x01)) return 0;
+        }
+        return 1;
+    }
+};
+
+#endif
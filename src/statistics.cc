@@ -11,14 +11,83 @@ using namespace REXBDD;
 
 Statistics::Statistics()
 {
-    //
-    activeNodes = 0;
     peakNodes = 0;
-    numOps = 0;
-    numOpsTerms = 0;
-    numHitsCT = 0;
+    setNumWorkers(1);
+    numGCs = 0;
+    lastGCNodes = 0;
+    lastGCTime = 0;
+    totalGCNodes = 0;
+    totalGCTime = 0;
+    numReorders = 0;
+    lastReorderBefore = 0;
+    lastReorderAfter = 0;
+    totalReorderTime = 0;
+    numSaturations = 0;
+    lastSatIterations = 0;
+    totalSatIterations = 0;
+    lastSatPeakNodes = 0;
 }
 Statistics::~Statistics()
 {
     //
-}
\ No newline at end of file
+}
+
+void Statistics::setNumWorkers(const int num)
+{
+    if ((size_t)num <= workers.size()) return;
+    WorkerCounters zero = {0, 0, 0, 0};
+    workers.resize(num, zero);
+}
+
+StatsSnapshot Statistics::snapshot(const uint64_t nodes) const
+{
+    StatsSnapshot snap;
+    snap.activeNodes = nodes;
+    snap.peakNodes = (nodes > peakNodes) ? nodes : peakNodes;
+    snap.createdNodes = 0;
+    snap.numOps = 0;
+    snap.numOpsTerms = 0;
+    snap.numHitsCT = 0;
+    for (size_t i=0; i<workers.size(); i++) {
+        snap.createdNodes += workers[i].nodes;
+        snap.numOps += workers[i].ops;
+        snap.numOpsTerms += workers[i].ops - workers[i].lookups;
+        snap.numHitsCT += workers[i].hits;
+    }
+    snap.numGCs = numGCs;
+    snap.totalGCNodes = totalGCNodes;
+    snap.totalGCTime = totalGCTime;
+    snap.numReorders = numReorders;
+    snap.totalReorderTime = totalReorderTime;
+    snap.numSaturations = numSaturations;
+    snap.totalSatIterations = totalSatIterations;
+    snap.lastSatPeakNodes = lastSatPeakNodes;
+    return snap;
+}
+
+// ******************************************************************
+// *                                                                *
+// *                                                                *
+// *                    StatsSnapshot methods                       *
+// *                                                                *
+// *                                                                *
+// ******************************************************************
+
+void StatsSnapshot::dump(std::ostream& out) const
+{
+    out << "{\"activeNodes\": " << activeNodes
+        << ", \"peakNodes\": " << peakNodes
+        << ", \"createdNodes\": " << createdNodes
+        << ", \"numOps\": " << numOps
+        << ", \"numOpsTerms\": " << numOpsTerms
+        << ", \"numHitsCT\": " << numHitsCT
+        << ", \"numGCs\": " << numGCs
+        << ", \"totalGCNodes\": " << totalGCNodes
+        << ", \"totalGCTime\": " << totalGCTime
+        << ", \"numReorders\": " << numReorders
+        << ", \"totalReorderTime\": " << totalReorderTime
+        << ", \"numSaturations\": " << numSaturations
+        << ", \"totalSatIterations\": " << totalSatIterations
+        << ", \"lastSatPeakNodes\": " << lastSatPeakNodes
+        << "}" << std::endl;
+}
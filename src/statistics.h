@@ -3,10 +3,56 @@
 
 #include "defines.h"
 
+#include <vector>
+
+// The operation and node counters are compiled out with REXBDD_NO_STATS
+// (cmake -DREXBDD_STATS=OFF).
+
 namespace REXBDD {
     class Statistics;
+    struct StatsSnapshot;
 }; // namespace REXBDD
 
+// ******************************************************************
+// *                                                                *
+// *                                                                *
+// *                     StatsSnapshot struct                       *
+// *                                                                *
+// *                                                                *
+// ******************************************************************
+/**
+ * @brief A copy of the statistics of a forest at some point, with the
+ * counters of all the workers added up.
+ * 
+ */
+struct REXBDD::StatsSnapshot {
+    uint64_t activeNodes;       // Nodes in the unique table, including disconnected ones.
+    uint64_t peakNodes;         // Peak number of active nodes, since the last reset.
+    uint64_t createdNodes;      // Number of nodes created.
+
+    uint64_t numOps;            // Number of recursive operation calls.
+    uint64_t numOpsTerms;       // Number of operation calls that were terminal cases.
+    uint64_t numHitsCT;         // Number of operation calls answered by a computing table.
+
+    uint64_t numGCs;            // Number of garbage collections.
+    uint64_t totalGCNodes;      // Nodes reclaimed by all garbage collections.
+    double   totalGCTime;       // Pause time of all garbage collections, in seconds.
+
+    uint64_t numReorders;       // Number of variable reorderings.
+    double   totalReorderTime;  // Time of all reorderings, in seconds.
+
+    uint64_t numSaturations;    // Number of saturations.
+    uint64_t totalSatIterations;    // Rounds of firing the relations of a node, in all saturations.
+    uint64_t lastSatPeakNodes;  // Active nodes at the end of the last saturation, before any collection.
+
+    /**
+     * @brief Write the snapshot as a single-line JSON object, for scripts and dashboards.
+     * 
+     * @param out           The output stream.
+     */
+    void dump(std::ostream& out) const;
+};
+
 // ******************************************************************
 // *                                                                *
 // *                                                                *
@@ -27,15 +73,106 @@ class REXBDD::Statistics {
     /*-------------------------------------------------------------*/
     Statistics();
     ~Statistics();
+
+    /// Counters of a worker: operation calls and created nodes
+    struct alignas(64) WorkerCounters {
+        uint64_t    ops;            // Recursive operation calls
+        uint64_t    lookups;        // Calls that were not terminal cases
+        uint64_t    hits;           // Calls answered by a computing table
+        uint64_t    nodes;          // Created nodes
+    };
+    /// Make room for the counters of the given number of workers (WorkPool::workerIndex()).
+    void setNumWorkers(const int num);
+    /// Count an operation call, by the given worker
+    inline void countOp(const int worker) {
+#ifndef REXBDD_NO_STATS
+        workers[worker].ops++;
+#endif
+    }
+    /// Count an operation call that is not a terminal case, and looks up a computing table
+    inline void countLookup(const int worker) {
+#ifndef REXBDD_NO_STATS
+        workers[worker].lookups++;
+#endif
+    }
+    /// Count a computing table hit
+    inline void countHit(const int worker) {
+#ifndef REXBDD_NO_STATS
+        workers[worker].hits++;
+#endif
+    }
+    /// Count a created node
+    inline void countNode(const int worker) {
+#ifndef REXBDD_NO_STATS
+        workers[worker].nodes++;
+#endif
+    }
+    /// Take the given number of active nodes into the peak; nodes are added
+    /// only within operations, so it is enough to do this before they are removed.
+    inline void notePeak(const uint64_t nodes) {
+        if (nodes > peakNodes) peakNodes = nodes;
+    }
+    inline uint64_t getPeakNodes() const {return peakNodes;}
+    inline void resetPeakNodes(const uint64_t nodes) {peakNodes = nodes;}
+    /// Copy the statistics, given the number of active nodes now
+    StatsSnapshot snapshot(const uint64_t nodes) const;
+
+    /// Record a garbage collection that reclaimed the given nodes in the given seconds
+    inline void recordGC(const uint64_t nodes, const double seconds) {
+        numGCs++;
+        lastGCNodes = nodes;
+        lastGCTime = seconds;
+        totalGCNodes += nodes;
+        totalGCTime += seconds;
+    }
+    inline uint64_t getNumGCs() const {return numGCs;}
+    inline uint64_t getLastGCNodes() const {return lastGCNodes;}
+    inline double getLastGCTime() const {return lastGCTime;}
+    inline uint64_t getTotalGCNodes() const {return totalGCNodes;}
+    inline double getTotalGCTime() const {return totalGCTime;}
+    /// Record a reordering that changed the live nodes from "before" to "after" in the given seconds
+    inline void recordReorder(const uint64_t before, const uint64_t after, const double seconds) {
+        numReorders++;
+        lastReorderBefore = before;
+        lastReorderAfter = after;
+        totalReorderTime += seconds;
+    }
+    inline uint64_t getNumReorders() const {return numReorders;}
+    inline uint64_t getLastReorderBefore() const {return lastReorderBefore;}
+    inline uint64_t getLastReorderAfter() const {return lastReorderAfter;}
+    inline double getTotalReorderTime() const {return totalReorderTime;}
+    /// Record a saturation of the given rounds of firing, and active nodes at its end
+    inline void recordSaturation(const uint64_t iterations, const uint64_t nodes) {
+        numSaturations++;
+        lastSatIterations = iterations;
+        totalSatIterations += iterations;
+        lastSatPeakNodes = nodes;
+    }
+    inline uint64_t getNumSaturations() const {return numSaturations;}
+    inline uint64_t getLastSatIterations() const {return lastSatIterations;}
+    inline uint64_t getTotalSatIterations() const {return totalSatIterations;}
+    inline uint64_t getLastSatPeakNodes() const {return lastSatPeakNodes;}
     /*-------------------------------------------------------------*/
     private:
     /*-------------------------------------------------------------*/
-    uint64_t activeNodes;       // Current number of connected nodes.
     uint64_t peakNodes;         // Peak number of active nodes.
+    std::vector<WorkerCounters> workers;    // Operation and node counters, by worker.
+
+    uint64_t numGCs;            // Number of garbage collections.
+    uint64_t lastGCNodes;       // Nodes reclaimed by the last garbage collection.
+    double   lastGCTime;        // Pause time of the last garbage collection, in seconds.
+    uint64_t totalGCNodes;      // Nodes reclaimed by all garbage collections.
+    double   totalGCTime;       // Pause time of all garbage collections, in seconds.
+
+    uint64_t numReorders;       // Number of variable reorderings.
+    uint64_t lastReorderBefore; // Live nodes before the last reordering.
+    uint64_t lastReorderAfter;  // Live nodes after the last reordering.
+    double   totalReorderTime;  // Time of all reorderings, in seconds.
 
-    uint64_t numOps;            // Number of operation calls.
-    uint64_t numOpsTerms;       // Number of operation calls terminal case.
-    uint64_t numHitsCT;         // Number of hits in computing table.
+    uint64_t numSaturations;    // Number of saturations.
+    uint64_t lastSatIterations; // Rounds of firing in the last saturation.
+    uint64_t totalSatIterations;    // Rounds of firing in all saturations.
+    uint64_t lastSatPeakNodes;  // Active nodes at the end of the last saturation.
     // more numbers... TBD 
 };
 #endif
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "unique_table.h"
 #include "forest.h"
+#include "operations/work_pool.h"
 
 using namespace REXBDD;
 // ******************************************************************
@@ -12,8 +13,10 @@ using namespace REXBDD;
 UniqueTable::SubTable::SubTable(uint16_t lvl, Forest* f):parent(f),level(lvl)
 {
     sizeIndex = 0;
+    isOpen = (f->getSetting().getHashingType() == OPEN_ADDRESSING);
     table = (NodeHandle*)malloc(PRIMES[sizeIndex] * sizeof(NodeHandle));
-    if (!table) {
+    fingerprints = isOpen ? (uint32_t*)calloc(PRIMES[sizeIndex], sizeof(uint32_t)) : 0;
+    if (!table || (isOpen && !fingerprints)) {
         std::cout << "[BRAVE_DD] ERROR!\t Malloc fail for subtable: "<<lvl<< std::endl;
         exit(0);
     }
@@ -26,12 +29,14 @@ UniqueTable::SubTable::~SubTable()
         table[i] = 0;
     }
     free(table);
+    free(fingerprints);
     sizeIndex = 0;
     numEntries = 0;
 }
 
 NodeHandle UniqueTable::SubTable::insert(const Node& node)
 {
+    if (isOpen) return insertOpen(node);
     /* Check if we should enlarge */
     if (numEntries >= PRIMES[sizeIndex+1]) expand();
     /* Determine the hash index for the node */
@@ -39,6 +44,7 @@ NodeHandle UniqueTable::SubTable::insert(const Node& node)
     // Special, and hopefully common, case: empty chain. Which means the node is new.
     if (!table[index]) {
         numEntries++;
+        parent->stats->countNode(0);
         table[index] = parent->obtainFreeNodeHandle(level, node);
         return table[index];
     }
@@ -55,14 +61,102 @@ NodeHandle UniqueTable::SubTable::insert(const Node& node)
     // No duplicates in the chain. 
     // Get a new node handle, and add the new node to the front.
     numEntries++;
+    parent->stats->countNode(0);
     NodeHandle handle = parent->obtainFreeNodeHandle(level, node);
     parent->setNodeNext(level, handle, table[index]);
     table[index] = handle;
     return handle;
 }
 
+NodeHandle UniqueTable::SubTable::insertConcurrent(const Node& node)
+{
+    const uint64_t hash = node.hash(parent->nodeSize);
+    while (1) {
+        // table size when a full probe sequence was found; 0 if none
+        uint32_t fullSize = 0;
+        {
+            std::shared_lock<std::shared_mutex> guard(resizeLock);
+            if (!isFull()) {
+                NodeHandle handle = isOpen ? insertOpenConcurrent(node, hash) : insertChainedConcurrent(node, hash);
+                if (handle) return handle;
+                fullSize = getSize();
+            }
+        }
+        /* Enlarge, unless another thread just did */
+        std::unique_lock<std::shared_mutex> guard(resizeLock);
+        if (isFull() || (fullSize == getSize())) expand();
+    }
+}
+
+NodeHandle UniqueTable::SubTable::insertChainedConcurrent(const Node& node, const uint64_t hash)
+{
+    std::atomic<uint32_t>& head = atomicSlot(table + hash % getSize());
+    NodeHandle front = head.load(std::memory_order_acquire);
+    NodeHandle checked = 0;     // the part of the chain from here on is checked already
+    NodeHandle handle = 0;
+    while (1) {
+        // Check the new part of the chain for duplicates
+        for (NodeHandle curr = front; curr != checked; curr = parent->getNodeNext(level, curr)) {
+            if (parent->getNode(level, curr).isEqual(node, parent->nodeSize)) {
+                if (handle) parent->returnFreeNodeHandle(level, handle);
+                return curr;
+            }
+        }
+        // No duplicates. Try to add our node to the front
+        if (!handle) handle = parent->obtainFreeNodeHandle(level, node);
+        parent->setNodeNext(level, handle, front);
+        checked = front;
+        if (head.compare_exchange_weak(front, handle, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            numEntries++;
+            parent->stats->countNode(WorkPool::workerIndex());
+            return handle;
+        }
+        // Someone else changed the chain: front is its new head
+    }
+}
+
+NodeHandle UniqueTable::SubTable::insertOpenConcurrent(const Node& node, const uint64_t hash)
+{
+    uint32_t fp = fingerprint(hash);
+    uint32_t size = getSize();
+    uint32_t index = fp % size;
+    NodeHandle handle = 0;
+    // threads past isFull() at the same time may fill the table: probe each slot once at most
+    for (uint32_t probes=0; probes<size; probes++) {
+        NodeHandle curr = atomicSlot(table + index).load(std::memory_order_acquire);
+        if (!curr) {
+            // Claim the empty slot
+            if (!handle) handle = parent->obtainFreeNodeHandle(level, node);
+            if (atomicSlot(table + index).compare_exchange_strong(curr, handle, std::memory_order_acq_rel,
+                                                                  std::memory_order_acquire)) {
+                atomicSlot(fingerprints + index).store(fp, std::memory_order_relaxed);
+                numEntries++;
+                parent->stats->countNode(WorkPool::workerIndex());
+                return handle;
+            }
+            // Lost it: curr is the winner, check it as any other
+        }
+        // The fingerprint of a just claimed slot may still be 0
+        uint32_t currFp = atomicSlot(fingerprints + index).load(std::memory_order_relaxed);
+        if (((currFp == fp) || (currFp == 0))
+            && parent->getNode(level, curr).isEqual(node, parent->nodeSize)) {
+            // we found a duplicate
+            if (handle) parent->returnFreeNodeHandle(level, handle);
+            return curr;
+        }
+        if (++index == size) index = 0;
+    }
+    // No empty slot: the caller enlarges the table and tries again
+    if (handle) parent->returnFreeNodeHandle(level, handle);
+    return 0;
+}
+
 void UniqueTable::SubTable::sweep()
 {
+    if (isOpen) {
+        sweepOpen();
+        return;
+    }
     /* For each chain, traverse and keep only the marked items */
     numEntries = 0;
     NodeHandle curr, prev;
@@ -70,7 +164,7 @@ void UniqueTable::SubTable::sweep()
         prev = 0;
         curr = table[i];
         while (curr) {
-            if (parent->getNode(level, table[0]).isMarked()) {
+            if (parent->getNode(level, curr).isMarked()) {
                 if (prev) {
                     parent->setNodeNext(level, prev, curr);
                 } else {
@@ -93,6 +187,10 @@ void UniqueTable::SubTable::sweep()
 
 void UniqueTable::SubTable::expand()
 {
+    if (isOpen) {
+        expandOpen();
+        return;
+    }
     // Check if we can enlarge
     if (PRIMES[sizeIndex] >= UINT32_MAX) {  // MAX of uint32
         std::cout << "[BRAVE_DD] ERROR!\t Unable to enlarge SubUniqueTable!"
@@ -144,6 +242,164 @@ void UniqueTable::SubTable::expand()
         numEntries++;
     }
 }
+
+NodeHandle UniqueTable::SubTable::insertOpen(const Node& node)
+{
+    /* Keep the load factor at most 1/2, so probe sequences stay short */
+    if (2 * numEntries >= getSize()) expand();
+    uint32_t fp = fingerprint(node.hash(parent->nodeSize));
+    uint32_t size = getSize();
+    uint32_t index = fp % size;
+    // Probe until an empty slot; the stored node is only read when the fingerprints match.
+    while (table[index]) {
+        if ((fingerprints[index] == fp)
+            && parent->getNode(level, table[index]).isEqual(node, parent->nodeSize)) {
+            // we found a duplicate
+            return table[index];
+        }
+        if (++index == size) index = 0;
+    }
+    // No duplicates. Get a new node handle for the empty slot.
+    numEntries++;
+    parent->stats->countNode(0);
+    table[index] = parent->obtainFreeNodeHandle(level, node);
+    fingerprints[index] = fp;
+    return table[index];
+}
+
+void UniqueTable::SubTable::sweepOpen()
+{
+    /* Removals would break the probe sequences, so rebuild with only the marked items */
+    uint32_t size = getSize();
+    NodeHandle* oldTable = table;
+    uint32_t* oldFps = fingerprints;
+    table = (NodeHandle*)calloc(size, sizeof(NodeHandle));
+    fingerprints = (uint32_t*)calloc(size, sizeof(uint32_t));
+    if (!table || !fingerprints) {
+        std::cout << "[BRAVE_DD] ERROR!\t Malloc fail in sweep subtable!"<< std::endl;
+        exit(0);
+    }
+    numEntries = 0;
+    for (uint32_t i=0; i<size; i++) {
+        if (oldTable[i] && parent->getNode(level, oldTable[i]).isMarked()) {
+            place(oldTable[i], oldFps[i]);
+            numEntries++;
+        }
+    }
+    free(oldTable);
+    free(oldFps);
+    /* Check if we should shrink the table. TBD */
+}
+
+void UniqueTable::SubTable::expandOpen()
+{
+    // Check if we can enlarge
+    if (PRIMES[sizeIndex] >= UINT32_MAX) {  // MAX of uint32
+        std::cout << "[BRAVE_DD] ERROR!\t Unable to enlarge SubUniqueTable!"
+        << "\n\t\tToo many nodes at level: " << level << std::endl;
+        exit(0);
+    }
+    uint32_t oldSize = getSize();
+    NodeHandle* oldTable = table;
+    uint32_t* oldFps = fingerprints;
+    // new table of larger size
+    sizeIndex++;
+    uint32_t newSize = getSize();
+    table = (NodeHandle*)calloc(newSize, sizeof(NodeHandle));
+    fingerprints = (uint32_t*)calloc(newSize, sizeof(uint32_t));
+    if (!table || !fingerprints) {
+        std::cout << "[BRAVE_DD] ERROR!\t Malloc fail in expand subtable!"<< std::endl;
+        exit(0);
+    }
+    // rehash by the stored fingerprints, without touching the nodes
+    for (uint32_t i=0; i<oldSize; i++) {
+        if (oldTable[i]) place(oldTable[i], oldFps[i]);
+    }
+    free(oldTable);
+    free(oldFps);
+}
+unsigned UniqueTable::SubTable::getItems(NodeHandle* items, unsigned sz) const
+{
+    unsigned num = 0;
+    for (uint32_t i=0; (i<getSize()) && (num<sz); i++) {
+        if (isOpen) {
+            if (table[i]) items[num++] = table[i];
+            continue;
+        }
+        for (NodeHandle curr = table[i]; curr && (num<sz); curr = parent->getNodeNext(level, curr)) {
+            items[num++] = curr;
+        }
+    }
+    return num;
+}
+
+NodeHandle UniqueTable::SubTable::remove(const NodeHandle item)
+{
+    uint64_t hash = parent->getNodeHash(level, item);
+    uint32_t size = getSize();
+    if (!isOpen) {
+        NodeHandle prev = 0;
+        for (NodeHandle curr = table[hash % size]; curr; curr = parent->getNodeNext(level, curr)) {
+            if (curr == item) {
+                if (prev) {
+                    parent->setNodeNext(level, prev, parent->getNodeNext(level, curr));
+                } else {
+                    table[hash % size] = parent->getNodeNext(level, curr);
+                }
+                numEntries--;
+                return item;
+            }
+            prev = curr;
+        }
+        return 0;
+    }
+    uint32_t index = fingerprint(hash) % size;
+    while (table[index] && (table[index] != item)) {
+        if (++index == size) index = 0;
+    }
+    if (!table[index]) return 0;
+    /* Shift back the later items of the probe sequence, so none of them is cut off from its home slot */
+    uint32_t next = index;
+    for (;;) {
+        table[index] = 0;
+        fingerprints[index] = 0;
+        for (;;) {
+            if (++next == size) next = 0;
+            if (!table[next]) {
+                numEntries--;
+                return item;
+            }
+            uint32_t home = fingerprints[next] % size;
+            bool isBetween = (index <= next) ? ((index < home) && (home <= next)) : ((index < home) || (home <= next));
+            if (!isBetween) break;
+        }
+        table[index] = table[next];
+        fingerprints[index] = fingerprints[next];
+        index = next;
+    }
+}
+
+void UniqueTable::SubTable::add(const NodeHandle item)
+{
+    if (isFull()) expand();
+    uint64_t hash = parent->getNodeHash(level, item);
+    if (isOpen) {
+        place(item, fingerprint(hash));
+    } else {
+        uint32_t index = hash % getSize();
+        parent->setNodeNext(level, item, table[index]);
+        table[index] = item;
+    }
+    numEntries++;
+}
+
+void UniqueTable::SubTable::clear()
+{
+    memset(table, 0, getSize() * sizeof(NodeHandle));
+    if (isOpen) memset(fingerprints, 0, getSize() * sizeof(uint32_t));
+    numEntries = 0;
+}
+
 // ******************************************************************
 // *                                                                *
 // *                                                                *
@@ -154,6 +410,7 @@ void UniqueTable::SubTable::expand()
 
 UniqueTable::UniqueTable(Forest* f):parent(f)
 {
+    isConcurrent = 0;
     uint16_t lvls = f->getSetting().getNumVars();
     tables = (SubTable*)malloc(lvls * sizeof(SubTable));
     if (!tables) {
@@ -173,3 +430,19 @@ UniqueTable::~UniqueTable()
     parent = 0;
 }
 
+uint64_t UniqueTable::getNumEntries() const
+{
+    uint64_t num = 0;
+    for (uint16_t i=0; i<parent->getSetting().getNumVars(); i++) {
+        num += tables[i].getNumEntries();
+    }
+    return num;
+}
+
+void UniqueTable::sweep()
+{
+    for (uint16_t k=1; k<=parent->getSetting().getNumVars(); k++) {
+        sweep(k);
+    }
+}
+
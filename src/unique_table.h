@@ -4,6 +4,9 @@
 #include "defines.h"
 #include "node_manager.h"
 
+#include <atomic>
+#include <shared_mutex>
+
 namespace REXBDD {
     class Forest;
     class UniqueTable;
@@ -50,32 +53,31 @@ class REXBDD::UniqueTable {
          * @return NodeHandle 
          */
         inline NodeHandle insert(uint16_t lvl, const Node& node) {
+            if (isConcurrent) return tables[lvl-1].insertConcurrent(node);
             return tables[lvl-1].insert(node);
         };
 
+        /**
+         * Switch on/off the concurrent mode, where several threads insert at the same time.
+         * Insertions publish new handles by CAS on the table slots, so two threads inserting
+         * the same node still get the same handle; a subtable is only locked while it grows.
+         */
+        inline void setConcurrent(bool concurrent) {isConcurrent = concurrent;}
+
         /** If the table of the given variable level contains key node, return the item 
          * and move it to the front of the list. Otherwise, return 0 and do nothing.
          */
         // inline NodeHandle find(uint16_t level, Node &node) const {return tables[level].find(node);}
 
-        /** Add the NodeHandle item to the front of the list of the corresponding variable.
-         *  Used when we KNOW that the item is not in the unique table already.
+        /** Add the NodeHandle item to the table of the given level, hashed by the node it holds.
+         *  Used when we KNOW that the node is not in the unique table already.
          */
-        // inline void add(unsigned long hash, NodeHandle item) {
-        //     // get node level, it may be negative if for relation
-        //     // get var level
-        //     // TBD
-        // }
-
-        /** If the unique table of corresponding variable contains key node, remove it and return it.
-         *  Otherwise, return 0.
+        inline void add(uint16_t lvl, NodeHandle item) {tables[lvl-1].add(item);}
+
+        /** If the unique table of the given level contains the item, remove it and return it.
+         *  Otherwise, return 0. The node must still hold what it held when it was added.
          */
-        // inline NodeHandle remove(unsigned long hash, NodeHandle item) {
-        //     // get node level, it may be negative if for relation
-        //     // get var level
-        //     // TBD
-        //     return 0;
-        // }
+        inline NodeHandle remove(uint16_t lvl, NodeHandle item) {return tables[lvl-1].remove(item);}
 
         /// Remove all unmarked nodes from the unique table
         inline void sweep(uint16_t level) {tables[level-1].sweep();}
@@ -84,6 +86,10 @@ class REXBDD::UniqueTable {
         /// Clear the nodeHanlde items in the table of the given variable level and reset the state.
         inline void clear(int varLvl) {return tables[varLvl-1].clear();}
 
+        /// Get the node handles stored at the given level; at most sz of them, returns how many
+        inline unsigned getItems(int varLvl, NodeHandle* items, unsigned sz) const {
+            return tables[varLvl-1].getItems(items, sz);
+        }
 
     /*-------------------------------------------------------------*/
     private:
@@ -100,7 +106,7 @@ class REXBDD::UniqueTable {
                     return numEntries;
                 }
                 inline uint64_t getMemUsed() const {
-                    return PRIMES[sizeIndex] * sizeof(NodeHandle);
+                    return PRIMES[sizeIndex] * (sizeof(NodeHandle) + (isOpen ? sizeof(uint32_t) : 0));
                 }
 
                 // Stats for future TBD
@@ -122,11 +128,14 @@ class REXBDD::UniqueTable {
                  */
                 void sweep();
 
-                /** If table contains key, remove it and return it.
+                /** If table contains item, remove it and return it.
                     I.e., the exact key.
                     Otherwise, return 0.
                 */
-                int remove(unsigned hash, NodeHandle item);
+                NodeHandle remove(const NodeHandle item);
+
+                /// Add an item known not to be in the table
+                void add(const NodeHandle item);
 
                 /**
                     Remove all the items in the table and reset the state.
@@ -144,9 +153,40 @@ class REXBDD::UniqueTable {
                                         at most sz.
                 */
                 unsigned getItems(NodeHandle* items, unsigned sz) const;
-
             private:
             // ======================Helper Methods====================
+                /// Insert from one of several threads: lock-free, except for expanding
+                NodeHandle insertConcurrent(const Node& node);
+                NodeHandle insertChainedConcurrent(const Node& node, const uint64_t hash);
+                /// Returns 0 if the whole table was probed without finding the node or an empty slot
+                NodeHandle insertOpenConcurrent(const Node& node, const uint64_t hash);
+                /// If the table should be enlarged before the next insertion
+                inline bool isFull() const {
+                    return isOpen ? (2 * numEntries >= getSize()) : (numEntries >= PRIMES[sizeIndex+1]);
+                }
+                /// Atomic access to a table or fingerprint slot in the concurrent mode
+                static inline std::atomic<uint32_t>& atomicSlot(uint32_t* slot) {
+                    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "atomic slot size");
+                    return *reinterpret_cast<std::atomic<uint32_t>*>(slot);
+                }
+                /// Insert, sweep and expand for the open addressing table
+                NodeHandle insertOpen(const Node& node);
+                void sweepOpen();
+                void expandOpen();
+                /// Put a handle into the first empty slot of its probe sequence
+                inline void place(const NodeHandle handle, const uint32_t fp) {
+                    uint32_t size = getSize();
+                    uint32_t index = fp % size;
+                    while (table[index]) {
+                        if (++index == size) index = 0;
+                    }
+                    table[index] = handle;
+                    fingerprints[index] = fp;
+                }
+                /// Fold the 64-bit node hash into the stored fingerprint
+                static inline uint32_t fingerprint(const uint64_t hash) {
+                    return (uint32_t)(hash ^ (hash >> 32));
+                }
                 /// Expand the hash table (if possible)
                 void expand();
 
@@ -156,14 +196,18 @@ class REXBDD::UniqueTable {
                 friend class UniqueTable;
                 Forest*         parent;
                 NodeHandle*     table;
+                uint32_t*       fingerprints;       // Hash fingerprints of the handles in table (open addressing only)
+                bool            isOpen;             // If this table uses open addressing instead of chaining
                 uint16_t        level;              // The level of stored nodes
                 int             sizeIndex;          // Table size at this level, index of PRIMES
-                uint64_t        numEntries;         // The number of nodes at this level
+                std::atomic<uint64_t>   numEntries; // The number of nodes at this level
+                std::shared_mutex       resizeLock; // Shared by concurrent insertions, exclusive to expand
         }; // class SubTable
 
         // ========================================================
         Forest*         parent;     // Parent forest
         SubTable*       tables;     // Subtables divided by levels
+        bool            isConcurrent;   // If several threads may insert at the same time
 };
 
 
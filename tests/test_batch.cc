@@ -0,0 +1,86 @@
+#include "test_util.h"
+
+/* Compare the batch evaluation of a Func with evaluate() one assignment at a time */
+bool checkBatch(const Func& func, uint16_t numVals, int numRandom)
+{
+    long long size = 0x01LL<<(numVals);
+    // every assignment in order, then random ones; not a multiple of 64
+    std::vector<std::vector<bool> > assignments(size + numRandom, std::vector<bool>(numVals+1, 0));
+    for (long long n=0; n<size; n++) decimalToAssignment(n, assignments[n]);
+    for (int n=0; n<numRandom; n++) {
+        for (uint16_t v=1; v<=numVals; v++) assignments[size+n][v] = (random01() > 0.5f);
+    }
+    std::vector<bool> results;
+    func.evaluate(assignments, results);
+    if (results.size() != assignments.size()) return 0;
+    for (size_t a=0; a<assignments.size(); a++) {
+        int valInt;
+        func.evaluate(assignments[a]).getValueTo(&valInt, INT);
+        if (results[a] != (valInt != 0)) {
+            std::cout << "Assignment " << a << ": batch " << results[a] << ", single " << valInt << std::endl;
+            return 0;
+        }
+    }
+    // the bit-sliced form directly: one block whose lanes hold assignments 0 ... 63
+    std::vector<uint64_t> slices(numVals+1, 0), words;
+    for (int j=0; j<64; j++) {
+        for (uint16_t v=1; v<=numVals; v++) {
+            if (assignments[j][v]) slices[v] |= (uint64_t)1 << j;
+        }
+    }
+    func.evaluate(slices, words);
+    for (int j=0; j<64; j++) {
+        if (((words[0] >> j) & 1) != results[j]) return 0;
+    }
+    return 1;
+}
+
+bool runTests(PredefForest bdd, uint16_t numVals, int TESTS, bool isReordered)
+{
+    ForestSetting setting(bdd, numVals);
+    Forest* forest = new Forest(setting);
+    forest->getSetting().output(std::cout);
+    long long size = 0x01LL<<(numVals);
+
+    std::vector<Func> funcs;
+    for (int test=0; test<TESTS; test++) {
+        std::vector<bool> fun(size);
+        // dense random functions, and sparse ones whose edges skip levels
+        int a = (int)(random01() * numVals), b = (int)(random01() * numVals);
+        for (long long i=0; i<size; i++) {
+            switch (test % 4) {
+                case 0:  fun[i] = (random01() > 0.5f); break;
+                case 1:  fun[i] = ((i >> a) & 1) && ((i >> b) & 1); break;
+                case 2:  fun[i] = ((i >> a) & 1) || !((i >> b) & 1); break;
+                default: fun[i] = (test % 8 == 3); break;
+            }
+        }
+        funcs.push_back(Func(forest, buildEdge(forest, numVals, fun, 0, size-1)));
+    }
+    if (isReordered) {
+        forest->shiftUp(1);
+        forest->shiftDown(numVals-1);
+    }
+    bool pass = 1;
+    for (int test=0; pass && (test<TESTS); test++) {
+        pass = checkBatch(funcs[test], numVals, 1000);
+        if (!pass) std::cout << "Test " << test << ": batch evaluation differs!" << std::endl;
+    }
+    funcs.clear();
+    delete forest;
+    return pass;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_batch [num_val] [num_tests]
+    uint16_t numVals = (argc > 1) ? atoi(argv[1]) : 10;
+    int TESTS = (argc > 2) ? atoi(argv[2]) : 16;
+
+    for (int bdd=0; bdd<5; bdd++) {
+        if (!runTests((PredefForest)bdd, numVals, TESTS, 0)) return 1;
+        if (!runTests((PredefForest)bdd, numVals, TESTS, 1)) return 1;
+    }
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "test_util.h"
+
+/*
+ * Canonicity of the operation results: for all the functions of up to 3 variables,
+ * the edge returned by apply is the very edge built directly from the truth table
+ * of the result, handle for handle.
+ */
+
+/* The elementwise operations, with their truth tables: bit 2a+b is "a op b" */
+const BinaryBuiltin1 OPS[] = {UNION, INTERSECTION, DIFFERENCE, NOT_EQUAL};
+const int TABLES[] = {0xE, 0x8, 0x4, 0x6};
+
+/* Truth table of the function "f" of "size" assignments */
+std::vector<bool> truthTable(int f, long long size)
+{
+    std::vector<bool> fun(size);
+    for (long long i=0; i<size; i++) fun[i] = (f >> i) & 1;
+    return fun;
+}
+
+bool runTests(PredefForest bdd, uint16_t numVals)
+{
+    Forest* forest = new Forest(ForestSetting(bdd, numVals));
+    long long size = 0x01LL<<(numVals);
+    int numFuncs = 1 << size;
+    std::vector<Func> funcs(numFuncs, Func(forest));
+    for (int f=0; f<numFuncs; f++) {
+        std::vector<bool> fun = truthTable(f, size);
+        Edge edge = buildEdge(forest, numVals, fun, 0, size-1);
+        funcs[f].setEdge(edge);
+    }
+    for (int f=0; f<numFuncs; f++) {
+        Func res = !funcs[f];
+        if (res.getEdge().getEdgeHandle() != funcs[(numFuncs-1) & ~f].getEdge().getEdgeHandle()) {
+            std::cout << forest->getSetting().getName() << ": complement of " << f << " is not canonical!" << std::endl;
+            return 0;
+        }
+        for (int g=0; g<numFuncs; g++) {
+            for (int o=0; o<4; o++) {
+                int expected = 0;
+                for (long long i=0; i<size; i++) {
+                    expected |= ((TABLES[o] >> (2*((f >> i) & 1) + ((g >> i) & 1))) & 1) << i;
+                }
+                apply(OPS[o], funcs[f], funcs[g], res);
+                if (res.getEdge().getEdgeHandle() != funcs[expected].getEdge().getEdgeHandle()) {
+                    std::cout << forest->getSetting().getName() << ": operation " << o << " on "
+                              << f << " and " << g << " is not canonical!" << std::endl;
+                    return 0;
+                }
+            }
+        }
+    }
+    funcs.clear();
+    delete forest;
+    return 1;
+}
+
+/* A union of 4 variables whose result was an operand edge with a stale "to" swap flag */
+bool runUnionCase()
+{
+    Forest* forest = new Forest(ForestSetting(PredefForest::REXBDD, 4));
+    const char* tables[] = {"1111011111111101", "0110111001001101"};
+    std::vector<bool> fun[3];
+    for (int f=0; f<2; f++) {
+        for (int i=0; i<16; i++) fun[f].push_back(tables[f][i] == '1');
+    }
+    for (int i=0; i<16; i++) fun[2].push_back(fun[0][i] || fun[1][i]);
+    Func a(forest, buildEdge(forest, 4, fun[0], 0, 15));
+    Func b(forest, buildEdge(forest, 4, fun[1], 0, 15));
+    Func res = a | b;
+    bool isCanonical = (res.getEdge().getEdgeHandle() == buildEdge(forest, 4, fun[2], 0, 15).getEdgeHandle());
+    if (!isCanonical) std::cout << "Union of 4 variables is not canonical!" << std::endl;
+    delete forest;
+    return isCanonical;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_canonical [max_num_val]
+    uint16_t maxVals = (argc > 1) ? atoi(argv[1]) : 3;
+
+    for (uint16_t numVals=1; numVals<=maxVals; numVals++) {
+        for (int bdd=0; bdd<5; bdd++) {
+            if (!runTests((PredefForest)bdd, numVals)) return 1;
+        }
+    }
+    if (!runUnionCase()) return 1;
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "test_util.h"
+
+bool runTests(PredefForest bdd, uint16_t numVals, int TESTS, bool isReordered)
+{
+    ForestSetting setting(bdd, numVals);
+    Forest* forest = new Forest(setting);
+    forest->getSetting().output(std::cout);
+    long long size = 0x01LL<<(numVals);
+
+    std::vector<Func> funcs;
+    std::vector<std::vector<bool> > funs(TESTS, std::vector<bool>(size));
+    for (int test=0; test<TESTS; test++) {
+        // dense random functions, and sparse ones whose edges skip levels
+        int a = (int)(random01() * numVals), b = (int)(random01() * numVals);
+        for (long long i=0; i<size; i++) {
+            switch (test % 4) {
+                case 0:  funs[test][i] = (random01() > 0.5f); break;
+                case 1:  funs[test][i] = ((i >> a) & 1) && ((i >> b) & 1); break;
+                case 2:  funs[test][i] = ((i >> a) & 1) || !((i >> b) & 1); break;
+                default: funs[test][i] = (test % 8 == 3); break;
+            }
+        }
+        funcs.push_back(Func(forest, buildEdge(forest, numVals, funs[test], 0, size-1)));
+    }
+    if (isReordered) {
+        forest->shiftUp(1);
+        forest->shiftDown(numVals-1);
+    }
+    std::vector<CompiledFunc> compiled;
+    for (int test=0; test<TESTS; test++) {
+        compiled.push_back(CompiledFunc(funcs[test]));
+        if (!checkFunc(funcs[test], funs[test], numVals)) {
+            std::cout << "Test " << test << ": Func evaluation failed!" << std::endl;
+            delete forest;
+            return 0;
+        }
+    }
+    // the programs do not need the forest
+    funcs.clear();
+    delete forest;
+
+    std::vector<bool> assignment(numVals+1, 0);
+    for (int test=0; test<TESTS; test++) {
+        for (long long n=0; n<size; n++) {
+            decimalToAssignment(n, assignment);
+            int valInt;
+            compiled[test].evaluate(assignment).getValueTo(&valInt, INT);
+            if (funs[test][n] != (bool)valInt) {
+                std::cout << "Test " << test << ": compiled evaluation failed at assignment " << n << std::endl;
+                return 0;
+            }
+        }
+    }
+    std::cout << "Compiled " << compiled[0].getNumSteps() << " steps for a random function" << std::endl;
+    return 1;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_compiled [num_val] [num_tests]
+    uint16_t numVals = (argc > 1) ? atoi(argv[1]) : 10;
+    int TESTS = (argc > 2) ? atoi(argv[2]) : 16;
+
+    for (int bdd=0; bdd<5; bdd++) {
+        if (!runTests((PredefForest)bdd, numVals, TESTS, 0)) return 1;
+        if (!runTests((PredefForest)bdd, numVals, TESTS, 1)) return 1;
+    }
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
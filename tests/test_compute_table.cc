@@ -0,0 +1,80 @@
+#include "RexBDD.h"
+#include "operations/compute_table.h"
+
+/*
+ * Replacement within a bucket of the set-associative compute table: for 1, 2 and 4
+ * ways, one bucket is filled past its associativity, and the oldest entry is the one
+ * replaced, while the others still hit with their results.
+ */
+
+using namespace REXBDD;
+
+const uint16_t LVL = 1;
+
+/* Edge of the given handle */
+Edge handleEdge(EdgeHandle handle)
+{
+    Edge edge;
+    edge.setEdgeHandle(handle);
+    return edge;
+}
+
+/* Check the entry of key "a": hit with result "a"+1000 if it is expected, miss otherwise */
+bool checkEntry(ComputeTable& cache, EdgeHandle a, bool isExpected, int numWays)
+{
+    Edge ans;
+    bool isHit = cache.check(LVL, handleEdge(a), ans);
+    if (isHit != isExpected) {
+        std::cout << numWays << "-way: key " << a << (isHit ? " hits" : " misses") << "!" << std::endl;
+        return 0;
+    }
+    if (isHit && (ans.getEdgeHandle() != a + 1000)) {
+        std::cout << numWays << "-way: key " << a << " has a wrong result!" << std::endl;
+        return 0;
+    }
+    return 1;
+}
+
+bool runTests(int numWays)
+{
+    ComputeTable cache;
+    cache.setWays(numWays);
+    /* numWays+1 keys of the same bucket; the table is not enlarged for so few entries */
+    std::vector<EdgeHandle> keys;
+    uint64_t bucket = CacheEntry::hash(0, LVL, 1, 0) % PRIMES[0];
+    for (EdgeHandle a=1; (int)keys.size()<=numWays; a++) {
+        if (CacheEntry::hash(0, LVL, a, 0) % PRIMES[0] == bucket) keys.push_back(a);
+    }
+    /* Fill the bucket: each key misses until it is added, then all hit */
+    for (int k=0; k<numWays; k++) {
+        if (!checkEntry(cache, keys[k], 0, numWays)) return 0;
+        cache.add(LVL, handleEdge(keys[k]), handleEdge(keys[k] + 1000));
+    }
+    for (int k=0; k<numWays; k++) {
+        if (!checkEntry(cache, keys[k], 1, numWays)) return 0;
+    }
+    /* A hit on the oldest keys[0] makes keys[1] the oldest, unless there is one way */
+    if (!checkEntry(cache, keys[0], 1, numWays)) return 0;
+    cache.add(LVL, handleEdge(keys[numWays]), handleEdge(keys[numWays] + 1000));
+    int evicted = (numWays > 1) ? 1 : 0;
+    for (int k=0; k<=numWays; k++) {
+        if (!checkEntry(cache, keys[k], k != evicted, numWays)) return 0;
+    }
+    /* Adding a cached key again replaces nothing */
+    cache.add(LVL, handleEdge(keys[numWays]), handleEdge(keys[numWays] + 1000));
+    for (int k=0; k<=numWays; k++) {
+        if (!checkEntry(cache, keys[k], k != evicted, numWays)) return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_compute_table
+    const int ways[] = {1, 2, 4};
+    for (int w=0; w<3; w++) {
+        if (!runTests(ways[w])) return 1;
+    }
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include "test_util.h"
+
+#include "cmath"
+
+bool runTests(PredefForest bdd, uint16_t numVals, int TESTS, bool isReordered)
+{
+    ForestSetting setting(bdd, numVals);
+    Forest* forest = new Forest(setting);
+    forest->getSetting().output(std::cout);
+    long long size = 0x01LL<<(numVals);
+
+    std::vector<Func> funcs;
+    std::vector<uint64_t> ones(TESTS, 0);
+    for (int test=0; test<TESTS; test++) {
+        // dense random functions, and sparse ones whose edges skip levels
+        std::vector<bool> fun(size);
+        int a = (int)(random01() * numVals), b = (int)(random01() * numVals);
+        for (long long i=0; i<size; i++) {
+            switch (test % 4) {
+                case 0:  fun[i] = (random01() > 0.5f); break;
+                case 1:  fun[i] = ((i >> a) & 1) && ((i >> b) & 1); break;
+                case 2:  fun[i] = ((i >> a) & 1) || !((i >> b) & 1); break;
+                default: fun[i] = (test % 8 == 3); break;
+            }
+            ones[test] += fun[i];
+        }
+        funcs.push_back(Func(forest, buildEdge(forest, numVals, fun, 0, size-1)));
+    }
+    if (isReordered) {
+        forest->shiftUp(1);
+        forest->shiftDown(numVals-1);
+    }
+    for (int test=0; test<TESTS; test++) {
+        uint64_t zeros = size - ones[test];
+        if ((forest->count(funcs[test], 1) != ones[test]) || (forest->count(funcs[test], 0) != zeros)) {
+            std::cout << "Test " << test << ": count failed! " << forest->count(funcs[test], 1)
+                      << " instead of " << ones[test] << std::endl;
+            return 0;
+        }
+        if (forest->countExact(funcs[test], 1) != BigInt(ones[test])) {
+            std::cout << "Test " << test << ": exact count failed!" << std::endl;
+            return 0;
+        }
+        double log2Ones = forest->countLog2(funcs[test], 1);
+        if ((ones[test] == 0) ? (log2Ones != -INFINITY) : (std::fabs(log2Ones - std::log2((double)ones[test])) > 1e-9)) {
+            std::cout << "Test " << test << ": log2 count failed! " << log2Ones << std::endl;
+            return 0;
+        }
+        long card;
+        double cardReal;
+        BigInt cardExact;
+        apply(CARDINALITY, funcs[test], card);
+        apply(CARDINALITY, funcs[test], cardReal);
+        apply(CARDINALITY, funcs[test], cardExact);
+        if (((uint64_t)card != ones[test]) || (std::fabs(cardReal - ones[test]) > 1e-6 * (ones[test] + 1))
+            || (cardExact != BigInt(ones[test]))) {
+            std::cout << "Test " << test << ": cardinality failed!" << std::endl;
+            return 0;
+        }
+    }
+    delete forest;
+    return 1;
+}
+
+/* Parity, conjunction and disjunction of many variables, beyond 64 bits */
+bool runDeepTests(PredefForest bdd, uint16_t numVals)
+{
+    ForestSetting setting(bdd, numVals);
+    Forest* forest = new Forest(setting);
+    forest->getSetting().output(std::cout);
+    EdgeLabel label = 0;
+    packRule(label, RULE_X);
+    std::vector<Edge> child(2);
+    Edge even = terminalEdge(forest, 0), odd = terminalEdge(forest, 1);
+    Edge all = terminalEdge(forest, 1), any = terminalEdge(forest, 0);
+    for (uint16_t lvl=1; lvl<=numVals; lvl++) {
+        child[0] = even; child[1] = odd;
+        Edge nextEven = forest->reduceEdge(lvl, label, lvl, child);
+        child[0] = odd; child[1] = even;
+        odd = forest->reduceEdge(lvl, label, lvl, child);
+        even = nextEven;
+        child[0] = terminalEdge(forest, 0); child[1] = all;
+        all = forest->reduceEdge(lvl, label, lvl, child);
+        child[0] = any; child[1] = terminalEdge(forest, 1);
+        any = forest->reduceEdge(lvl, label, lvl, child);
+    }
+    Func parity(forest, odd), conjunction(forest, all), disjunction(forest, any);
+    BigInt half = BigInt::pow2(numVals-1), full = BigInt::pow2(numVals);
+    if ((forest->countExact(parity, 1) != half) || (forest->countExact(parity, 0) != half)
+        || (forest->countExact(conjunction, 1) != BigInt(1)) || (forest->countExact(conjunction, 0) != full - BigInt(1))
+        || (forest->countExact(disjunction, 1) != full - BigInt(1)) || (forest->countExact(disjunction, 0) != BigInt(1))) {
+        std::cout << "Deep test: exact count failed!" << std::endl;
+        return 0;
+    }
+    if ((std::fabs(forest->countLog2(parity, 1) - (numVals-1)) > 1e-9)
+        || (forest->countLog2(conjunction, 1) != 0) || (std::fabs(forest->countLog2(disjunction, 1) - numVals) > 1e-9)) {
+        std::cout << "Deep test: log2 count failed!" << std::endl;
+        return 0;
+    }
+    // modulo 2^64
+    if ((forest->count(parity, 1) != 0) || (forest->count(disjunction, 1) != ~(uint64_t)0)) {
+        std::cout << "Deep test: count modulo 2^64 failed!" << std::endl;
+        return 0;
+    }
+    delete forest;
+    return 1;
+}
+
+bool testBigInt()
+{
+    BigInt a = BigInt::pow2(100);
+    a -= BigInt(1);
+    BigInt b = a + BigInt(1);
+    if ((b != BigInt::pow2(100)) || (b.toString() != "1267650600228229401496703205376")
+        || (a.numBits() != 100) || (std::fabs(b.log2() - 100) > 1e-12)
+        || (BigInt(12345678901234ULL).toString() != "12345678901234") || (BigInt().toString() != "0")
+        || ((BigInt(3) << 70) - (BigInt(1) << 71) != BigInt::pow2(70)) || !(a < b) || (b < a)) {
+        std::cout << "BigInt arithmetic failed!" << std::endl;
+        return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_count [num_val] [num_tests] [num_deep_val]
+    uint16_t numVals = (argc > 1) ? atoi(argv[1]) : 10;
+    int TESTS = (argc > 2) ? atoi(argv[2]) : 16;
+    uint16_t numDeepVals = (argc > 3) ? atoi(argv[3]) : 300;
+
+    if (!testBigInt()) return 1;
+    for (int bdd=0; bdd<5; bdd++) {
+        if (!runTests((PredefForest)bdd, numVals, TESTS, 0)) return 1;
+        if (!runTests((PredefForest)bdd, numVals, TESTS, 1)) return 1;
+        if (!runDeepTests((PredefForest)bdd, numDeepVals)) return 1;
+    }
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "test_util.h"
+
+/* The elementwise operations, with their truth tables: bit 2a+b is "a op b" */
+struct Elementwise {
+    const char*     name;
+    BinaryBuiltin1  op;
+    int             table;
+};
+const Elementwise OPS[] = {
+    {"union", UNION, 0xE},              {"intersection", INTERSECTION, 0x8},
+    {"difference", DIFFERENCE, 0x4},    {"minimum", MINIMUM, 0x8},
+    {"maximum", MAXIMUM, 0xE},          {"multiply", MULTIPLY, 0x8},
+    {"equal", EQUAL, 0x9},              {"not equal", NOT_EQUAL, 0x6},
+    {"less than", LESS_THAN, 0x2},      {"less than equal", LESS_THAN_EQUAL, 0xB},
+    {"greater than", GREATER_THAN, 0x4},{"greater than equal", GREATER_THAN_EQUAL, 0xD}
+};
+
+std::vector<bool> randomFunction(long long size, uint16_t numVals, int test)
+{
+    // dense random functions, and sparse ones whose edges skip levels
+    std::vector<bool> fun(size);
+    int a = (int)(random01() * numVals), b = (int)(random01() * numVals);
+    for (long long i=0; i<size; i++) {
+        switch (test % 4) {
+            case 0:  fun[i] = (random01() > 0.5f); break;
+            case 1:  fun[i] = ((i >> a) & 1) && ((i >> b) & 1); break;
+            case 2:  fun[i] = ((i >> a) & 1) || !((i >> b) & 1); break;
+            default: fun[i] = !((i >> a) & 1) && (random01() > 0.3f); break;
+        }
+    }
+    return fun;
+}
+
+bool runTests(PredefForest bdd, uint16_t numVals, int TESTS)
+{
+    ForestSetting setting(bdd, numVals);
+    Forest* forest = new Forest(setting);
+    forest->getSetting().output(std::cout);
+    long long size = 0x01LL<<(numVals);
+
+    for (int test=0; test<TESTS; test++) {
+        std::vector<bool> fun[4];
+        fun[0] = randomFunction(size, numVals, test);
+        fun[1] = randomFunction(size, numVals, test / 4);
+        // terminal cases: the same function, its complement, and constants
+        fun[2] = fun[0];
+        fun[3] = fun[0];
+        for (long long i=0; i<size; i++) {
+            fun[2][i] = !fun[0][i];
+            fun[3][i] = (test % 2);
+        }
+        Func funcs[4];
+        for (int f=0; f<4; f++) funcs[f] = Func(forest, buildEdge(forest, numVals, fun[f], 0, size-1));
+        for (const Elementwise& e : OPS) {
+            for (int f1=0; f1<4; f1++) {
+                for (int f2=0; f2<4; f2++) {
+                    std::vector<bool> expected(size);
+                    for (long long i=0; i<size; i++) expected[i] = (e.table >> (2*fun[f1][i] + fun[f2][i])) & 1;
+                    Func res(forest);
+                    apply(e.op, funcs[f1], funcs[f2], res);
+                    if (res.getEdge() != buildEdge(forest, numVals, expected, 0, size-1)) {
+                        std::cout << "Test " << test << ": " << e.name << " failed on operands "
+                                  << f1 << " and " << f2 << "!" << std::endl;
+                        return 0;
+                    }
+                }
+            }
+        }
+        Func res = funcs[0] ^ funcs[1];
+        for (long long i=0; i<size; i++) fun[2][i] = fun[0][i] != fun[1][i];
+        if (res.getEdge() != buildEdge(forest, numVals, fun[2], 0, size-1)) {
+            std::cout << "Test " << test << ": operator ^ failed!" << std::endl;
+            return 0;
+        }
+    }
+    delete forest;
+    return 1;
+}
+
+/* The operations are on Boolean functions: a forest of a larger range is rejected */
+bool runRangeTest(uint16_t numVals)
+{
+    Forest* forest = new Forest(ForestSetting(PredefForest::FBDD, numVals, 2));
+    Func f(forest, terminalEdge(forest, 1));
+    Func res(forest);
+    bool isRejected = 0;
+    try {
+        apply(MINIMUM, f, f, res);
+    } catch (const error& e) {
+        isRejected = (e.getCode() == ErrCode::INVALID_OPERATION);
+    }
+    if (!isRejected) std::cout << "Minimum on a forest of range 2 is not rejected!" << std::endl;
+    delete forest;
+    return isRejected;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_elementwise [num_val] [num_tests]
+    uint16_t numVals = (argc > 1) ? atoi(argv[1]) : 7;
+    int TESTS = (argc > 2) ? atoi(argv[2]) : 16;
+
+    for (int bdd=0; bdd<5; bdd++) {
+        if (!runTests((PredefForest)bdd, numVals, TESTS)) return 1;
+    }
+    if (!runRangeTest(numVals)) return 1;
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include "test_util.h"
+
+bool runTests(PredefForest bdd, uint16_t numVals, int TESTS, HashingType hashing)
+{
+    ForestSetting setting(bdd, numVals);
+    setting.setHashingType(hashing);
+    // collect automatically once a few hundred nodes are alive
+    setting.setGCThreshold(200);
+    Forest* forest = new Forest(setting);
+    forest->getSetting().output(std::cout);
+    long long size = 0x01LL<<(numVals);
+
+    // Results kept alive across collections, with their truth tables
+    std::vector<Func> kept;
+    std::vector<std::vector<bool> > keptFun;
+    for (int test=0; test<TESTS; test++) {
+        Func f1(forest), f2(forest), res(forest);
+        std::vector<bool> fun1(size), fun2(size), funRes(size);
+        for (long long i=0; i<size; i++) {
+            fun1[i] = (random01() > 0.5f)? 1 : 0;
+            fun2[i] = (random01() > 0.5f)? 1 : 0;
+            funRes[i] = fun1[i] && fun2[i];
+        }
+        Edge e1 = buildEdge(forest, numVals, fun1, 0, size-1);
+        Edge e2 = buildEdge(forest, numVals, fun2, 0, size-1);
+        f1.setEdge(e1);
+        f2.setEdge(e2);
+        res = f1 & f2;
+        if (!checkFunc(res, funRes, numVals)) {
+            std::cout << "Test " << test << ": result (AND) evaluation failed!" << std::endl;
+            delete forest;
+            return 0;
+        }
+        if (test % 4 == 0) {
+            kept.push_back(res);
+            keptFun.push_back(funRes);
+        }
+        if (test % 10 == 9) {
+            uint64_t before = forest->getCurrentNodes();
+            forest->markSweep();
+            // the peak survives the collection
+            if (forest->getPeakNodes() < before) {
+                std::cout << "Peak nodes " << forest->getPeakNodes() << " below " << before << std::endl;
+                delete forest;
+                return 0;
+            }
+            std::cout << "GC: " << before << " -> " << forest->getCurrentNodes() << " nodes; reclaimed "
+                      << forest->getStatistics().getLastGCNodes() << " in "
+                      << forest->getStatistics().getLastGCTime() << " s" << std::endl;
+        }
+    }
+    // The kept Funcs survived, and are still canonical
+    forest->markSweep();
+    if (forest->countNodes() != forest->getCurrentNodes()) {
+        std::cout << "Nodes left after garbage collection are not all reachable!" << std::endl;
+        delete forest;
+        return 0;
+    }
+    for (size_t i=0; i<kept.size(); i++) {
+        Edge e = buildEdge(forest, numVals, keptFun[i], 0, size-1);
+        if (!checkFunc(kept[i], keptFun[i], numVals)
+            || (e.getEdgeHandle() != kept[i].getEdge().getEdgeHandle())) {
+            std::cout << "Kept Func " << i << " was damaged by garbage collection!" << std::endl;
+            delete forest;
+            return 0;
+        }
+    }
+    if (!forest->getStatistics().getTotalGCNodes()) {
+        std::cout << "Nothing was reclaimed!" << std::endl;
+        delete forest;
+        return 0;
+    }
+    std::cout << "GC runs: " << forest->getStatistics().getNumGCs() << "; reclaimed "
+              << forest->getStatistics().getTotalGCNodes() << " nodes" << std::endl;
+    StatsSnapshot snap = forest->getStatsSnapshot();
+    snap.dump(std::cout);
+#ifndef REXBDD_NO_STATS
+    if ((snap.numGCs != forest->getStatistics().getNumGCs())
+        || (snap.createdNodes != snap.activeNodes + snap.totalGCNodes)) {
+        std::cout << "Statistics snapshot is inconsistent!" << std::endl;
+        delete forest;
+        return 0;
+    }
+#endif
+    delete forest;
+    return 1;
+}
+
+/* The parity of numVars variables, a chain of nodes as deep as the forest */
+bool runDeepTest(PredefForest bdd, uint16_t numVars)
+{
+    ForestSetting setting(bdd, numVars);
+    Forest* forest = new Forest(setting);
+    bool isFloat = (forest->getSetting().getValType() == FLOAT);
+    std::vector<Edge> child(2);
+    EdgeLabel label = 0;
+    packRule(label, RULE_X);
+    // x1 xor ... xor xk, and its complement
+    Edge xorK, xnorK;
+    xorK.setEdgeHandle(isFloat ? makeTerminal(FLOAT, 0.0f) : makeTerminal(INT, 0));
+    xnorK.setEdgeHandle(isFloat ? makeTerminal(FLOAT, 1.0f) : makeTerminal(INT, 1));
+    xorK.setRule(RULE_X);
+    xnorK.setRule(RULE_X);
+    for (uint16_t lvl=1; lvl<=numVars; lvl++) {
+        child[0] = xorK;
+        child[1] = xnorK;
+        Edge nextXor = forest->reduceEdge(lvl, label, lvl, child);
+        child[0] = xnorK;
+        child[1] = xorK;
+        xnorK = forest->reduceEdge(lvl, label, lvl, child);
+        xorK = nextXor;
+    }
+    Func parity(forest);
+    parity.setEdge(xorK);
+    // the complement chain is garbage, unless it shares the nodes by complement edges;
+    // the bottom node may be reduced by a rule
+    forest->markSweep();
+    uint64_t num = forest->countNodes();
+    std::vector<bool> assignment(numVars+1, 0);
+    assignment[1] = assignment[numVars/2] = assignment[numVars] = 1;
+    int valInt;
+    parity.evaluate(assignment).getValueTo(&valInt, INT);
+    bool pass = (num == forest->getCurrentNodes()) && (num + 1 >= numVars)
+                && (forest->countNodesAtLevel(numVars, parity) == 1) && (valInt == 1);
+    std::cout << "Deep test: " << num << " nodes over " << numVars << " levels" << std::endl;
+    delete forest;
+    return pass;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_gc [num_val] [num_tests]
+    uint16_t numVals = (argc > 1) ? atoi(argv[1]) : 8;
+    int TESTS = (argc > 2) ? atoi(argv[2]) : 40;
+
+    for (int bdd=0; bdd<5; bdd++) {
+        if (!runTests((PredefForest)bdd, numVals, TESTS, CHAINING)) return 1;
+        if (!runTests((PredefForest)bdd, numVals, TESTS, OPEN_ADDRESSING)) return 1;
+        if (!runDeepTest((PredefForest)bdd, 60000)) {
+            std::cout << "Deep test failed!" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "test_util.h"
+
+bool runTests(PredefForest bdd, PredefForest bmxd, uint16_t numVals, int TESTS)
+{
+    ForestSetting setting(bdd, numVals);
+    Forest* forest = new Forest(setting);
+    ForestSetting relSetting(bmxd, numVals);
+    Forest* relForest = new Forest(relSetting);
+    std::cout << setting.getName() << " x " << relSetting.getName() << std::endl;
+    long size = 1L << numVals;
+
+    for (int test=0; test<TESTS; test++) {
+        std::vector<bool> fun(size), rel(size * size, 0);
+        for (long i=0; i<size; i++) fun[i] = (test % 3 == 2) ? (i == test % size) : (random01() > 0.5f);
+        // dense and sparse random relations, the identity, and a cyclic shift
+        for (long from=0; from<size; from++) {
+            for (long to=0; to<size; to++) {
+                bool isPair;
+                switch (test % 4) {
+                    case 0:  isPair = (random01() > 0.5f); break;
+                    case 1:  isPair = (random01() > 0.9f); break;
+                    case 2:  isPair = (from == to); break;
+                    default: isPair = (to == (from + 1) % size); break;
+                }
+                rel[pairIndex(from, to, numVals)] = isPair;
+            }
+        }
+        Func set(forest, buildEdge(forest, numVals, fun, 0, size-1));
+        Func trans(relForest, buildRelation(relForest, numVals, rel, 0));
+        std::vector<bool> post(size, 0), pre(size, 0);
+        for (long from=0; from<size; from++) {
+            for (long to=0; to<size; to++) {
+                if (!rel[pairIndex(from, to, numVals)]) continue;
+                if (fun[from]) post[to] = 1;
+                if (fun[to]) pre[from] = 1;
+            }
+        }
+        Func res(forest);
+        apply(POST_IMAGE, set, trans, res);
+        if (!checkFunc(res, post, numVals)) {
+            std::cout << "Test " << test << ": post-image failed!" << std::endl;
+            return 0;
+        }
+        apply(PRE_IMAGE, set, trans, res);
+        if (!checkFunc(res, pre, numVals)) {
+            std::cout << "Test " << test << ": pre-image failed!" << std::endl;
+            return 0;
+        }
+    }
+    delete forest;
+    delete relForest;
+    return 1;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_image [num_val] [num_tests]
+    uint16_t numVals = (argc > 1) ? atoi(argv[1]) : 5;
+    int TESTS = (argc > 2) ? atoi(argv[2]) : 40;
+
+    for (int bdd=0; bdd<5; bdd++) {
+        for (int bmxd=5; bmxd<8; bmxd++) {
+            if (!runTests((PredefForest)bdd, (PredefForest)bmxd, numVals, TESTS)) return 1;
+        }
+    }
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include "test_util.h"
+
+#include <sstream>
+
+/* Write random Funcs, read them back into the same setting, and check they are the same functions */
+bool runTests(PredefForest bdd, uint16_t numVals, int TESTS)
+{
+    ForestSetting setting(bdd, numVals);
+    Forest* source = new Forest(setting);
+    Forest* target = new Forest(setting);
+    source->getSetting().output(std::cout);
+    long long size = 0x01LL<<(numVals);
+
+    FuncArray funcs(source, TESTS);
+    std::vector<std::vector<bool> > funs(TESTS, std::vector<bool>(size));
+    for (int test=0; test<TESTS; test++) {
+        for (long long i=0; i<size; i++) {
+            funs[test][i] = (random01() > 0.5f)? 1 : 0;
+        }
+        // a few constants too, whose edges go straight to terminals
+        if (test == 1) funs[test].assign(size, 0);
+        if (test == 2) funs[test].assign(size, 1);
+        Func f(source, buildEdge(source, numVals, funs[test], 0, size-1));
+        f.setName("f" + std::to_string(test));
+        funcs.add(f);
+    }
+    std::stringstream file;
+    source->exportFunc(file, funcs);
+    FuncArray loaded = target->importFunc(file);
+
+    bool pass = (loaded.size() == TESTS) && loaded.isAttachedTo(target)
+                && (target->countNodes(loaded) == source->countNodes(funcs));
+    for (int test=0; pass && (test<TESTS); test++) {
+        // same function, same name, and canonical in the target forest
+        Edge e = buildEdge(target, numVals, funs[test], 0, size-1);
+        pass = checkFunc(loaded[test], funs[test], numVals)
+                && (loaded[test].getName() == funcs[test].getName())
+                && (e.getEdgeHandle() == loaded[test].getEdge().getEdgeHandle());
+        if (!pass) std::cout << "Test " << test << ": loaded Func differs!" << std::endl;
+    }
+    // reading into the source forest gives back the very same edges
+    file.clear();
+    file.seekg(0);
+    FuncArray again = source->importFunc(file);
+    for (int test=0; pass && (test<TESTS); test++) {
+        pass = (again[test].getEdge().getEdgeHandle() == funcs[test].getEdge().getEdgeHandle());
+        if (!pass) std::cout << "Test " << test << ": reloaded Func is not the same edge!" << std::endl;
+    }
+    std::cout << "Wrote " << file.str().size() << " bytes for " << source->countNodes(funcs) << " nodes" << std::endl;
+    delete source;
+    delete target;
+    return pass;
+}
+
+/* The whole forest, after a reordering of the variables */
+bool runForestTest(PredefForest bdd, uint16_t numVals, int TESTS)
+{
+    ForestSetting setting(bdd, numVals);
+    Forest* source = new Forest(setting);
+    Forest* target = new Forest(setting);
+    long long size = 0x01LL<<(numVals);
+
+    std::vector<Func> funcs;
+    std::vector<std::vector<bool> > funs(TESTS, std::vector<bool>(size));
+    for (int test=0; test<TESTS; test++) {
+        for (long long i=0; i<size; i++) {
+            funs[test][i] = (random01() > 0.5f)? 1 : 0;
+        }
+        funcs.push_back(Func(source, buildEdge(source, numVals, funs[test], 0, size-1)));
+    }
+    source->shiftUp(1);
+    source->shiftDown(numVals-1);
+    // the target needs the same variable order
+    target->shiftUp(1);
+    target->shiftDown(numVals-1);
+    std::stringstream file;
+    source->exportForest(file);
+    target->importForest(file);
+    const FuncArray* loaded = target->getImportedFuncs();
+
+    bool pass = loaded && (loaded->size() == TESTS) && (target->countNodes() == source->countNodes());
+    for (int i=0; pass && (i<loaded->size()); i++) {
+        // the registry lists the Funcs from the newest, so look for the matching truth table
+        bool found = 0;
+        for (int test=0; !found && (test<TESTS); test++) {
+            found = checkFunc((*loaded)[i], funs[test], numVals);
+        }
+        pass = found;
+        if (!pass) std::cout << "Func " << i << " of the forest is not one of the written ones!" << std::endl;
+    }
+    delete source;
+    delete target;
+    return pass;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_io [num_val] [num_tests]
+    uint16_t numVals = (argc > 1) ? atoi(argv[1]) : 8;
+    int TESTS = (argc > 2) ? atoi(argv[2]) : 20;
+
+    for (int bdd=0; bdd<5; bdd++) {
+        if (!runTests((PredefForest)bdd, numVals, TESTS)) return 1;
+        if (!runForestTest((PredefForest)bdd, numVals, TESTS)) {
+            std::cout << "Forest test failed!" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
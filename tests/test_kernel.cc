@@ -0,0 +1,82 @@
+#include "test_util.h"
+
+/* The predefined forests use the kernels specialized for them */
+bool testSelection(uint16_t numVals)
+{
+    for (int bdd=0; bdd<8; bdd++) {
+        Forest forest(ForestSetting((PredefForest)bdd, numVals));
+        if (!forest.hasPredefKernel()) {
+            std::cout << "Forest " << forest.getSetting().getName() << " does not use its kernels!" << std::endl;
+            return 0;
+        }
+    }
+    const char* names[] = {"rexbdd", "qbdd", "fbdd", "zbdd", "esrbdd"};
+    for (const char* name : names) {
+        Forest forest(ForestSetting(name, numVals));
+        if (!forest.hasPredefKernel()) {
+            std::cout << "Forest " << name << " does not use its kernels!" << std::endl;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* User-defined forests read their setting: elementwise operations are checked on them */
+bool runTests(const ForestSetting& setting, uint16_t numVals, int TESTS)
+{
+    Forest* forest = new Forest(setting);
+    if (forest->hasPredefKernel()) {
+        std::cout << "User-defined forest uses predefined kernels!" << std::endl;
+        return 0;
+    }
+    long long size = 0x01LL<<(numVals);
+    // bit 2a+b is "a op b"
+    const BinaryBuiltin1 ops[] = {UNION, INTERSECTION, DIFFERENCE, NOT_EQUAL};
+    const int tables[] = {0xE, 0x8, 0x4, 0x6};
+
+    for (int test=0; test<TESTS; test++) {
+        std::vector<bool> fun[2];
+        int a = (int)(random01() * numVals);
+        for (int f=0; f<2; f++) {
+            fun[f].resize(size);
+            for (long long i=0; i<size; i++) fun[f][i] = ((test % 2) && ((i >> a) & 1)) || (random01() > 0.7f);
+        }
+        Func funcs[2];
+        for (int f=0; f<2; f++) funcs[f] = Func(forest, buildEdge(forest, numVals, fun[f], 0, size-1));
+        for (int o=0; o<4; o++) {
+            std::vector<bool> expected(size);
+            for (long long i=0; i<size; i++) expected[i] = (tables[o] >> (2*fun[0][i] + fun[1][i])) & 1;
+            Func res(forest);
+            apply(ops[o], funcs[0], funcs[1], res);
+            if (res.getEdge() != buildEdge(forest, numVals, expected, 0, size-1)) {
+                std::cout << "Test " << test << ": operation " << o << " failed!" << std::endl;
+                return 0;
+            }
+        }
+    }
+    delete forest;
+    return 1;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_kernel [num_val] [num_tests]
+    uint16_t numVals = (argc > 1) ? atoi(argv[1]) : 7;
+    int TESTS = (argc > 2) ? atoi(argv[2]) : 16;
+
+    if (!testSelection(numVals)) return 1;
+    // ESRBDD without EL0 or without EH0
+    for (int r=0; r<2; r++) {
+        ForestSetting setting(PredefForest::ESRBDD, numVals);
+        setting.delReductionRule((r == 0) ? RULE_EL0 : RULE_EH0);
+        setting.output(std::cout);
+        if (!runTests(setting, numVals, TESTS)) return 1;
+    }
+    // ZBDD with the X rule
+    ForestSetting setting(PredefForest::ZBDD, numVals);
+    setting.addReductionRule(RULE_X);
+    setting.output(std::cout);
+    if (!runTests(setting, numVals, TESTS)) return 1;
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include "test_util.h"
+
+/*
+ * Forests are created and destroyed with the unary, binary and saturation operations
+ * they use still cached: deleting a forest removes its operations and their compute
+ * tables, which must be released exactly once. Meant to also run with REXBDD_SANITIZE.
+ */
+
+/* Run the cached operations on a set forest and a relation forest, then delete both */
+bool runRound(PredefForest bdd, PredefForest bmxd, uint16_t numVals, int numThreads, bool isSetFirst)
+{
+    ForestSetting setting(bdd, numVals);
+    setting.setNumThreads(numThreads);
+    setting.setParallelLevel(2);
+    Forest* forest = new Forest(setting);
+    Forest* relForest = new Forest(ForestSetting(bmxd, numVals));
+    long long size = 0x01LL<<(numVals);
+
+    std::vector<bool> fun1(size), fun2(size), funRes(size);
+    for (long long i=0; i<size; i++) {
+        fun1[i] = (random01() > 0.5f)? 1 : 0;
+        fun2[i] = (random01() > 0.5f)? 1 : 0;
+        funRes[i] = fun1[i] || !fun2[i];
+    }
+    Func f1(forest, buildEdge(forest, numVals, fun1, 0, size-1));
+    Func f2(forest, buildEdge(forest, numVals, fun2, 0, size-1));
+    // unary and binary operations, twice for the cached results
+    Func res(forest);
+    for (int r=0; r<2; r++) res = f1 | !f2;
+    if (!checkFunc(res, funRes, numVals)) {
+        std::cout << setting.getName() << ": operation failed!" << std::endl;
+        return 0;
+    }
+    long card;
+    apply(CARDINALITY, res, card);
+    Func exist(forest);
+    apply(EQUANTIFY, f1 & f2, std::vector<uint16_t>(1, 1), exist);
+    // image and saturation over the identity on the lowest variable
+    std::vector<bool> rel(size * size, 0);
+    for (long from=0; from<size; from++) rel[pairIndex(from, from ^ 1, numVals)] = 1;
+    FuncArray events(relForest, 1);
+    events.add(Func(relForest, buildRelation(relForest, numVals, rel, 0)));
+    Func image(forest);
+    apply(POST_IMAGE, f1, events[0], image);
+    Func reached = saturate(f1, events);
+
+    if (isSetFirst) {
+        delete forest;
+        delete relForest;
+    } else {
+        delete relForest;
+        delete forest;
+    }
+    return 1;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_lifetime [num_val] [num_rounds]
+    uint16_t numVals = (argc > 1) ? atoi(argv[1]) : 6;
+    int ROUNDS = (argc > 2) ? atoi(argv[2]) : 4;
+
+    const PredefForest bmxds[] = {PredefForest::FBMXD, PredefForest::IBMXD, PredefForest::ESRBMXD};
+    for (int round=0; round<ROUNDS; round++) {
+        for (int bdd=0; bdd<5; bdd++) {
+            int numThreads = (round % 2) ? 4 : 1;
+            if (!runRound((PredefForest)bdd, bmxds[(round + bdd) % 3], numVals, numThreads, bdd % 2)) return 1;
+        }
+    }
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
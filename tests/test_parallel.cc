@@ -0,0 +1,162 @@
+#include "test_util.h"
+
+/* Check the result of an operation against its expected truth table, and that it is canonical */
+bool checkResult(Forest* forest, const Func& res, std::vector<bool>& funRes, uint16_t numVals, const char* name)
+{
+    long long size = 0x01LL<<(numVals);
+    // the same function built sequentially is the same edge
+    if (buildEdge(forest, numVals, funRes, 0, size-1).getEdgeHandle() != res.getEdge().getEdgeHandle()) {
+        std::cout << "result (" << name << ") is not canonical!" << std::endl;
+        return 0;
+    }
+    if (!checkFunc(res, funRes, numVals)) {
+        std::cout << "result (" << name << ") evaluation failed!" << std::endl;
+        return 0;
+    }
+    return 1;
+}
+
+/* Forest whose elementwise operations run in parallel: sub-problems are spawned down to level 2 */
+Forest* parallelForest(PredefForest bdd, uint16_t numVals, int numThreads, HashingType hashing)
+{
+    ForestSetting setting(bdd, numVals);
+    setting.setNumThreads(numThreads);
+    setting.setParallelLevel(2);
+    setting.setHashingType(hashing);
+    Forest* forest = new Forest(setting);
+    forest->getSetting().output(std::cout);
+    return forest;
+}
+
+bool runTests(PredefForest bdd, uint16_t numVals, int TESTS, int numThreads, HashingType hashing)
+{
+    Forest* forest = parallelForest(bdd, numVals, numThreads, hashing);
+
+    // Randomly generate assignments, build two BDDs, and check AND and OR
+    for (int test=0; test<TESTS; test++) {
+        long long size = 0x01LL<<(numVals);
+        std::vector<bool> fun1(size);
+        std::vector<bool> fun2(size);
+        std::vector<bool> funAnd(size);
+        std::vector<bool> funOr(size);
+        for (long long i=0; i<size; i++) {
+            fun1[i] = (random01() > 0.5f)? 1 : 0;
+            fun2[i] = (random01() > 0.5f)? 1 : 0;
+            funAnd[i] = fun1[i] && fun2[i];
+            funOr[i] = fun1[i] || fun2[i];
+        }
+        Func f1(forest, buildEdge(forest, numVals, fun1, 0, size-1));
+        Func f2(forest, buildEdge(forest, numVals, fun2, 0, size-1));
+        Func resAnd = f1 & f2;
+        Func resOr = f1 | f2;
+        if (!checkResult(forest, resAnd, funAnd, numVals, "AND") || !checkResult(forest, resOr, funOr, numVals, "OR")) {
+            std::cout << "Test " << test << " failed!" << std::endl;
+            delete forest;
+            return 0;
+        }
+    }
+    // counters of all workers are added up
+    StatsSnapshot snap = forest->getStatsSnapshot();
+    snap.dump(std::cout);
+#ifndef REXBDD_NO_STATS
+    if ((snap.numOps == 0) || (snap.numHitsCT + snap.numOpsTerms > snap.numOps)
+        || (snap.createdNodes < snap.activeNodes) || (snap.peakNodes < snap.activeNodes)) {
+        std::cout << "Statistics snapshot is inconsistent!" << std::endl;
+        delete forest;
+        return 0;
+    }
+#endif
+    delete forest;
+    return 1;
+}
+
+/*
+ * Operations with complemented operands in their terminal cases: on forests without
+ * complement flags, the workers share the complement operation of the result forest.
+ */
+bool runComplementTests(PredefForest bdd, uint16_t numVals, int TESTS, int numThreads)
+{
+    Forest* forest = parallelForest(bdd, numVals, numThreads, CHAINING);
+    for (int test=0; test<TESTS; test++) {
+        long long size = 0x01LL<<(numVals);
+        std::vector<bool> fun1(size), fun2(size), funDiff(size), funEqual(size);
+        for (long long i=0; i<size; i++) {
+            fun1[i] = (random01() > 0.5f)? 1 : 0;
+            fun2[i] = (random01() > 0.5f)? 1 : 0;
+            funDiff[i] = fun1[i] && !fun2[i];
+            funEqual[i] = (fun1[i] == fun2[i]);
+        }
+        Func f1(forest, buildEdge(forest, numVals, fun1, 0, size-1));
+        Func f2(forest, buildEdge(forest, numVals, fun2, 0, size-1));
+        Func resDiff(forest), resEqual(forest);
+        apply(DIFFERENCE, f1, f2, resDiff);
+        apply(EQUAL, f1, f2, resEqual);
+        if (!checkResult(forest, resDiff, funDiff, numVals, "DIFFERENCE")
+            || !checkResult(forest, resEqual, funEqual, numVals, "EQUAL")) {
+            std::cout << "Test " << test << " failed!" << std::endl;
+            delete forest;
+            return 0;
+        }
+    }
+    delete forest;
+    return 1;
+}
+
+/*
+ * Parities of many variables have exponentially many paths over few nodes: their
+ * operations only stay small if the workers find the shared sub-problems in the
+ * compute table.
+ */
+bool runCacheTest(PredefForest bdd, uint16_t numVals, int numThreads, HashingType hashing)
+{
+    Forest* forest = parallelForest(bdd, numVals, numThreads, hashing);
+    long long size = 0x01LL<<(numVals);
+    std::vector<bool> fun1(size), fun2(size), funAnd(size), funOr(size);
+    for (long long i=0; i<size; i++) {
+        fun1[i] = __builtin_parityll(i);
+        fun2[i] = __builtin_parityll(i & 0x5555555555555555LL);
+        funAnd[i] = fun1[i] && fun2[i];
+        funOr[i] = fun1[i] || fun2[i];
+    }
+    Func f1(forest, buildEdge(forest, numVals, fun1, 0, size-1));
+    Func f2(forest, buildEdge(forest, numVals, fun2, 0, size-1));
+    StatsSnapshot before = forest->getStatsSnapshot();
+    Func resAnd = f1 & f2;
+    Func resOr = f1 | f2;
+    StatsSnapshot after = forest->getStatsSnapshot();
+    if (!checkResult(forest, resAnd, funAnd, numVals, "AND") || !checkResult(forest, resOr, funOr, numVals, "OR")) {
+        delete forest;
+        return 0;
+    }
+#ifndef REXBDD_NO_STATS
+    // a few calls per node and level, far from one per path
+    uint64_t ops = after.numOps - before.numOps;
+    uint64_t hits = after.numHitsCT - before.numHitsCT;
+    std::cout << "parities: ops " << ops << "; hits " << hits << std::endl;
+    if ((hits == 0) || (ops > (uint64_t)64 * numVals * numThreads)) {
+        std::cout << "Compute table hits are too few!" << std::endl;
+        delete forest;
+        return 0;
+    }
+#endif
+    delete forest;
+    return 1;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_parallel [PredefForest::bdd] [num_val] [num_tests] [num_threads]
+    PredefForest bdd = (argc > 1) ? (PredefForest)atoi(argv[1]) : PredefForest::REXBDD;
+    uint16_t numVals = (argc > 2) ? atoi(argv[2]) : 10;
+    int TESTS = (argc > 3) ? atoi(argv[3]) : 20;
+    int numThreads = (argc > 4) ? atoi(argv[4]) : 4;
+
+    if (!runTests(bdd, numVals, TESTS, numThreads, CHAINING)) return 1;
+    if (!runTests(bdd, numVals, TESTS, numThreads, OPEN_ADDRESSING)) return 1;
+    if (!runCacheTest(bdd, numVals + 6, numThreads, CHAINING)) return 1;
+    if (!runCacheTest(bdd, numVals + 6, numThreads, OPEN_ADDRESSING)) return 1;
+    if (!runComplementTests(PredefForest::FBDD, numVals + 2, TESTS, numThreads)) return 1;
+    if (!runComplementTests(PredefForest::QBDD, numVals + 2, TESTS, numThreads)) return 1;
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
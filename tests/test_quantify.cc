@@ -0,0 +1,119 @@
+#include "test_util.h"
+
+/* Explicit quantification of a truth table, where variable v is bit v-1 of the index */
+std::vector<bool> quantify(const std::vector<bool>& fun, const std::vector<uint16_t>& vars, bool isExist)
+{
+    std::vector<bool> ans = fun;
+    for (size_t k=0; k<vars.size(); k++) {
+        long long bit = 0x01LL<<(vars[k]-1);
+        for (long long i=0; i<(long long)ans.size(); i++) {
+            bool other = ans[i ^ bit];
+            ans[i] = (isExist) ? (ans[i] || other) : (ans[i] && other);
+        }
+    }
+    return ans;
+}
+
+bool runTests(PredefForest bdd, uint16_t numVals, int TESTS)
+{
+    ForestSetting setting(bdd, numVals);
+    Forest* forest = new Forest(setting);
+    forest->getSetting().output(std::cout);
+    long long size = 0x01LL<<(numVals);
+
+    for (int test=0; test<TESTS; test++) {
+        // dense random functions, and sparse ones whose edges skip levels
+        std::vector<bool> fun(size);
+        int a = (int)(random01() * numVals), b = (int)(random01() * numVals);
+        for (long long i=0; i<size; i++) {
+            switch (test % 4) {
+                case 0:  fun[i] = (random01() > 0.5f); break;
+                case 1:  fun[i] = ((i >> a) & 1) && ((i >> b) & 1); break;
+                case 2:  fun[i] = ((i >> a) & 1) || !((i >> b) & 1); break;
+                default: fun[i] = !((i >> a) & 1) && (random01() > 0.3f); break;
+            }
+        }
+        Func func(forest, buildEdge(forest, numVals, fun, 0, size-1));
+        // random sets of variables, with repetitions; the first set is used twice
+        std::vector<std::vector<uint16_t> > sets;
+        for (int s=0; s<3; s++) {
+            std::vector<uint16_t> vars;
+            int num = (int)(random01() * (numVals + 1));
+            for (int k=0; k<num; k++) vars.push_back(1 + (uint16_t)(random01() * numVals));
+            sets.push_back(vars);
+        }
+        sets.push_back(sets[0]);
+        for (size_t s=0; s<sets.size(); s++) {
+            for (int isExist=0; isExist<2; isExist++) {
+                std::vector<bool> expected = quantify(fun, sets[s], isExist);
+                Func res(forest);
+                apply((isExist) ? EQUANTIFY : UQUANTIFY, func, sets[s], res);
+                if (res.getEdge() != buildEdge(forest, numVals, expected, 0, size-1)) {
+                    std::cout << "Test " << test << ": " << ((isExist) ? "existential" : "universal")
+                              << " quantification failed over " << sets[s].size() << " variables!" << std::endl;
+                    return 0;
+                }
+            }
+        }
+    }
+    delete forest;
+    return 1;
+}
+
+/* Abstract all the variables but one from a conjunction and a disjunction of many variables */
+bool runDeepTests(PredefForest bdd, uint16_t numVals)
+{
+    ForestSetting setting(bdd, numVals);
+    Forest* forest = new Forest(setting);
+    forest->getSetting().output(std::cout);
+    EdgeLabel label = 0;
+    packRule(label, RULE_X);
+    std::vector<Edge> child(2);
+    uint16_t kept = numVals / 2;
+    Edge all = terminalEdge(forest, 1), any = terminalEdge(forest, 0), var = terminalEdge(forest, 1);
+    for (uint16_t lvl=1; lvl<=numVals; lvl++) {
+        child[0] = terminalEdge(forest, 0); child[1] = all;
+        all = forest->reduceEdge(lvl, label, lvl, child);
+        child[0] = any; child[1] = terminalEdge(forest, 1);
+        any = forest->reduceEdge(lvl, label, lvl, child);
+        child[0] = (lvl == kept) ? terminalEdge(forest, 0) : var; child[1] = var;
+        var = forest->reduceEdge(lvl, label, lvl, child);
+    }
+    Func conjunction(forest, all), disjunction(forest, any), res(forest);
+    std::vector<uint16_t> others;
+    for (uint16_t v=numVals; v>0; v--) {
+        if (v != kept) others.push_back(v);
+    }
+    apply(EQUANTIFY, conjunction, others, res);
+    if (res.getEdge() != var) {
+        std::cout << "Deep test: existential quantification failed!" << std::endl;
+        return 0;
+    }
+    apply(UQUANTIFY, disjunction, others, res);
+    if (res.getEdge() != var) {
+        std::cout << "Deep test: universal quantification failed!" << std::endl;
+        return 0;
+    }
+    apply(UQUANTIFY, conjunction, others, res);
+    if (forest->countExact(res, 1) != BigInt(0)) {
+        std::cout << "Deep test: universal quantification of a conjunction failed!" << std::endl;
+        return 0;
+    }
+    delete forest;
+    return 1;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_quantify [num_val] [num_tests] [num_deep_val]
+    uint16_t numVals = (argc > 1) ? atoi(argv[1]) : 8;
+    int TESTS = (argc > 2) ? atoi(argv[2]) : 16;
+    uint16_t numDeepVals = (argc > 3) ? atoi(argv[3]) : 300;
+
+    for (int bdd=0; bdd<5; bdd++) {
+        if (!runTests((PredefForest)bdd, numVals, TESTS)) return 1;
+        if (!runDeepTests((PredefForest)bdd, numDeepVals)) return 1;
+    }
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
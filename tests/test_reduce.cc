@@ -112,5 +112,5 @@ int main(int argc, char** argv)
     } else {
         std::cout << "Test Pass!" << std::endl;
     }
-    return pass;
+    return !pass;
 }
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "test_util.h"
+
+/* Build the function given by its truth table (indexed by variables), in the current order */
+Edge buildEdge(Forest* forest, uint16_t lvl, std::vector<bool>& fun, long long index)
+{
+    std::vector<Edge> child(2);
+    EdgeLabel label = 0;
+    packRule(label, RULE_X);
+    uint16_t var = forest->getSetting().getVar(lvl);
+    for (int i=0; i<2; i++) {
+        long long next = index | ((long long)i<<(var-1));
+        if (lvl == 1) {
+            child[i] = terminalEdge(forest, fun[next]);
+        } else {
+            child[i] = buildEdge(forest, lvl-1, fun, next);
+        }
+    }
+    return forest->reduceEdge(lvl, label, lvl, child);
+}
+
+/* Check the Funcs against their truth tables, and that they are canonical in the current order */
+bool checkFuncs(Forest* forest, std::vector<Func>& funcs, std::vector<std::vector<bool> >& funs, uint16_t numVals)
+{
+    long long size = 0x01LL<<(numVals);
+    std::vector<bool> assignment(numVals+1, 0);
+    for (size_t f=0; f<funcs.size(); f++) {
+        for (long long n=0; n<size; n++) {
+            decimalToAssignment(n, assignment);
+            int valInt;
+            funcs[f].evaluate(assignment).getValueTo(&valInt, INT);
+            if (funs[f][n] != (bool)valInt) {
+                std::cout << "Func " << f << " evaluation failed at " << n << std::endl;
+                return 0;
+            }
+        }
+        Edge e = buildEdge(forest, numVals, funs[f], 0);
+        if (e.getEdgeHandle() != funcs[f].getEdge().getEdgeHandle()) {
+            std::cout << "Func " << f << " is not canonical!" << std::endl;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+bool runTests(PredefForest bdd, uint16_t numVals, int TESTS, HashingType hashing)
+{
+    ForestSetting setting(bdd, numVals);
+    setting.setHashingType(hashing);
+    Forest* forest = new Forest(setting);
+    forest->getSetting().output(std::cout);
+    long long size = 0x01LL<<(numVals);
+    std::vector<Func> funcs;
+    std::vector<std::vector<bool> > funs;
+    for (int test=0; test<TESTS; test++) {
+        std::vector<bool> fun(size);
+        for (long long i=0; i<size; i++) {
+            fun[i] = (random01() > 0.5f)? 1 : 0;
+        }
+        Func f(forest);
+        Edge e = buildEdge(forest, numVals, fun, 0);
+        f.setEdge(e);
+        funcs.push_back(f);
+        funs.push_back(fun);
+    }
+    // adjacent exchanges
+    for (int i=0; i<2*numVals; i++) {
+        unsigned lvl = 1 + (unsigned)(random01() * (numVals-1));
+        if (random01() > 0.5f) {
+            forest->shiftUp(lvl);
+        } else {
+            forest->shiftDown(lvl+1);
+        }
+        if (!checkFuncs(forest, funcs, funs, numVals)) {
+            std::cout << "Failed after exchanging levels " << lvl << " and " << lvl+1 << std::endl;
+            delete forest;
+            return 0;
+        }
+    }
+    // the reversed order
+    std::vector<unsigned> order(numVals+1, 0);
+    for (uint16_t k=1; k<=numVals; k++) order[k] = numVals+1-k;
+    forest->reorder(order.data());
+    for (uint16_t k=1; k<=numVals; k++) {
+        if (forest->getSetting().getVar(k) != order[k]) {
+            std::cout << "Reorder failed at level " << k << std::endl;
+            delete forest;
+            return 0;
+        }
+    }
+    if (!checkFuncs(forest, funcs, funs, numVals)) {
+        std::cout << "Failed after reordering" << std::endl;
+        delete forest;
+        return 0;
+    }
+    // sifting
+    uint64_t before = forest->countNodes();
+    forest->sift();
+    uint64_t after = forest->countNodes();
+    std::cout << "Sifting random functions: " << before << " -> " << after << " nodes" << std::endl;
+    if ((after > before) || !checkFuncs(forest, funcs, funs, numVals)) {
+        std::cout << "Failed after sifting" << std::endl;
+        delete forest;
+        return 0;
+    }
+    delete forest;
+    return 1;
+}
+
+/* (x1 & x(n+1)) | (x2 & x(n+2)) | ... in the order x1, ..., x2n: exponential until the pairs are adjacent */
+bool runSiftTest(PredefForest bdd, uint16_t numPairs)
+{
+    uint16_t numVals = 2 * numPairs;
+    ForestSetting setting(bdd, numVals);
+    Forest* forest = new Forest(setting);
+    long long size = 0x01LL<<(numVals);
+    std::vector<bool> assignment(numVals+1, 0);
+    std::vector<std::vector<bool> > funs(1, std::vector<bool>(size));
+    for (long long n=0; n<size; n++) {
+        decimalToAssignment(n, assignment);
+        for (uint16_t i=1; i<=numPairs; i++) {
+            if (assignment[i] && assignment[i+numPairs]) funs[0][n] = 1;
+        }
+    }
+    std::vector<Func> funcs(1, Func(forest));
+    Edge e = buildEdge(forest, numVals, funs[0], 0);
+    funcs[0].setEdge(e);
+    uint64_t before = forest->countNodes();
+    forest->sift();
+    uint64_t after = forest->countNodes();
+    std::cout << "Sifting pairs: " << before << " -> " << after << " nodes" << std::endl;
+    bool pass = (after * 4 < before) && checkFuncs(forest, funcs, funs, numVals);
+    delete forest;
+    return pass;
+}
+
+/* Reordering triggered by operations */
+bool runDynamicTest(PredefForest bdd, uint16_t numVals, int TESTS)
+{
+    ForestSetting setting(bdd, numVals);
+    setting.setReorderTime(5.0);
+    Forest* forest = new Forest(setting);
+    long long size = 0x01LL<<(numVals);
+    std::vector<Func> funcs;
+    std::vector<std::vector<bool> > funs;
+    for (int test=0; test<TESTS; test++) {
+        Func f1(forest), f2(forest);
+        std::vector<bool> fun1(size), fun2(size), funRes(size);
+        for (long long i=0; i<size; i++) {
+            fun1[i] = (random01() > 0.5f)? 1 : 0;
+            fun2[i] = (random01() > 0.3f)? 1 : 0;
+            funRes[i] = fun1[i] && fun2[i];
+        }
+        Edge e1 = buildEdge(forest, numVals, fun1, 0);
+        Edge e2 = buildEdge(forest, numVals, fun2, 0);
+        f1.setEdge(e1);
+        f2.setEdge(e2);
+        funcs.push_back(f1 & f2);
+        funs.push_back(funRes);
+    }
+    const Statistics& stats = forest->getStatistics();
+    std::cout << "Dynamic reorderings: " << stats.getNumReorders() << "; last: " << stats.getLastReorderBefore()
+              << " -> " << stats.getLastReorderAfter() << " nodes" << std::endl;
+    bool pass = (stats.getNumReorders() > 0) && checkFuncs(forest, funcs, funs, numVals);
+    delete forest;
+    return pass;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_reorder [num_val] [num_tests]
+    uint16_t numVals = (argc > 1) ? atoi(argv[1]) : 8;
+    int TESTS = (argc > 2) ? atoi(argv[2]) : 6;
+
+    for (int bdd=0; bdd<5; bdd++) {
+        // the nodes rewritten in place are rehashed by both unique tables
+        if (!runTests((PredefForest)bdd, numVals, TESTS, CHAINING)) return 1;
+        if (!runTests((PredefForest)bdd, numVals, TESTS, OPEN_ADDRESSING)) return 1;
+        if (!runSiftTest((PredefForest)bdd, 5)) {
+            std::cout << "Sifting test failed!" << std::endl;
+            return 1;
+        }
+    }
+    if (!runDynamicTest(PredefForest::REXBDD, 12, 8)) {
+        std::cout << "Dynamic reordering test failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
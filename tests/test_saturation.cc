@@ -0,0 +1,95 @@
+#include "test_util.h"
+
+bool runTests(PredefForest bdd, PredefForest bmxd, uint16_t numVals, int TESTS)
+{
+    ForestSetting setting(bdd, numVals);
+    Forest* forest = new Forest(setting);
+    ForestSetting relSetting(bmxd, numVals);
+    Forest* relForest = new Forest(relSetting);
+    std::cout << setting.getName() << " x " << relSetting.getName() << std::endl;
+    long size = 1L << numVals;
+
+    for (int test=0; test<TESTS; test++) {
+        // events that change the variables at or below their top levels, and keep the others
+        int numEvents = 1 + (int)(random01() * 2 * numVals);
+        std::vector<std::vector<bool> > rels(numEvents, std::vector<bool>(size * size, 0));
+        FuncArray forwards(relForest, numEvents);
+        for (int e=0; e<numEvents; e++) {
+            uint16_t top = 1 + (int)(random01() * numVals);
+            long below = 1L << top;
+            for (long from=0; from<size; from++) {
+                if (random01() > 0.3) continue;
+                long to = (from & ~(below-1)) | (long)(random01() * below);
+                rels[e][pairIndex(from, to, numVals)] = 1;
+            }
+            forwards.add(Func(relForest, buildRelation(relForest, numVals, rels[e], 0)));
+        }
+        std::vector<bool> init(size, 0);
+        init[(long)(random01() * size)] = 1;
+        if (test % 2) init[(long)(random01() * size)] = 1;
+        // explicit reachability
+        std::vector<bool> reached = init;
+        for (bool isChanged = 1; isChanged; ) {
+            isChanged = 0;
+            for (int e=0; e<numEvents; e++) {
+                for (long from=0; from<size; from++) {
+                    if (!reached[from]) continue;
+                    for (long to=0; to<size; to++) {
+                        if (rels[e][pairIndex(from, to, numVals)] && !reached[to]) {
+                            reached[to] = 1;
+                            isChanged = 1;
+                        }
+                    }
+                }
+            }
+        }
+        Func set(forest, buildEdge(forest, numVals, init, 0, size-1));
+        Func res = saturate(set, forwards);
+        if (!checkFunc(res, reached, numVals)) {
+            std::cout << "Test " << test << ": saturation failed!" << std::endl;
+            return 0;
+        }
+        // the same fixpoint by images
+        Func frontier(forest), all(forest);
+        all = set;
+        for (bool isChanged = 1; isChanged; ) {
+            isChanged = 0;
+            for (int e=0; e<numEvents; e++) {
+                apply(POST_IMAGE, all, forwards[e], frontier);
+                Func next = all | frontier;
+                if (next.getEdge() != all.getEdge()) {
+                    all = next;
+                    isChanged = 1;
+                }
+            }
+        }
+        if (all.getEdge() != res.getEdge()) {
+            std::cout << "Test " << test << ": saturation and images differ!" << std::endl;
+            return 0;
+        }
+    }
+    StatsSnapshot snap = forest->getStatsSnapshot();
+    if ((snap.numSaturations != (uint64_t)TESTS) || (snap.totalSatIterations == 0) || (snap.lastSatPeakNodes == 0)) {
+        std::cout << "Saturation statistics failed!" << std::endl;
+        return 0;
+    }
+    snap.dump(std::cout);
+    delete forest;
+    delete relForest;
+    return 1;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_saturation [num_val] [num_tests]
+    uint16_t numVals = (argc > 1) ? atoi(argv[1]) : 5;
+    int TESTS = (argc > 2) ? atoi(argv[2]) : 20;
+
+    for (int bdd=0; bdd<5; bdd++) {
+        for (int bmxd=5; bmxd<8; bmxd++) {
+            if (!runTests((PredefForest)bdd, (PredefForest)bmxd, numVals, TESTS)) return 1;
+        }
+    }
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include "test_util.h"
+
+/* Check a Func of a snapshot against its truth table */
+bool checkSnapshot(const Snapshot& snapshot, int i, std::vector<bool>& fun, uint16_t numVals)
+{
+    long long size = 0x01LL<<(numVals);
+    std::vector<bool> assignment(numVals+1, 0);
+    for (long long n=0; n<size; n++) {
+        decimalToAssignment(n, assignment);
+        int valInt;
+        snapshot.evaluate(i, assignment).getValueTo(&valInt, INT);
+        if (fun[n] != (bool)valInt) return 0;
+    }
+    return 1;
+}
+
+/* Check the counts of the assignments of a Func of a snapshot against its truth table */
+bool checkCount(const Snapshot& snapshot, int i, std::vector<bool>& fun)
+{
+    uint64_t numOnes = 0;
+    for (size_t n=0; n<fun.size(); n++) numOnes += fun[n];
+    return (snapshot.count(i, 1) == numOnes) && (snapshot.count(i, 0) == fun.size() - numOnes);
+}
+
+bool runTests(PredefForest bdd, uint16_t numVals, int TESTS, bool isReordered)
+{
+    ForestSetting setting(bdd, numVals);
+    Forest* forest = new Forest(setting);
+    forest->getSetting().output(std::cout);
+    long long size = 0x01LL<<(numVals);
+
+    FuncArray funcs(forest, TESTS);
+    std::vector<std::vector<bool> > funs(TESTS, std::vector<bool>(size));
+    for (int test=0; test<TESTS; test++) {
+        for (long long i=0; i<size; i++) {
+            funs[test][i] = (random01() > 0.5f)? 1 : 0;
+        }
+        // a few constants too, whose edges go straight to terminals
+        if (test == 1) funs[test].assign(size, 0);
+        if (test == 2) funs[test].assign(size, 1);
+        Func f(forest, buildEdge(forest, numVals, funs[test], 0, size-1));
+        f.setName("f" + std::to_string(test));
+        funcs.add(f);
+    }
+    if (isReordered) {
+        forest->shiftUp(1);
+        forest->shiftDown(numVals-1);
+    }
+    std::string path = "test_snapshot_" + std::to_string((int)bdd) + ".rxbs";
+    Snapshot::write(path, forest, funcs);
+    std::vector<uint64_t> numNodes(TESTS);
+    uint64_t numAll = forest->countNodes(funcs);
+    for (int test=0; test<TESTS; test++) {
+        numNodes[test] = 0;
+        for (uint16_t lvl=1; lvl<=numVals; lvl++) numNodes[test] += forest->countNodesAtLevel(lvl, funcs[test]);
+    }
+    // the snapshot does not need the forest
+    delete forest;
+
+    Snapshot snapshot(path);
+    bool pass = (snapshot.getNumFuncs() == TESTS) && (snapshot.getNumVars() == numVals)
+                && (snapshot.getNumNodes() == numAll) && (snapshot.countNodes() == numAll)
+                && (snapshot.findFunc("nothing") == -1);
+    for (int test=0; pass && (test<TESTS); test++) {
+        std::string name = "f" + std::to_string(test);
+        pass = (snapshot.getName(test) == name) && (snapshot.findFunc(name) == test)
+                && (snapshot.countNodes(test) == numNodes[test])
+                && checkSnapshot(snapshot, test, funs[test], numVals)
+                && checkCount(snapshot, test, funs[test]);
+        if (!pass) std::cout << "Test " << test << ": snapshot Func differs!" << std::endl;
+    }
+    std::cout << "Snapshot of " << snapshot.getNumNodes() << " nodes" << std::endl;
+    remove(path.c_str());
+    return pass;
+}
+
+int main(int argc, char** argv){
+    // usage: ./test_snapshot [num_val] [num_tests]
+    uint16_t numVals = (argc > 1) ? atoi(argv[1]) : 8;
+    int TESTS = (argc > 2) ? atoi(argv[2]) : 20;
+
+    for (int bdd=0; bdd<5; bdd++) {
+        if (!runTests((PredefForest)bdd, numVals, TESTS, 0)) return 1;
+        if (!runTests((PredefForest)bdd, numVals, TESTS, 1)) return 1;
+    }
+
+    std::cout << "Test Pass!" << std::endl;
+    return 0;
+}
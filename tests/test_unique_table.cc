@@ -29,13 +29,13 @@ void fill_node(Node& node, bool isMxd)
     node.setEdgeComp(1,distrBool(gen), isMxd);
 }
 
-int main()
+bool insert_nodes(HashingType type)
 {
-    std::cout<< "Unique table test." << std::endl;
-
     ForestSetting setting("RexBDD", MAX_LVL);
+    setting.setHashingType(type);
     Forest* forest = new Forest(setting);
     Node node(forest->getSetting());
+    std::cout<<"Hashing: \t\t" << hashingType2String(type) << std::endl;
 
     unsigned count = 0, maxHandle = 0;
     for (unsigned i=0; i<TESTS; i++) {
@@ -49,7 +49,8 @@ int main()
         }
         if (forest->getUTEntriesNum(10) + count != i+1) {
             std::cout << "[REXBDD] Test Error! Some nodes are missing!" << std::endl;
-            return 1;
+            delete forest;
+            return 0;
         }
     }
     std::cout<<"UT entries number: \t" << forest->getUTEntriesNum(10) 
@@ -58,9 +59,18 @@ int main()
 
     // TBD
 
+    delete forest;
+    return 1;
+}
+
+int main()
+{
+    std::cout<< "Unique table test." << std::endl;
+
+    if (!insert_nodes(CHAINING)) return 1;
+    if (!insert_nodes(OPEN_ADDRESSING)) return 1;
     
     // std::cout<<"UT entries: "<<node.edgeRule(0)<<std::endl;
     std::cout << "test passed!" << std::endl;
-    delete forest;
     return 0;
 }
\ No newline at end of file
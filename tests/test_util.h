@@ -0,0 +1,119 @@
+#ifndef REXBDD_TEST_UTIL_H
+#define REXBDD_TEST_UTIL_H
+
+#include "RexBDD.h"
+
+#include "cstdlib"
+#include "cstdio"
+
+/*
+ * Fixtures shared by the tests and the examples: random boolean functions given
+ * by their truth tables, and the edges built from them. The truth table "fun" is
+ * indexed by the assignments, variable k being bit k-1 of the index.
+ */
+
+using namespace REXBDD;
+
+static long seed = 123456789;
+
+/* Random function generating value between 0 and 1 */
+inline double random01()
+{
+  const long MODULUS = 2147483647L;
+  const long MULTIPLIER = 48271L;
+  const long Q = MODULUS / MULTIPLIER;
+  const long R = MODULUS % MULTIPLIER;
+
+  long t = MULTIPLIER * (seed % Q) - R * (seed / Q);
+  if (t > 0) {
+    seed = t;
+  } else {
+    seed = t + MODULUS;
+  }
+  return ((double) seed / MODULUS);
+}
+
+inline void decimalToAssignment(long long decimal, std::vector<bool>& assignment)
+{
+    for (size_t k=1; k<=assignment.size()-1; k++) {
+        assignment[k] = (decimal >> (k-1)) & 1;
+    }
+}
+
+/* Terminal edge of the boolean value, in the value type of the forest */
+inline Edge terminalEdge(Forest* forest, bool value)
+{
+    Edge ans;
+    ans.setEdgeHandle(makeTerminal(INT, value?1:0));
+    if (forest->getSetting().getValType() == FLOAT) {
+        ans.setEdgeHandle(makeTerminal(FLOAT, value?1.0f:0.0f));
+    }
+    ans.setRule(RULE_X);
+    return ans;
+}
+
+/* Edge of the part [start, end] of the truth table "fun", on the variables up to "lvl" */
+inline Edge buildEdge(Forest* forest,
+                uint16_t lvl,
+                std::vector<bool>& fun,
+                long long start, long long end)
+{
+    std::vector<Edge> child(2);
+    EdgeLabel label = 0;
+    packRule(label, RULE_X);
+    if (lvl == 1) {
+        child[0] = terminalEdge(forest, fun[start]);
+        child[1] = terminalEdge(forest, fun[end]);
+        return forest->reduceEdge(lvl, label, lvl, child);
+    }
+    child[0] = buildEdge(forest, lvl-1, fun, start, start+(1LL<<(lvl-1))-1);
+    child[1] = buildEdge(forest, lvl-1, fun, start+(1LL<<(lvl-1)), end);
+    return forest->reduceEdge(lvl, label, lvl, child);
+}
+
+/* Relation "rel" is indexed by the pairs (x, x') of all levels: 2 bits per level, x the higher one */
+inline Edge buildRelation(Forest* forest,
+                uint16_t lvl,
+                std::vector<bool>& rel,
+                long start)
+{
+    std::vector<Edge> child(4);
+    EdgeLabel label = 0;
+    packRule(label, RULE_X);
+    for (int c=0; c<4; c++) {
+        long first = start + c * (1L << (2*(lvl-1)));
+        if (lvl == 1) {
+            child[c] = terminalEdge(forest, rel[first]);
+        } else {
+            child[c] = buildRelation(forest, lvl-1, rel, first);
+        }
+    }
+    return forest->reduceEdge(lvl, label, lvl, child);
+}
+
+/* Index in a relation of the pair of states (from, to) */
+inline long pairIndex(long from, long to, uint16_t numVals)
+{
+    long index = 0;
+    for (uint16_t k=0; k<numVals; k++) {
+        index |= (((from >> k) & 1) << (2*k+1)) | (((to >> k) & 1) << (2*k));
+    }
+    return index;
+}
+
+/* Check if the function encoded by "func" is the truth table "fun" */
+inline bool checkFunc(const Func& func, std::vector<bool>& fun, uint16_t numVals)
+{
+    long long size = 0x01LL<<(numVals);
+    std::vector<bool> assignment(numVals+1, 0);
+    for (long long n=0; n<size; n++) {
+        decimalToAssignment(n, assignment);
+        Value val = func.evaluate(assignment);
+        int valInt;
+        val.getValueTo(&valInt, INT);
+        if (fun[n] != (bool)valInt) return 0;
+    }
+    return 1;
+}
+
+#endif